@@ -0,0 +1,39 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+// Allocation counter linked only into the benchmark build of the simulator
+// (bin/tmsim_bench). malloc, calloc and realloc calls are redirected here by
+// the linker with -Wl,--wrap, so the simulator sources are left untouched.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+static uint64_t allocations = 0;
+
+void* __wrap_malloc(size_t size) {
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+/// @brief Prints the benchmark counters of a run to stderr, parsed by tmbench
+/// @param steps Total simulated steps
+void benchReport(uint64_t steps) {
+    fprintf(stderr, "BENCH steps=%llu allocations=%llu\n", (unsigned long long)steps, (unsigned long long)allocations);
+}
@@ -0,0 +1,399 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+// Benchmark harness for the simulator (make bench)
+// Generates parameterized workloads as script files, runs the benchmark build
+// of the simulator (bin/tmsim_bench) for each engine and thread count, and
+// reports steps per second, wall time, peak RSS and allocations as JSON.
+// POSIX only: it relies on fork, exec and wait4.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define MAX_PATH_LENGTH     512
+#define MAX_THREAD_COUNTS   16
+#define MAX_RESULTS         256
+
+/// @brief Generated Workload
+typedef struct {
+    /// @brief Workload name (unique in a run, used to match baselines)
+    char name[64];
+    /// @brief Script File Path
+    char script[MAX_PATH_LENGTH];
+    /// @brief Number of tapes in the script
+    uint32_t batch;
+    /// @brief 1 if the workload can also run with the NDTM engine (single tape scripts)
+    uint8_t ndtm;
+    /// @brief 1 if the workload can only run with the NDTM engine
+    uint8_t ndtm_only;
+} Workload_t;
+
+/// @brief Single benchmark measurement
+typedef struct {
+    char name[64];
+    const char* engine;
+    uint32_t threads;
+    uint32_t batch;
+    uint64_t steps;
+    uint64_t allocations;
+    double wall_seconds;
+    long peak_rss_kb;
+    double baseline_steps_per_sec;
+} Result_t;
+
+static Workload_t workloads[32];
+static uint32_t workloads_size = 0;
+
+/// @brief Creates a new workload script and registers it
+/// @return FILE* opened for writing, the caller closes it
+static FILE* newWorkload(const char* work_dir, const char* name, uint32_t batch, uint8_t ndtm) {
+    Workload_t* w = &workloads[workloads_size++];
+    snprintf(w->name, sizeof(w->name), "%s", name);
+    snprintf(w->script, sizeof(w->script), "%s/%s.txt", work_dir, name);
+    w->batch = batch;
+    w->ndtm = ndtm && batch == 1;
+    w->ndtm_only = 0;
+    FILE* file = fopen(w->script, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error creating workload %s\n", w->script);
+        exit(1);
+    }
+    fprintf(file, "// generated by tmbench\n");
+    return file;
+}
+
+/// @brief Writes the same tape and head definition batch times
+static void writeTapes(FILE* file, const char* tape, uint32_t head, uint32_t batch) {
+    for (uint32_t i = 0; i < batch; i++) fprintf(file, "tape=%s\nhead=%u\n", tape, head);
+}
+
+/// @brief Binary counter: increments a bits wide counter until it overflows (about 4*2^bits steps)
+static void genBinaryCounter(const char* work_dir, uint32_t bits, uint32_t batch) {
+    char name[64], tape[256];
+    snprintf(name, sizeof(name), "binary_counter_%ubit_x%u", bits, batch);
+    FILE* file = newWorkload(work_dir, name, batch, 1);
+    tape[0] = '$';
+    memset(&tape[1], '0', bits);
+    tape[bits+1] = '#';
+    tape[bits+2] = 0;
+    writeTapes(file, tape, bits, batch);
+    fprintf(file, "initial_state=q0\naccept_states=qf\n");
+    fprintf(file, "q0,1,0,<,q0\nq0,0,1,>,r\nq0,$,$,-,qf\n");
+    fprintf(file, "r,0,0,>,r\nr,1,1,>,r\nr,#,#,<,q0\n");
+    fclose(file);
+}
+
+/// @brief Unary adder: 1^a+1^b becomes 1^(a+b)
+static void genUnaryAdder(const char* work_dir, uint32_t a, uint32_t b, uint32_t batch) {
+    char name[64], tape[256];
+    snprintf(name, sizeof(name), "unary_adder_%u+%u_x%u", a, b, batch);
+    FILE* file = newWorkload(work_dir, name, batch, 1);
+    memset(tape, '1', a);
+    tape[a] = '+';
+    memset(&tape[a+1], '1', b);
+    tape[a+b+1] = 0;
+    writeTapes(file, tape, 0, batch);
+    fprintf(file, "initial_state=q0\naccept_states=qf\n");
+    fprintf(file, "q0,1,1,>,q0\nq0,+,1,>,q1\n");
+    fprintf(file, "q1,1,1,>,q1\nq1,,,<,q2\n");
+    fprintf(file, "q2,1,,-,qf\n");
+    fclose(file);
+}
+
+/// @brief Palindrome checker over {a,b}, quadratic in the input length
+static void genPalindrome(const char* work_dir, uint32_t length, uint32_t batch) {
+    char name[64], tape[256];
+    snprintf(name, sizeof(name), "palindrome_%u_x%u", length, batch);
+    FILE* file = newWorkload(work_dir, name, batch, 1);
+    for (uint32_t i = 0; i < (length+1)/2; i++) tape[i] = tape[length-1-i] = ((i*7)%3) ? 'a' : 'b';
+    tape[length] = 0;
+    writeTapes(file, tape, 0, batch);
+    fprintf(file, "initial_state=q0\naccept_states=qf\n");
+    fprintf(file, "q0,a,,>,qa\nq0,b,,>,qb\nq0,,,-,qf\n");
+    fprintf(file, "qa,a,a,>,qa\nqa,b,b,>,qa\nqa,,,<,qa2\n");
+    fprintf(file, "qb,a,a,>,qb\nqb,b,b,>,qb\nqb,,,<,qb2\n");
+    fprintf(file, "qa2,a,,<,q3\nqa2,,,-,qf\n");
+    fprintf(file, "qb2,b,,<,q3\nqb2,,,-,qf\n");
+    fprintf(file, "q3,a,a,<,q3\nq3,b,b,<,q3\nq3,,,>,q0\n");
+    fclose(file);
+}
+
+/// @brief 4-state 2-symbol busy beaver champion (107 steps), '0' and blank are both the zero symbol
+static void genBusyBeaver(const char* work_dir, uint32_t batch) {
+    char name[64];
+    snprintf(name, sizeof(name), "busy_beaver_4_x%u", batch);
+    FILE* file = newWorkload(work_dir, name, batch, 1);
+    writeTapes(file, "0", 0, batch);
+    fprintf(file, "initial_state=A\naccept_states=H\n");
+    const char* rules[] = {
+        "A,%s,1,>,B\n", "A,1,1,<,B\n",
+        "B,%s,1,<,A\n", "B,1,0,<,C\n",
+        "C,%s,1,>,H\n", "C,1,1,<,D\n",
+        "D,%s,1,>,D\n", "D,1,0,>,A\n"
+    };
+    for (uint8_t i = 0; i < 8; i++) {
+        fprintf(file, rules[i], "0");
+        if (strstr(rules[i], "%s")) fprintf(file, rules[i], "");
+    }
+    fclose(file);
+}
+
+/// @brief Wide NDTM branching: every '0' can be rewritten as '0' or '1' and only the all ones
+/// branch accepts, so the whole tree of 2^width branches is explored
+static void genNDTMBranching(const char* work_dir, uint32_t width) {
+    char name[64], tape[256];
+    snprintf(name, sizeof(name), "ndtm_branching_%u", width);
+    FILE* file = newWorkload(work_dir, name, 1, 1);
+    workloads[workloads_size-1].ndtm_only = 1;
+    tape[0] = '#';
+    memset(&tape[1], '0', width);
+    tape[width+1] = '$';
+    tape[width+2] = 0;
+    writeTapes(file, tape, 1, 1);
+    fprintf(file, "initial_state=q0\naccept_states=qf\n");
+    fprintf(file, "q0,0,0,>,q0\nq0,0,1,>,q0\nq0,$,$,<,q1\n");
+    fprintf(file, "q1,1,1,<,q1\nq1,#,#,-,qf\n");
+    fclose(file);
+}
+
+/// @brief Runs the simulator once and fills a measurement
+/// @return 1 on success
+static uint8_t runOnce(const char* tmsim, Workload_t* w, const char* engine, uint32_t threads, Result_t* r) {
+    int pipe_fd[2];
+    char threads_arg[16];
+    if (pipe(pipe_fd) != 0) return 0;
+    snprintf(threads_arg, sizeof(threads_arg), "%u", threads);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid_t pid = fork();
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(pipe_fd[1], STDERR_FILENO);
+        close(pipe_fd[0]);
+#ifdef OPENMP
+        execl(tmsim, tmsim, "-r", w->script, engine, "-j", threads_arg, (char*)NULL);
+#else
+        execl(tmsim, tmsim, "-r", w->script, engine, (char*)NULL);
+#endif
+        _exit(127);
+    }
+    close(pipe_fd[1]);
+    char buffer[4096];
+    size_t length = 0;
+    ssize_t n;
+    while ((n = read(pipe_fd[0], buffer+length, sizeof(buffer)-1-length)) > 0) {
+        length += n;
+        if (length == sizeof(buffer)-1) length = 0;
+    }
+    buffer[length] = 0;
+    close(pipe_fd[0]);
+    int status;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    char* report = strstr(buffer, "BENCH ");
+    unsigned long long steps, allocations;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || report == NULL ||
+        sscanf(report, "BENCH steps=%llu allocations=%llu", &steps, &allocations) != 2) {
+        fprintf(stderr, "%s %s failed (is %s a benchmark build?)\n", w->name, engine, tmsim);
+        return 0;
+    }
+    snprintf(r->name, sizeof(r->name), "%s", w->name);
+    r->engine = engine[1] == 'N' ? "NDTM" : "DTM";
+    r->threads = threads;
+    r->batch = w->batch;
+    r->steps = steps;
+    r->allocations = allocations;
+    r->wall_seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec)*1e-9;
+    r->peak_rss_kb = usage.ru_maxrss;
+    r->baseline_steps_per_sec = 0;
+    return 1;
+}
+
+/// @brief Finds the value of a numeric key in a single JSON line
+static uint8_t jsonNumber(const char* line, const char* key, double* value) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char* position = strstr(line, pattern);
+    if (position == NULL) return 0;
+    *value = strtod(position+strlen(pattern), NULL);
+    return 1;
+}
+
+/// @brief Finds the value of a string key in a single JSON line
+static uint8_t jsonString(const char* line, const char* key, char* value, size_t size) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+    const char* position = strstr(line, pattern);
+    if (position == NULL) return 0;
+    position += strlen(pattern);
+    size_t i = 0;
+    while (position[i] != '"' && position[i] != 0 && i+1 < size) {value[i] = position[i]; i++;}
+    value[i] = 0;
+    return 1;
+}
+
+/// @brief Reads a baseline written by a previous run (one result per line) and matches it
+/// against the current results by workload name, engine and threads
+static void loadBaseline(const char* filename, Result_t* results, uint32_t results_size) {
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Baseline %s not found, skipping comparison\n", filename);
+        return;
+    }
+    char line[1024], name[64], engine[8];
+    double threads, steps_per_sec;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (!jsonString(line, "name", name, sizeof(name)) || !jsonString(line, "engine", engine, sizeof(engine))) continue;
+        if (!jsonNumber(line, "threads", &threads) || !jsonNumber(line, "steps_per_sec", &steps_per_sec)) continue;
+        for (uint32_t i = 0; i < results_size; i++) {
+            if (!strcmp(results[i].name, name) && !strcmp(results[i].engine, engine) && results[i].threads == (uint32_t)threads)
+                results[i].baseline_steps_per_sec = steps_per_sec;
+        }
+    }
+    fclose(file);
+}
+
+/// @brief Writes the results as JSON, one result object per line
+static void writeResults(FILE* file, const char* tmsim, Result_t* results, uint32_t results_size) {
+    fprintf(file, "{\n  \"tmsim\": \"%s\",\n", tmsim);
+#ifdef OPENMP
+    fprintf(file, "  \"openmp\": true,\n");
+#else
+    fprintf(file, "  \"openmp\": false,\n");
+#endif
+    fprintf(file, "  \"results\": [\n");
+    for (uint32_t i = 0; i < results_size; i++) {
+        Result_t* r = &results[i];
+        double steps_per_sec = r->wall_seconds > 0 ? r->steps / r->wall_seconds : 0;
+        fprintf(file, "    {\"name\": \"%s\", \"engine\": \"%s\", \"threads\": %u, \"batch\": %u, \"steps\": %llu, "
+                      "\"wall_seconds\": %.6f, \"steps_per_sec\": %.1f, \"peak_rss_kb\": %ld, \"allocations\": %llu",
+                r->name, r->engine, r->threads, r->batch, (unsigned long long)r->steps,
+                r->wall_seconds, steps_per_sec, r->peak_rss_kb, (unsigned long long)r->allocations);
+        if (r->baseline_steps_per_sec > 0)
+            fprintf(file, ", \"baseline_steps_per_sec\": %.1f, \"speedup\": %.3f", r->baseline_steps_per_sec, steps_per_sec / r->baseline_steps_per_sec);
+        fprintf(file, "}%s\n", i+1 < results_size ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+/// @brief Prints a human readable comparison against the baseline
+static void printComparison(Result_t* results, uint32_t results_size) {
+    printf("\n%-36s %-5s %7s %14s %14s %8s\n", "workload", "mode", "threads", "steps/s", "baseline", "change");
+    for (uint32_t i = 0; i < results_size; i++) {
+        Result_t* r = &results[i];
+        double steps_per_sec = r->wall_seconds > 0 ? r->steps / r->wall_seconds : 0;
+        if (r->baseline_steps_per_sec > 0)
+            printf("%-36s %-5s %7u %14.0f %14.0f %+7.1f%%\n", r->name, r->engine, r->threads, steps_per_sec,
+                   r->baseline_steps_per_sec, 100.0*(steps_per_sec / r->baseline_steps_per_sec - 1.0));
+        else
+            printf("%-36s %-5s %7u %14.0f %14s %8s\n", r->name, r->engine, r->threads, steps_per_sec, "-", "-");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* tmsim = "bin/tmsim_bench";
+    const char* output = NULL;
+    const char* baseline = NULL;
+    const char* work_dir = "bench/work";
+    const char* scale = "small";
+    uint32_t repeat = 3, thread_counts[MAX_THREAD_COUNTS], thread_counts_size = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--tmsim") && i+1 < argc) tmsim = argv[++i];
+        else if (!strcmp(argv[i], "--output") && i+1 < argc) output = argv[++i];
+        else if (!strcmp(argv[i], "--baseline") && i+1 < argc) baseline = argv[++i];
+        else if (!strcmp(argv[i], "--work_dir") && i+1 < argc) work_dir = argv[++i];
+        else if (!strcmp(argv[i], "--scale") && i+1 < argc) scale = argv[++i];
+        else if (!strcmp(argv[i], "--repeat") && i+1 < argc) repeat = strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--threads") && i+1 < argc) {
+            char* list = argv[++i];
+            while (*list && thread_counts_size < MAX_THREAD_COUNTS) {
+                thread_counts[thread_counts_size++] = strtoul(list, &list, 10);
+                if (*list == ',') list++;
+            }
+        } else {
+            printf("Usage: tmbench [--tmsim <path>] [--output <json>] [--baseline <json>] [--scale small|medium|large]\n");
+            printf("               [--threads 1,2,4] [--repeat <n>] [--work_dir <dir>]\n");
+            return strcmp(argv[i], "--help") ? 1 : 0;
+        }
+    }
+    if (repeat == 0) repeat = 1;
+    if (thread_counts_size == 0) {
+#ifdef OPENMP
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        for (uint32_t threads = 1; threads < (uint32_t)cores && thread_counts_size < MAX_THREAD_COUNTS-1; threads *= 2) thread_counts[thread_counts_size++] = threads;
+        thread_counts[thread_counts_size++] = cores > 0 ? cores : 1;
+#else
+        thread_counts[thread_counts_size++] = 1;
+#endif
+    }
+
+    // batches of 10^3 (small), 10^4 (medium) up to 10^6 (large) tapes
+    uint32_t batch = 1000, counter_bits = 20, ndtm_width = 12;
+    if (!strcmp(scale, "medium")) {batch = 10000; counter_bits = 24; ndtm_width = 14;}
+    if (!strcmp(scale, "large"))  {batch = 1000000; counter_bits = 26; ndtm_width = 16;}
+
+    mkdir(work_dir, 0755);
+    genBinaryCounter(work_dir, counter_bits, 1);
+    genBinaryCounter(work_dir, 8, batch);
+    genUnaryAdder(work_dir, 100, 100, 1);
+    genUnaryAdder(work_dir, 20, 20, batch);
+    genPalindrome(work_dir, 201, 1);
+    genPalindrome(work_dir, 41, batch);
+    genBusyBeaver(work_dir, 1);
+    genBusyBeaver(work_dir, batch);
+    genNDTMBranching(work_dir, ndtm_width);
+
+    Result_t results[MAX_RESULTS];
+    uint32_t results_size = 0;
+    for (uint32_t i = 0; i < workloads_size; i++) {
+        Workload_t* w = &workloads[i];
+        const char* engines[2];
+        uint8_t engines_size = 0;
+        if (!w->ndtm_only) engines[engines_size++] = "-DTM";
+        if (w->ndtm) engines[engines_size++] = "-NDTM";
+        for (uint8_t e = 0; e < engines_size; e++) {
+            // the NDTM engine is single threaded
+            uint32_t thread_runs = strcmp(engines[e], "-NDTM") ? thread_counts_size : 1;
+            for (uint32_t j = 0; j < thread_runs && results_size < MAX_RESULTS; j++) {
+                Result_t best, r;
+                uint8_t valid = 0;
+                // best wall time of all repetitions
+                for (uint32_t k = 0; k < repeat; k++) {
+                    if (!runOnce(tmsim, w, engines[e], thread_counts[j], &r)) break;
+                    if (!valid || r.wall_seconds < best.wall_seconds) best = r;
+                    valid = 1;
+                }
+                if (!valid) continue;
+                results[results_size++] = best;
+                fprintf(stderr, "%-36s %-5s %3u threads %10.4fs\n", best.name, best.engine, best.threads, best.wall_seconds);
+            }
+        }
+    }
+
+    if (baseline != NULL) loadBaseline(baseline, results, results_size);
+    if (output != NULL) {
+        FILE* file = fopen(output, "w");
+        if (file == NULL) {
+            fprintf(stderr, "Error creating %s\n", output);
+            return 1;
+        }
+        writeResults(file, tmsim, results, results_size);
+        fclose(file);
+    } else writeResults(stdout, tmsim, results, results_size);
+    if (baseline != NULL) printComparison(results, results_size);
+    return 0;
+}
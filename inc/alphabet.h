@@ -0,0 +1,42 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef ALPHABET_H
+#define ALPHABET_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// longest symbol name with its brackets, [name]
+#define ALPHABET_NAME_MAX   32
+
+/// @brief Tape symbols of a script beyond single ASCII characters
+/// UTF-8 characters and names declared with symbols= (written [name] in tapes and moves) are remapped
+/// at load time to free cell codes, so tapes keep one byte per cell and every engine runs unchanged.
+/// Codes are given from 128 to 255 first, which are never single byte symbols, then control characters
+typedef struct {
+    /// @brief Printed text of every cell code, NULL for single byte symbols printed as themselves
+    uint8_t* names[256];
+    /// @brief 1 for codes used as single byte symbols
+    uint8_t literal[256];
+    /// @brief Number of named codes
+    uint16_t size;
+    /// @brief 1 once a name is declared, [ is a single byte symbol elsewhere
+    uint8_t declared;
+} Alphabet_t;
+
+Alphabet_t* alphabetCreate();
+void alphabetFree(Alphabet_t* a);
+int16_t alphabetDeclare(Alphabet_t* a, const uint8_t* name, uint8_t length);
+int16_t alphabetSymbol(Alphabet_t* a, const uint8_t* text, uint8_t* length);
+int16_t alphabetEncode(Alphabet_t* a, const uint8_t* text, uint8_t* cells);
+uint8_t alphabetCollision(Alphabet_t* a);
+void alphabetDisplay(Alphabet_t* a);
+uint8_t alphabetNamed(uint8_t cell);
+const uint8_t* alphabetName(uint8_t cell);
+uint8_t alphabetWidth(uint8_t cell);
+void alphabetPut(FILE* file, uint8_t cell);
+
+#endif
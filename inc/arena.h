@@ -0,0 +1,50 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdint.h>
+#include <rules.h>
+
+// blank cells available on each side of a tape loaded in an arena, enough for
+// any growth of a tape whose length fits in uint8_t
+#define ARENA_MARGIN    256
+#define ARENA_CELLS     (3*ARENA_MARGIN)
+// bytes of each slab chunk holding the final tapes of a worker
+#define ARENA_SLAB      65536
+
+/// @brief Chunk of a slab of final tapes, chunks of a worker are linked to be released together
+typedef struct ArenaSlab {
+    struct ArenaSlab* next;
+    /// @brief Bytes used in cells
+    uint32_t used;
+    uint8_t cells[ARENA_SLAB];
+} ArenaSlab_t;
+
+/// @brief Tape memory of a single worker thread
+/// Each worker allocates its own buffer when it runs its first machine and reuses it for
+/// every following machine, so tapes never grow with realloc and workers never share
+/// allocator state while running. The running tape is a window of the buffer: growing to
+/// the left only moves the window start, instead of shifting the whole tape.
+/// Machines start from their script tape, copied straight into the buffer, and their final
+/// tapes are kept in a slab of the worker, so a machine never allocates or frees a tape
+typedef struct {
+    /// @brief Buffer of ARENA_CELLS cells, NULL until the worker runs its first machine
+    uint8_t* cells;
+    /// @brief Slab chunk with the last final tapes, NULL until the worker finishes its first machine
+    ArenaSlab_t* slab;
+    /// @brief 1 to pin the worker to a CPU when the buffer is allocated
+    uint8_t pin;
+} TapeArena_t;
+
+TapeArena_t* arenaCreate(uint32_t threads, uint8_t pin);
+TapeArena_t* arenaThread(TapeArena_t* arenas);
+void arenaFree(TapeArena_t* arenas, uint32_t threads);
+void arenaBegin(TapeArena_t* arena, TM_t* t, uint8_t tmlen);
+void arenaEnd(TapeArena_t* arena, TM_t* t, uint8_t tmlen);
+uint8_t arenaStepTM(TM_t* t, uint8_t* tmlen, Move_t** last_move);
+
+#endif
@@ -0,0 +1,75 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef BEAVER_H
+#define BEAVER_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define BEAVER_STATES_MAX       8
+#define BEAVER_SYMBOLS_MAX      4
+// tape window of an enumerated machine, machines leaving it are undecided
+#define BEAVER_CELLS            (1<<16)
+#define BEAVER_STEPS_DEFAULT    1000000
+// machines with this many transitions are split between threads and shards
+#define BEAVER_SPLIT            4
+// undecided machines listed in the console without --undecided
+#define BEAVER_LIST_MAX         16
+// transition of an undefined (halting) table entry
+#define BEAVER_UNDEFINED        (uint8_t) 0xFF
+// compact name: "1RB" per transition and "_" between states
+#define BEAVER_NAME_SIZE        (BEAVER_STATES_MAX*(3*BEAVER_SYMBOLS_MAX+1))
+
+/// @brief Transition of an enumerated machine, next is BEAVER_UNDEFINED for a halting entry
+typedef struct {
+    uint8_t write;
+    uint8_t move;
+    uint8_t next;
+} BeaverMove_t;
+
+/// @brief Enumerated machine in tree normal form: states are numbered in the order they are
+/// first reached, so isomorphic machines (renamed states) are generated once
+typedef struct {
+    BeaverMove_t table[BEAVER_STATES_MAX][BEAVER_SYMBOLS_MAX];
+    /// @brief Defined transitions
+    uint8_t defined;
+    /// @brief States reached, the next new state is used
+    uint8_t used;
+    /// @brief State and symbol of the halting transition
+    uint8_t halt_state;
+    uint8_t halt_symbol;
+} BeaverMachine_t;
+
+/// @brief Result of a busy beaver search
+typedef struct {
+    uint8_t states;
+    uint8_t symbols;
+    uint64_t max_steps;
+    /// @brief Machines split between threads and shards, and the ones run by this shard
+    uint64_t frontier;
+    uint64_t frontier_run;
+    uint64_t enumerated;
+    uint64_t halting;
+    /// @brief Machines running forever (reading blanks forever in one direction or repeating a configuration)
+    uint64_t looping;
+    /// @brief Machines reaching the step bound or the end of the tape window
+    uint64_t undecided;
+    /// @brief Record holders, with their steps (halting transition included) and written non blank cells
+    uint64_t steps;
+    BeaverMachine_t steps_holder;
+    uint64_t ones;
+    BeaverMachine_t ones_holder;
+    /// @brief First undecided machines found
+    BeaverMachine_t listed[BEAVER_LIST_MAX];
+    uint32_t listed_size;
+} BeaverReport_t;
+
+BeaverReport_t beaverSearch(uint8_t states, uint8_t symbols, uint64_t max_steps, uint32_t shard, uint32_t shards, uint32_t threads, FILE* undecided);
+void beaverName(BeaverMachine_t* m, uint8_t states, uint8_t symbols, char* name);
+void beaverReportPrint(FILE* file, BeaverReport_t* report);
+int beaverMain(int argc, char *argv[]);
+
+#endif
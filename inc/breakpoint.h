@@ -0,0 +1,30 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef BREAKPOINT_H
+#define BREAKPOINT_H
+
+#include <stdint.h>
+#include <rules.h>
+
+#define BREAKPOINT_REASON_SIZE  128
+
+/// @brief Breakpoints and watchpoints shared by every DTM of a script
+typedef struct {
+    /// @brief 1 for every state index with a breakpoint, the machine stops when it enters the state
+    uint8_t* states;
+    /// @brief Watched cells, counted from the first cell of the script tape (negative on the left)
+    int32_t* cells;
+    uint32_t cells_size;
+    /// @brief Step count that stops every machine, 0 for none
+    uint64_t step;
+} Breakpoints_t;
+
+Breakpoints_t* breakpointsCreate(TM_t* t, char** states, uint32_t states_size, int32_t* cells, uint32_t cells_size, uint64_t step);
+void breakpointsFree(Breakpoints_t* b);
+uint8_t breakpointHit(Breakpoints_t* b, TM_t* t, Move_t* m, int32_t cell, char* reason);
+void breakpointInspect(TM_t* t, uint32_t tm_num, const char* reason);
+
+#endif
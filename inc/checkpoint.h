@@ -0,0 +1,73 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <rules.h>
+
+#define CHECKPOINT_MAGIC            "TMCK"
+#define CHECKPOINT_VERSION          (uint8_t) 1
+#define CHECKPOINT_STEPS_DEFAULT    (uint64_t) 1000000
+
+#define CHECKPOINT_MODE_DTM         (uint8_t) 0
+#define CHECKPOINT_MODE_NDTM        (uint8_t) 1
+
+/// @brief Snapshot of a single Turing Machine (or a single NDTM branch)
+typedef struct {
+    /// @brief Tape String copy
+    uint8_t* tape;
+    /// @brief Tape Head Position
+    uint8_t head;
+    /// @brief Current State index in TM_t states array
+    uint32_t state;
+    /// @brief Number of simulated steps
+    uint64_t steps;
+    /// @brief Simulation status (runStepTM codes, 0 while running)
+    uint8_t status;
+} MachineSnapshot_t;
+
+/// @brief Checkpoint of a whole run
+///
+/// File layout (all integers little endian):
+/// "TMCK", version (u8), mode (u8), automaton hash (u64), frontier index (u32),
+/// total steps (u64), machines count (u32), then status (u8), state (u32),
+/// head (u32), steps (u64), tape length (u32) and tape for each machine
+typedef struct {
+    /// @brief Checkpoint File Path in Disk
+    const char* filename;
+    /// @brief Hash of the automaton, checked on resume
+    uint64_t automata_hash;
+    /// @brief CHECKPOINT_MODE_DTM (batch of DTMs) or CHECKPOINT_MODE_NDTM (NDTM frontier)
+    uint8_t mode;
+    /// @brief Machines (DTM batch) or branches (NDTM frontier) snapshots
+    MachineSnapshot_t* machines;
+    uint32_t machines_size;
+    /// @brief NDTM frontier index of the next branch to be stepped
+    uint32_t frontier_index;
+    /// @brief NDTM total steps over all branches
+    uint64_t steps;
+    /// @brief Steps between two machine snapshots
+    uint64_t interval_steps;
+    /// @brief Minimum seconds between two checkpoint file writes (0 writes on every snapshot)
+    uint32_t interval_seconds;
+    /// @brief Time of the last checkpoint file write
+    time_t last_write;
+    /// @brief Steps taken by the snapshots since the last checkpoint file write
+    uint64_t pending_steps;
+} Checkpoint_t;
+
+uint64_t automataHash(TM_t* t);
+Checkpoint_t* checkpointCreate(const char* filename, TM_t* t, uint32_t t_number, uint8_t mode, uint64_t interval_steps, uint32_t interval_seconds);
+void checkpointUpdate(Checkpoint_t* c, TM_t* t, uint32_t tm_num);
+void checkpointUpdateNDTM(Checkpoint_t* c, TM_t* t, uint32_t* flagStatus, State_t* current_state, uint32_t t_number, uint32_t frontier_index, uint64_t steps);
+void checkpointWrite(Checkpoint_t* c, uint8_t force);
+Checkpoint_t* checkpointLoad(const char* filename);
+void checkpointRestore(Checkpoint_t* c, TM_t* t, uint32_t t_number);
+
+#endif
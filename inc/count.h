@@ -0,0 +1,64 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef COUNT_H
+#define COUNT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+
+/// @brief Arbitrary precision unsigned integer, little endian 32 bit limbs
+typedef struct {
+    uint32_t* limbs;
+    /// @brief Number of limbs without leading zeros (zero for the number zero)
+    uint32_t size;
+    /// @brief Number of allocated limbs
+    uint32_t capacity;
+} BigCount_t;
+
+/// @brief NDTM Configuration: state, head and tape, with the number of computations reaching it
+/// Tapes are kept without blank cells at their ends (except under the head),
+/// so configurations that differ only by tape growth are the same configuration
+typedef struct {
+    uint32_t state;
+    uint32_t head;
+    uint32_t length;
+    uint8_t* cells;
+    uint64_t hash;
+    BigCount_t paths;
+} CountConfig_t;
+
+/// @brief Configurations of a single level (all computations with the same number of steps)
+typedef struct {
+    CountConfig_t* configs;
+    uint32_t size;
+    uint32_t capacity;
+    /// @brief Open addressing table of configuration indexes plus one (zero for empty slots)
+    uint32_t* table;
+    uint32_t table_size;
+} CountLevel_t;
+
+/// @brief Result of a path count
+typedef struct {
+    /// @brief Computations that reached an accept state within the step bound
+    BigCount_t accepted;
+    /// @brief Computations that stopped without a valid move within the step bound
+    BigCount_t stopped;
+    /// @brief Computations still running after the step bound
+    BigCount_t running;
+    /// @brief Deepest simulated level (steps of the longest computation)
+    uint64_t levels;
+    /// @brief Largest number of distinct configurations in a level
+    uint32_t configs_max;
+    /// @brief Distinct configurations of the last level
+    uint32_t configs_last;
+} CountReport_t;
+
+CountReport_t countPaths(TM_t* t, uint64_t steps);
+void countReportPrint(FILE* file, CountReport_t* report, uint64_t steps);
+void countReportFree(CountReport_t* report);
+
+#endif
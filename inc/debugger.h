@@ -0,0 +1,76 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef DEBUGGER_H
+#define DEBUGGER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+
+// steps that can be undone without a snapshot (8 bytes each)
+#define DEBUG_LOG_STEPS         (1<<20)
+// steps between two snapshots
+#define DEBUG_SNAPSHOT_STEPS    65536
+// blank cells available on each side of the tape window, enough for any tape that fits in uint8_t
+#define DEBUG_MARGIN            256
+#define DEBUG_CELLS             (3*DEBUG_MARGIN)
+#define MAX_DEBUG_LINE          256
+
+/// @brief Undo record of a step, enough to restore the configuration before it
+typedef struct {
+    /// @brief State Index before the step
+    uint32_t state;
+    /// @brief Head Position before the step
+    uint8_t head;
+    /// @brief Symbol overwritten by the step
+    uint8_t symbol;
+    /// @brief Bit 0 if the tape grew to the left, bit 1 if it grew to the right
+    uint8_t growth;
+} DebugUndo_t;
+
+/// @brief Full configuration at a multiple of DEBUG_SNAPSHOT_STEPS
+typedef struct {
+    uint8_t cells[UINT8_MAX];
+    uint8_t length;
+    uint8_t head;
+    uint32_t state;
+} DebugSnapshot_t;
+
+/// @brief Time-travel debugger of a single DTM
+/// The tape is a window of a fixed buffer, so growing it never moves cells and undoing a growth only
+/// shrinks the window. Every step writes a DebugUndo_t to a ring log: recent steps are undone one by one,
+/// older steps are reached from the closest snapshot, never from the start
+typedef struct {
+    /// @brief Debugged TM, only its automaton is used
+    TM_t* t;
+    uint8_t cells[DEBUG_CELLS];
+    uint16_t start;
+    uint8_t length;
+    uint8_t head;
+    State_t* state;
+    /// @brief Steps since the debugger was created
+    uint64_t step;
+    /// @brief Steps of the TM before the debugger was created, printed steps are base+step
+    uint64_t base;
+    /// @brief Ring log of the last log_size steps, log_next is the next record
+    DebugUndo_t* log;
+    uint32_t log_next;
+    uint32_t log_size;
+    /// @brief Snapshot k holds step k*DEBUG_SNAPSHOT_STEPS
+    DebugSnapshot_t* snapshots;
+    uint32_t snapshots_size;
+} Debugger_t;
+
+Debugger_t* debugCreate(TM_t* t);
+void debugFree(Debugger_t* d);
+uint8_t debugStep(Debugger_t* d);
+uint8_t debugBack(Debugger_t* d);
+void debugJump(Debugger_t* d, uint64_t step);
+uint8_t debugLastVisit(Debugger_t* d, State_t* state);
+void debugPrint(Debugger_t* d);
+void debugRepl(Debugger_t* d, FILE* input);
+
+#endif
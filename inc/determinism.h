@@ -0,0 +1,16 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef DETERMINISM_H
+#define DETERMINISM_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+#include <interpreter.h>
+
+uint32_t determinismConflicts(AutomataParser_t a, FILE* file);
+
+#endif
@@ -0,0 +1,47 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef ENUMERATE_H
+#define ENUMERATE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+#include <alphabet.h>
+
+// longest input, so inputs still fit in a tape of 255 cells with a blank after them
+#define ENUMERATE_LENGTH_MAX    254
+#define ENUMERATE_STEPS_DEFAULT 100000
+// accepted inputs listed in the report
+#define ENUMERATE_LIST_MAX      64
+// consecutive inputs generated by a worker thread between two scheduling decisions
+#define ENUMERATE_CHUNK         1024
+// blank cells available on each side of an input tape, enough for any tape that fits in uint8_t
+#define ENUMERATE_MARGIN        256
+#define ENUMERATE_CELLS         (3*ENUMERATE_MARGIN)
+
+/// @brief Results of a DTM on every input up to a length
+typedef struct {
+    uint8_t symbols[256];
+    uint16_t symbols_size;
+    uint8_t max_length;
+    uint64_t max_steps;
+    uint64_t inputs;
+    /// @brief Inputs of every length accepted, stopped without accepting, stopped before growing the
+    /// tape past 255 cells and still running at the step bound
+    uint64_t accepted[ENUMERATE_LENGTH_MAX+1];
+    uint64_t rejected[ENUMERATE_LENGTH_MAX+1];
+    uint64_t full[ENUMERATE_LENGTH_MAX+1];
+    uint64_t looping[ENUMERATE_LENGTH_MAX+1];
+    /// @brief Indexes of the first accepted inputs in shortlex order (shorter inputs first)
+    uint64_t listed[ENUMERATE_LIST_MAX];
+    uint32_t listed_size;
+} EnumerateReport_t;
+
+int8_t enumerateParse(const char* text, Alphabet_t* alphabet, EnumerateReport_t* report);
+void enumerateInputs(TM_t* t, EnumerateReport_t* report, uint64_t max_steps, uint32_t threads);
+void enumerateReportPrint(FILE* file, EnumerateReport_t* report);
+
+#endif
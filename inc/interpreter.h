@@ -8,9 +8,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <setjmp.h>
 #include <rules.h>
+#include <alphabet.h>
 
 #define MAX_LINE_LENGTH 255
+// state indexes of MoveIndex_t keys take 24 bits
+#define MAX_STATES      (((uint32_t)1<<24)-1)
+// commas of a move line with TAPES_MAX tapes
+#define MAX_COMMAS      (3*TAPES_MAX+1)
 
 typedef struct {
     // State Origin Name
@@ -23,34 +29,45 @@ typedef struct {
     uint8_t* new_state_name;
     // Move of the Head of Turing Machine (Left, Right or Stick in Position)
     uint8_t head_move;
+    // Script Line Number where the move is defined
+    uint32_t line_number;
+    // Read Symbols, Write Symbols and Head Moves of every tape (first elements are the ones above)
+    uint8_t read_symbols[TAPES_MAX];
+    uint8_t write_symbols[TAPES_MAX];
+    uint8_t head_moves[TAPES_MAX];
 } MoveParser_t;
 
 typedef struct {
     uint8_t** tapes;
     uint8_t* heads;
-    uint8_t size;
+    uint32_t size;
 } HeadParser_t;
 
 typedef struct {
     Move_t* moves;
-    uint8_t moves_size;
+    uint32_t moves_size;
     State_t* states;
-    uint8_t states_size;
+    uint32_t states_size;
+    uint8_t tapes_number;
 } AutomataParser_t;
 
 typedef struct {
     uint8_t** tapes;
-    uint8_t tapes_size;
+    uint32_t tapes_size;
     uint8_t* heads;
-    uint8_t head_size;
+    uint32_t head_size;
     uint8_t* initial_state;
     uint8_t** accept_states;
     uint8_t accept_states_size;
     MoveParser_t* move_parser;
-    uint8_t mparser_size;
+    uint32_t mparser_size;
+    uint8_t tapes_number;
+    // UTF-8 and named symbols of the script, NULL if every symbol is a single character
+    Alphabet_t* alphabet;
 } Parser_t;
 
 Parser_t parseFile(const int8_t *filename);
+Parser_t parseStream(FILE* file);
 AutomataParser_t parserToAutomata(Parser_t p);
 HeadParser_t parserToHeadParser(Parser_t p);
 TM_t DTM(uint8_t* tape, uint8_t head,AutomataParser_t a);
@@ -58,5 +75,12 @@ void cleanBuffer(char* buffer, char* clean_buffer);
 void wipeOffSubstring(char* input, char* output, const char* substring);
 void countCommas(char* line_buffer,uint8_t* positions,uint8_t* count);
 void errorLineMessage(uint32_t line_number);
+void freeParser(Parser_t* p);
+void freeAutomata(AutomataParser_t* a);
+void freeHeadParser(HeadParser_t* hp);
+void freeTM(TM_t* t);
+void interpreterRecover(jmp_buf* recover, char* messages, size_t size);
+void interpreterMessage(const char* format, ...);
+void interpreterExit();
 
 #endif
\ No newline at end of file
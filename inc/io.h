@@ -10,8 +10,8 @@
 #include <stdio.h>
 
 void printTape(uint8_t* TM_string,uint8_t TM_head);
-void printTapeNum(uint8_t* TM_string,uint8_t TM_head,uint8_t TM_num);
+void printTapeNum(uint8_t* TM_string,uint8_t TM_head,uint32_t TM_num);
 void printTMStatus(uint8_t stepStatus);
-void printTMStatusNum(uint8_t stepStatus,uint8_t TM_num);
+void printTMStatusNum(uint8_t stepStatus,uint32_t TM_num);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,26 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef LBA_H
+#define LBA_H
+
+#include <stdint.h>
+#include <rules.h>
+
+/// @brief Tapes of a batch of linear-bounded machines
+/// Every tape is allocated once with the declared bound in a single contiguous slab
+/// (bound cells and a terminating zero per machine) and never grows
+typedef struct {
+    uint8_t* cells;
+    /// @brief Number of cells of every tape
+    uint8_t bound;
+    uint32_t machines;
+} LBASlab_t;
+
+LBASlab_t* lbaCreate(TM_t* t, uint32_t machines, uint8_t bound);
+void lbaFree(LBASlab_t* slab);
+uint8_t lbaRun(TM_t* t, uint8_t bound, uint64_t steps, Move_t** last_move);
+
+#endif
@@ -17,6 +17,9 @@
 #include <wchar.h>
 #endif
 
+// steps of a running machine between two polls of the first accept cancellation flag
+#define CANCEL_POLL_STEPS 4096
+
 #ifdef MINGW
 const wchar_t* PROGRAM_NAME= L"Turing Machine Simulator v1.0\n";
 const wchar_t* AUTHOR_NAME = L"Chandler Klüser, 2024\n"; 
@@ -32,11 +35,96 @@ const char* VERSION = "v1.0\n";
 uint8_t isVerbose   = 0;
 uint8_t DTM_mode    = 0;
 uint8_t NDTM_mode   = 0;
+uint8_t AUTO_mode   = 0;
 uint8_t firstAccept = 0;
 uint8_t TM_defined  = 0;
+// set once any machine accepts in first accept mode, shared by every thread
+uint8_t cancelRun   = 0;
 Parser_t p;
 
+const char* traceFilename = NULL;
+uint32_t traceInterval    = TRACE_KEYFRAME_DEFAULT;
+Trace_t* trace            = NULL;
+
+const char* checkpointFilename = NULL;
+const char* resumeFilename     = NULL;
+uint64_t checkpointSteps       = CHECKPOINT_STEPS_DEFAULT;
+uint32_t checkpointSeconds     = 0;
+Checkpoint_t* checkpoint       = NULL;
+
+uint8_t statsFormat       = 0;
+FILE* statsFile           = NULL;
+MachineStats_t* stats     = NULL;
+
+uint8_t profileEnabled    = 0;
+FILE* profileFile         = NULL;
+Profile_t* profile        = NULL;
+uint32_t profileThreads   = 1;
+
+MultiTM_t* multi          = NULL;
+
+uint8_t optimizeEnabled   = 0;
+uint8_t optimizeCheck     = 0;
+uint8_t optimizeDead      = 0;
+
+uint8_t sweepEnabled      = 1;
+Sweep_t* sweep            = NULL;
+
+TapeArena_t* arenas       = NULL;
+uint8_t arenaPin          = 0;
+
+uint32_t shards           = 0;
+
+uint8_t outputFormat      = 0;
+FILE* outputFile          = NULL;
+// 1 when result records are written to the console
+uint8_t outputQuiet       = 0;
+
+uint8_t countEnabled      = 0;
+uint64_t countSteps       = 0;
+
+uint64_t sampleWalksNumber = 0;
+uint64_t sampleSeed       = 1;
+uint64_t sampleSteps      = 1000000;
+
+uint8_t witnessEnabled    = 1;
+
+uint8_t lbaEnabled        = 0;
+uint8_t lbaBound          = 0;
+LBASlab_t* lba            = NULL;
+
+const char* enumerateText  = NULL;
+uint64_t enumerateSteps   = 100000;
+
+uint8_t debugEnabled      = 0;
+uint32_t debugMachine     = 0;
+
+char** breakNames         = NULL;
+uint32_t breakNamesSize   = 0;
+int32_t* watchCells       = NULL;
+uint32_t watchCellsSize   = 0;
+uint64_t breakStep        = 0;
+Breakpoints_t* breakpoints = NULL;
+
 void parseArgs(int argc, char *argv[]);
+const char* optionValue(int argc, char *argv[], uint16_t* i, const char* option);
+uint8_t runDTM(TM_t* t, uint32_t tm_num);
+void runDTMPlain(TM_t* t, uint8_t* tmlen);
+void runDTMTraced(TM_t* t, uint32_t tm_num, uint8_t* tmlen);
+void runDTMBreak(TM_t* t, uint32_t tm_num, uint8_t* tmlen);
+void runDTMStats(TM_t* t, uint32_t tm_num, uint8_t initial_tmlen, uint8_t tmlen, double start);
+uint8_t runLBA(TM_t* t, uint32_t tm_num);
+uint8_t runMultiDTM(MultiTM_t* m, uint32_t tm_num);
+uint8_t cancelRequested();
+void cancelDTM(TM_t* t, uint32_t tm_num);
+void reportDTM(TM_t* t, uint32_t tm_num, uint8_t status);
+#ifndef MINGW
+void runShardMachine(void* context, uint32_t tm_num, MachineStats_t* result);
+#endif
 void testTM();
+#ifdef BENCH
+// defined in bench/alloc_counter.c, linked only in benchmark builds
+void benchReport(uint64_t steps);
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef MULTITAPE_H
+#define MULTITAPE_H
+
+#include <stdint.h>
+#include <rules.h>
+
+#define TAPE_CAPACITY_MIN   (uint32_t) 64
+
+/// @brief Single Tape of a Multi-Tape Turing Machine
+/// Cells are kept in a buffer with free space on both sides, so the tape grows by doubling
+/// its capacity instead of reallocating (and shifting) once per appended blank cell
+typedef struct {
+    /// @brief Cells Buffer (capacity length), used cells are in [left, right)
+    uint8_t* cells;
+    /// @brief Cells Buffer Length
+    uint32_t capacity;
+    /// @brief Index of the leftmost used cell
+    uint32_t left;
+    /// @brief Index after the rightmost used cell
+    uint32_t right;
+    /// @brief Head Position (index in cells)
+    uint32_t head;
+} Tape_t;
+
+/// @brief Multi-Tape Turing Machine Simulation Type
+/// Moves of each state are grouped, so a step compares the packed symbols under every head
+/// (a single uint64_t) with the read keys of the current state moves only
+typedef struct {
+    /// @brief Tapes (tapes_number valid elements)
+    Tape_t tapes[TAPES_MAX];
+    /// @brief Number of Tapes
+    uint8_t tapes_number;
+    /// @brief States Pointer
+    State_t* states;
+    /// @brief States Array Length
+    uint32_t states_size;
+    /// @brief Moves Pointer
+    Move_t* moves;
+    /// @brief Moves Array Length
+    uint32_t moves_size;
+    /// @brief Moves grouped by current state, moves of state i are in [state_first[i], state_first[i+1])
+    Move_t** state_moves;
+    /// @brief First element of each state in state_moves (states_size+1 length)
+    uint32_t* state_first;
+    /// @brief Current State Pointer (points to an element of states)
+    State_t* current_state;
+    /// @brief Number of steps already simulated
+    uint64_t steps;
+    /// @brief Number of tape buffer reallocations
+    uint64_t reallocations;
+    /// @brief Simulation status, same codes of runStepTM (0 while running)
+    uint8_t status;
+} MultiTM_t;
+
+MultiTM_t multiTM(TM_t* t, uint8_t tapes_number);
+uint8_t runStepMultiTM(MultiTM_t* m, Move_t** last_move);
+uint32_t multiTMTapeMax(MultiTM_t* m);
+void printMultiTapeNum(MultiTM_t* m, uint32_t TM_num);
+void freeMultiTM(MultiTM_t* m);
+
+#endif
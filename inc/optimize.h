@@ -0,0 +1,43 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+#include <interpreter.h>
+
+/// @brief Before and after counters of an automaton optimization
+typedef struct {
+    uint32_t states_before;
+    uint32_t moves_before;
+    uint32_t states_after;
+    uint32_t moves_after;
+    /// @brief Moves that can never be applied (shadowed by an earlier move or leaving an accept state)
+    uint32_t unused;
+    /// @brief MOVE_WAIT moves fused into the move they are applied before
+    uint32_t fused;
+    /// @brief States unreachable from the initial state
+    uint32_t unreachable;
+    /// @brief States that can not reach any accept state (only removed when pruning dead states)
+    uint32_t dead;
+    /// @brief States merged into an equivalent state
+    uint32_t merged;
+    /// @brief 1 if dead states were removed, so machines that can no longer accept stop earlier
+    uint8_t dead_pruned;
+    /// @brief Optimized state index of every original state, OPTIMIZE_REMOVED for removed states
+    uint32_t* state_map;
+} OptimizeReport_t;
+
+#define OPTIMIZE_REMOVED    UINT32_MAX
+
+AutomataParser_t optimizeAutomata(AutomataParser_t a, uint8_t prune_dead, OptimizeReport_t* report);
+void optimizeReportPrint(FILE* file, OptimizeReport_t* report);
+uint8_t optimizeVerify(FILE* file, AutomataParser_t original, AutomataParser_t optimized, OptimizeReport_t* report, HeadParser_t hp);
+void optimizeReportFree(OptimizeReport_t* report);
+
+#endif
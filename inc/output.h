@@ -0,0 +1,42 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+
+#define OUTPUT_FORMAT_JSONL     (uint8_t) 1
+#define OUTPUT_FORMAT_CSV       (uint8_t) 2
+#define OUTPUT_FORMAT_BINARY    (uint8_t) 3
+
+// Binary output: "TMOUT" magic and a version byte, then one record per machine
+// (integers are little endian):
+//   uint32 machine, uint8 status, uint64 steps, uint16 state name length, state name,
+//   uint8 tapes, then for every tape: int32 head, uint32 tape length, tape
+#define OUTPUT_MAGIC            "TMOUT"
+#define OUTPUT_VERSION          (uint8_t) 2
+
+/// @brief Final result of a machine, its tapes are not copied
+typedef struct {
+    uint32_t machine;
+    uint8_t status;
+    uint64_t steps;
+    const uint8_t* state;
+    /// @brief Number of tapes
+    uint8_t tapes;
+    /// @brief Tape cells of every tape (not NUL-terminated) and their number
+    const uint8_t* cells[TAPES_MAX];
+    uint32_t length[TAPES_MAX];
+    /// @brief Head index in the cells of every tape
+    uint32_t head[TAPES_MAX];
+} OutputRecord_t;
+
+void outputBegin(FILE* file, uint8_t format, uint8_t tapes);
+void outputRecord(FILE* file, uint8_t format, OutputRecord_t* record);
+
+#endif
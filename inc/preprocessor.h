@@ -0,0 +1,65 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef PREPROCESSOR_H
+#define PREPROCESSOR_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define PREPROCESSOR_DEFINES_MAX    256
+// nested includes and nested foreach loops
+#define PREPROCESSOR_DEPTH_MAX      8
+#define PREPROCESSOR_NAME_MAX       32
+#define PREPROCESSOR_VALUE_MAX      256
+
+#define PREPROCESSOR_NONE           (uint8_t) 0
+#define PREPROCESSOR_DEFINE         (uint8_t) 1
+#define PREPROCESSOR_INCLUDE        (uint8_t) 2
+#define PREPROCESSOR_FOREACH        (uint8_t) 3
+
+/// @brief Defines, foreach variables and included files of a script being parsed
+typedef struct {
+    char names[PREPROCESSOR_DEFINES_MAX][PREPROCESSOR_NAME_MAX];
+    char values[PREPROCESSOR_DEFINES_MAX][PREPROCESSOR_VALUE_MAX];
+    uint32_t size;
+    /// @brief Variables of the running foreach loops, innermost last
+    char variables[PREPROCESSOR_DEPTH_MAX][PREPROCESSOR_NAME_MAX];
+    char variable_values[PREPROCESSOR_DEPTH_MAX][PREPROCESSOR_VALUE_MAX];
+    uint8_t variables_size;
+    /// @brief Name of the last {name} that is neither a foreach variable nor a define (see preprocessorSubstitute)
+    char undefined[PREPROCESSOR_NAME_MAX];
+    /// @brief Script and included files, the file read is the last one
+    FILE* files[PREPROCESSOR_DEPTH_MAX+1];
+    /// @brief File paths (NULL if unknown) and line numbers of the include lines in the including files
+    char* paths[PREPROCESSOR_DEPTH_MAX+1];
+    uint32_t line_numbers[PREPROCESSOR_DEPTH_MAX+1];
+    uint8_t depth;
+} Preprocessor_t;
+
+/// @brief Items of a foreach list: values, integer ranges (0..9) and character ranges (a..z) separated by commas
+typedef struct {
+    char text[PREPROCESSOR_VALUE_MAX];
+    uint16_t position;
+    /// @brief Range being iterated: next and last value, 0 if none
+    uint8_t range;
+    uint8_t characters;
+    int64_t next;
+    int64_t last;
+} PreprocessorList_t;
+
+Preprocessor_t* preprocessorCreate(FILE* file, const char* path);
+void preprocessorFree(Preprocessor_t* pp);
+char* preprocessorRead(Preprocessor_t* pp, char* line, int size, uint32_t* line_number);
+uint8_t preprocessorDirective(char* line, char** rest);
+int8_t preprocessorDefine(Preprocessor_t* pp, char* text);
+int8_t preprocessorInclude(Preprocessor_t* pp, char* text, uint32_t* line_number);
+int8_t preprocessorSubstitute(Preprocessor_t* pp, const char* input, char* output, size_t size);
+int8_t preprocessorPush(Preprocessor_t* pp, const char* name, const char* value);
+void preprocessorPop(Preprocessor_t* pp);
+void preprocessorListBegin(PreprocessorList_t* list, const char* text);
+uint8_t preprocessorListNext(PreprocessorList_t* list, char* value);
+
+#endif
@@ -0,0 +1,67 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+
+/// @brief Transition and State Hit Counters of a single thread
+/// Every thread owns its counters, so the step loop never synchronizes;
+/// the counters of all threads are merged when the report is written.
+/// Move and state counters are indexed like the moves and states arrays of each TM_t
+typedef struct {
+    /// @brief Number of times each move was applied
+    uint64_t* move_hits;
+    /// @brief Number of steps taken from each state
+    uint64_t* state_hits;
+    /// @brief Longest run of consecutive steps spent in each state
+    uint64_t* state_longest_run;
+    /// @brief Number of head moves in each direction (MOVE_LEFT, MOVE_RIGHT, MOVE_WAIT)
+    uint64_t head_moves[3];
+} Profile_t;
+
+/// @brief Consecutive steps of a single machine in the same state
+typedef struct {
+    /// @brief State of the current run, NULL before the first step
+    State_t* state;
+    /// @brief Current run length in steps
+    uint64_t length;
+} ProfileRun_t;
+
+Profile_t* profileCreate(TM_t* t, uint32_t threads);
+Profile_t* profileThread(Profile_t* profile);
+void profileRunEnd(Profile_t* pr, ProfileRun_t* run, TM_t* t);
+void profileReport(FILE* file, Profile_t* profile, uint32_t threads, TM_t* t, uint8_t runs);
+
+/// @brief Counts a move applied by a machine, without tracking state runs (NDTM branches)
+/// @param pr   Profile counters of the current thread
+/// @param t    TM whose moves and states arrays are profiled
+/// @param move Move applied in this step
+static inline void profileMove(Profile_t* pr, TM_t* t, Move_t* move) {
+    pr->move_hits[move - t->moves]++;
+    pr->state_hits[move->current_state - t->states]++;
+    pr->head_moves[move->head_move]++;
+}
+
+/// @brief Counts a DTM step and tracks its consecutive steps in the same state
+/// Inlined since it runs in the simulation hot loop
+/// @param pr   Profile counters of the current thread
+/// @param run  Current state run of the machine
+/// @param t    Profiled TM
+/// @param move Move applied in this step
+static inline void profileStep(Profile_t* pr, ProfileRun_t* run, TM_t* t, Move_t* move) {
+    profileMove(pr, t, move);
+    if (move->current_state == run->state) run->length++;
+    else {
+        profileRunEnd(pr, run, t);
+        run->state = move->current_state;
+        run->length = 1;
+    }
+}
+
+#endif
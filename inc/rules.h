@@ -21,6 +21,16 @@
 #define STATUS_ACCEPT (uint8_t) 1
 #define STATUS_NOMOVE (uint8_t) 2
 #define STATUS_MMOVES (uint8_t) 3
+#define STATUS_CANCEL (uint8_t) 4
+#define STATUS_CRASH  (uint8_t) 5
+#define STATUS_OFFEND (uint8_t) 6
+// single tape DTMs whose tape would be longer than 255 cells stop before the move
+#define STATUS_FULL   (uint8_t) 7
+
+#define TAPES_MAX     (uint8_t) 8
+
+// next move of a MoveIndex_t chain after the last one
+#define MOVE_INDEX_END  UINT32_MAX
 
 /// @brief Turing Machine Automaton State
 typedef struct {
@@ -42,8 +52,31 @@ typedef struct {
     uint8_t write_symbol;
     /// @brief Move of the Head of Turing Machine (Left, Right or Stick in Position)
     uint8_t head_move;
+    /// @brief Script Line Number where the move is defined (0 if unknown)
+    uint32_t line_number;
+    /// @brief Read Symbols of every tape packed in a key (tape i in byte i), used by multi-tape engines
+    uint64_t read_key;
+    /// @brief Write Symbols of every tape packed like read_key
+    uint64_t write_key;
+    /// @brief Head Moves of every tape packed with 2 bits per tape (tape i in bits 2i and 2i+1)
+    uint16_t head_moves;
 } Move_t;
 
+/// @brief Moves of every (state, read symbol) of an automaton, so a step finds its move without scanning every move
+/// Keys are kept in an open addressing table (twice the moves at least), moves with the same key are chained in script order
+typedef struct {
+    /// @brief States and Moves the index was built from (state index = state pointer - states)
+    State_t* states;
+    Move_t* moves;
+    /// @brief Slot keys (state index * 256 + read symbol + 1, 0 for a free slot) and first move of every key
+    uint32_t* keys;
+    uint32_t* first;
+    /// @brief Number of slots - 1, a power of two minus one
+    uint32_t mask;
+    /// @brief Next move index with the same state and read symbol, MOVE_INDEX_END after the last one
+    uint32_t* next;
+} MoveIndex_t;
+
 /// @brief Turing Machine Simulation Type
 typedef struct {
     /// @brief Tape String
@@ -53,11 +86,19 @@ typedef struct {
     /// @brief Moves Pointer
     Move_t* moves;
     /// @brief Moves Array Length
-    uint8_t moves_size;
+    uint32_t moves_size;
     /// @brief States Pointer
     State_t* states;
     /// @brief States Array Length
-    uint8_t states_size;
+    uint32_t states_size;
+    /// @brief Moves of every (state, read symbol), NULL to scan the moves array
+    MoveIndex_t* index;
+    /// @brief Current State Pointer (points to an element of states)
+    State_t* current_state;
+    /// @brief Number of steps already simulated
+    uint64_t steps;
+    /// @brief Simulation status, same codes of runStepTM (0 while running)
+    uint8_t status;
 } TM_t;
 
 /// @brief Valid Moves Found for NDTMs search
@@ -67,7 +108,7 @@ typedef struct {
     Move_t** base;
     /// @brief Move_t Pointers Array Length
     /// zero if there is no Valid Move
-    uint8_t length;
+    uint32_t length;
 } ValidMoves_t;
 
 /// @brief Status from a NDTM Step
@@ -84,9 +125,14 @@ typedef struct {
 } StatusNDTM_t;
 
 void moveHead(uint8_t* head,uint8_t head_move);
-Move_t* findValidMove(uint8_t* string, uint8_t TM_str_head, Move_t* moves,uint8_t moves_size, State_t* current_state);
+MoveIndex_t* moveIndexCreate(State_t* states, Move_t* moves, uint32_t moves_size);
+Move_t* moveIndexFind(MoveIndex_t* index, State_t* state, uint8_t symbol);
+Move_t* moveIndexNext(MoveIndex_t* index, Move_t* move);
+void moveIndexFree(MoveIndex_t* index);
+Move_t* findValidMove(uint8_t* string, uint8_t TM_str_head, Move_t* moves, uint32_t moves_size, State_t* current_state, MoveIndex_t* index);
 void appendTMTapeLeft(uint8_t** TM_str, uint8_t** TM_str_head, uint8_t* TM_str_size);
 void appendTMTapeRight(uint8_t** TM_str, uint8_t** TM_str_head, uint8_t* TM_str_size);
-uint8_t runStepTM(uint8_t** TM_str, uint8_t* TM_str_head, uint8_t* TM_str_size, State_t* TM_states, State_t** state_head, uint8_t states_size, Move_t* moves,uint8_t moves_size);
+void applyMoveTM(uint8_t** TM_str, uint8_t* TM_str_head, uint8_t* TM_str_size, Move_t* step_move);
+uint8_t runStepTM(uint8_t** TM_str, uint8_t* TM_str_head, uint8_t* TM_str_size, State_t* TM_states, State_t** state_head, uint32_t states_size, Move_t* moves, uint32_t moves_size, MoveIndex_t* index, Move_t** last_move);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+
+// blank cells available on each side of a walk tape, enough for any tape that fits in uint8_t
+#define SAMPLE_MARGIN       256
+#define SAMPLE_CELLS        (3*SAMPLE_MARGIN)
+// script lines shown for the example accepting walk
+#define SAMPLE_EXAMPLE_MOVES 256
+
+/// @brief Result of a Monte Carlo sampling of NDTM computations
+typedef struct {
+    uint64_t walks;
+    uint64_t accepted;
+    /// @brief Walks without a valid move before accepting
+    uint64_t stopped;
+    /// @brief Walks whose tape would be longer than 255 cells
+    uint64_t full;
+    /// @brief Walks still running at the step bound
+    uint64_t unfinished;
+    /// @brief Steps of every walk
+    uint64_t steps;
+    /// @brief Lowest accepting walk, valid if accepted is not zero
+    uint64_t example;
+} SampleReport_t;
+
+SampleReport_t sampleWalks(TM_t* t, uint64_t walks, uint64_t seed, uint64_t max_steps, uint32_t threads);
+void sampleReportPrint(FILE* file, SampleReport_t* report, TM_t* t, uint64_t seed, uint64_t max_steps);
+
+#endif
@@ -0,0 +1,52 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef SERVE_H
+#define SERVE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+#include <interpreter.h>
+
+#define SERVE_THREADS_DEFAULT   (uint32_t) 4
+#define SERVE_LATENCIES_SIZE    (uint32_t) 65536
+#define SERVE_SESSIONS_MAX      (uint32_t) 64
+// steps of a run or step request, so a machine that never halts does not hold a worker thread forever
+#define SERVE_STEPS_DEFAULT     (uint64_t) 10000000
+
+/// @brief Automaton loaded by the server, with a pool of machines ready to be reused
+/// Pooled machines keep their states, moves and tape buffers, so a request only
+/// copies its input tape instead of parsing the script and building a machine
+typedef struct {
+    /// @brief Name given in the load request
+    char* name;
+    /// @brief Parsed Automaton (every pooled machine is created from it)
+    AutomataParser_t automata;
+    /// @brief Idle machines
+    TM_t* pool;
+    /// @brief Number of idle machines
+    uint32_t pool_size;
+    /// @brief Idle machines array capacity
+    uint32_t pool_capacity;
+} ServeAutomaton_t;
+
+/// @brief Machine opened by a step session of a client
+typedef struct {
+    /// @brief Automaton of the machine, NULL if the session slot is free
+    ServeAutomaton_t* automaton;
+    /// @brief Machine taken from the automaton pool
+    TM_t t;
+    /// @brief Tape Length
+    uint8_t tmlen;
+    /// @brief Input Tape given when the session was opened, restored by reset
+    char* input;
+    /// @brief Input Head Position
+    uint8_t input_head;
+} ServeSession_t;
+
+int serveMain(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,42 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#ifndef MINGW
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <stats.h>
+
+/// @brief Runs a single machine in a worker process and fills its statistics
+typedef void (*ShardRun_t)(void* context, uint32_t machine, MachineStats_t* result);
+
+/// @brief Result of a machine, sent from a worker to the coordinator
+typedef struct {
+    uint32_t machine;
+    MachineStats_t stats;
+} ShardResult_t;
+
+/// @brief Worker Process of the coordinator
+typedef struct {
+    /// @brief Process ID, zero if the worker is not running
+    pid_t pid;
+    /// @brief Pipe where the coordinator writes ranges of machines
+    int commands;
+    /// @brief Pipe where the worker writes the result of each machine
+    int results;
+    /// @brief First machine of the current range without a result
+    uint32_t next;
+    /// @brief End (exclusive) of the current range
+    uint32_t end;
+} ShardWorker_t;
+
+uint32_t shardRun(uint32_t shards, uint32_t machines, uint8_t first_accept, uint8_t print_status, ShardRun_t run, void* context, MachineStats_t* results);
+
+#endif
+
+#endif
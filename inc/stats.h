@@ -0,0 +1,38 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define STATS_FORMAT_JSON   (uint8_t) 1
+#define STATS_FORMAT_CSV    (uint8_t) 2
+
+/// @brief Runtime Statistics of a single Turing Machine
+/// Steps are always counted by the engines, tape counters are derived from the tape
+/// growth when a machine finishes and time is only measured when statistics are enabled,
+/// so the step loop has no extra work
+typedef struct {
+    /// @brief Final status (runStepTM codes)
+    uint8_t status;
+    /// @brief Number of simulated steps (every branch step for NDTMs)
+    uint64_t steps;
+    /// @brief Maximum tape extent in cells
+    uint32_t tape_max;
+    /// @brief Number of tape reallocations (one per appended blank cell)
+    uint64_t tape_reallocations;
+    /// @brief Number of NDTM branches (1 for DTMs)
+    uint64_t branches;
+    /// @brief Simulation time in seconds
+    double seconds;
+} MachineStats_t;
+
+double statsClock();
+const char* statsStatusName(uint8_t status);
+void statsReport(FILE* file, uint8_t format, const char* mode, MachineStats_t* stats, uint32_t stats_size, double wall_seconds);
+
+#endif
@@ -0,0 +1,35 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdint.h>
+#include <rules.h>
+
+/// @brief Sweep of a single state: symbols whose move rewrites the same symbol,
+/// moves the head in the same direction and stays in the same state (like q0,0,0,>,q0)
+typedef struct {
+    /// @brief Number of swept symbols, zero if the state has no sweep
+    uint16_t size;
+    /// @brief Head Move of the sweep (MOVE_LEFT or MOVE_RIGHT)
+    uint8_t direction;
+    /// @brief 1 for every swept symbol
+    uint8_t symbols[256];
+    /// @brief Swept symbols as a string, for strspn scans
+    uint8_t span[256];
+} SweepState_t;
+
+/// @brief Sweeps of an automaton, indexed like the states array of its TM_t objects
+typedef struct {
+    SweepState_t* states;
+    uint32_t states_size;
+} Sweep_t;
+
+Sweep_t* sweepCreate(TM_t* t);
+void sweepFree(Sweep_t* sweep);
+uint64_t sweepRun(Sweep_t* sweep, TM_t* t, uint8_t tmlen, uint64_t limit);
+
+#endif
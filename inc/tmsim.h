@@ -0,0 +1,66 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+// libtmsim: embeddable simulator library (make lib / make shared)
+//
+// Every simulation lives in an opaque TMSim_t context, so programs can run several
+// simulations in one process. Contexts are independent and can be used by different
+// threads at the same time, but a single context must not be used concurrently.
+// Entry points never exit the process: invalid scripts and arguments are reported with
+// negative return codes and tmsimError. Memory is owned by the context and released
+// by tmsimDestroy; results are copied to buffers given by the caller.
+// Scripts with UTF-8 and named symbols are supported: tapes given to tmsimAddMachine are
+// written like in the script and converted to cell codes, heads and tape lengths count
+// symbols, and tmsimResult writes tapes back with their UTF-8 characters and [names].
+
+#ifndef TMSIM_H
+#define TMSIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TMSIM_OK                0
+#define TMSIM_ERROR_SCRIPT      -1
+#define TMSIM_ERROR_ARGUMENT    -2
+#define TMSIM_ERROR_NO_AUTOMATON -3
+
+#define TMSIM_RUNNING           (uint8_t) 0
+#define TMSIM_ACCEPT            (uint8_t) 1
+#define TMSIM_STOPPED           (uint8_t) 2
+#define TMSIM_TAPE_FULL         (uint8_t) 7
+
+/// @brief Opaque Simulation Context
+typedef struct TMSim TMSim_t;
+
+/// @brief Result of a single machine
+typedef struct {
+    /// @brief TMSIM_ACCEPT, TMSIM_STOPPED, TMSIM_RUNNING (step limit reached) or
+    /// TMSIM_TAPE_FULL (single tape machine stopped before growing its tape past 255 cells)
+    uint8_t status;
+    /// @brief Number of simulated steps
+    uint64_t steps;
+    /// @brief Head Position in the tape, in symbols
+    uint32_t head;
+    /// @brief Tape Length in symbols (first tape of multi-tape machines)
+    uint32_t tape_length;
+} TMSimResult_t;
+
+TMSim_t* tmsimCreate();
+void tmsimDestroy(TMSim_t* sim);
+int tmsimLoadFile(TMSim_t* sim, const char* filename);
+int tmsimLoadScript(TMSim_t* sim, const char* script);
+int tmsimReserve(TMSim_t* sim, uint32_t machines);
+int tmsimAddMachine(TMSim_t* sim, const char* tape, uint32_t head);
+int tmsimAddScriptMachines(TMSim_t* sim);
+void tmsimClearMachines(TMSim_t* sim);
+void tmsimSetStepLimit(TMSim_t* sim, uint64_t steps);
+void tmsimSetThreads(TMSim_t* sim, uint32_t threads);
+void tmsimSetFirstAccept(TMSim_t* sim, uint8_t first_accept);
+int tmsimRun(TMSim_t* sim);
+uint32_t tmsimMachines(TMSim_t* sim);
+int tmsimResult(TMSim_t* sim, uint32_t machine, TMSimResult_t* result, char* tape, size_t tape_size);
+const char* tmsimError(TMSim_t* sim);
+
+#endif
@@ -0,0 +1,77 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+
+#define TRACE_MAGIC             "TMTR"
+#define TRACE_VERSION           (uint8_t) 1
+#define TRACE_KEYFRAME_DEFAULT  (uint32_t) 4096
+
+#define TRACE_CHUNK_KEYFRAME    (uint8_t) 'K'
+#define TRACE_CHUNK_STEPS       (uint8_t) 'S'
+#define TRACE_CHUNK_END         (uint8_t) 'E'
+
+/// @brief Binary Trace File shared by every traced Turing Machine
+///
+/// Layout (all integers little endian):
+/// - header:   "TMTR", version (u8), id bytes (u8), keyframe interval (u32)
+/// - states:   count (u32), then type (u8), name length (u16) and name for each state
+/// - moves:    count (u32), then current state (u32), new state (u32), read (u8),
+///             write (u8) and head move (u8) for each move
+/// - chunks:   kind (u8) and machine number (u32) followed by
+///             'K' keyframe: step (u64), state (u32), head (u32), tape length (u32), tape
+///             'S' steps:    first step (u64), count (u32), count transition ids
+///             'E' end:      steps (u64), status (u8)
+/// States and transition ids are indexes in the states and moves arrays of each TM_t
+typedef struct {
+    /// @brief Output File
+    FILE* file;
+    /// @brief Number of steps between two full tape keyframes
+    uint32_t keyframe_interval;
+    /// @brief Bytes used by each transition id (depends on moves length)
+    uint8_t id_bytes;
+} Trace_t;
+
+/// @brief Per Machine Buffer with the transition ids since the last keyframe
+typedef struct {
+    /// @brief Trace File, NULL when tracing is disabled
+    Trace_t* trace;
+    /// @brief TM Number in the running list
+    uint32_t machine;
+    /// @brief Step number of the first buffered transition id
+    uint64_t first_step;
+    /// @brief Number of buffered transition ids
+    uint32_t count;
+    /// @brief Transition ids buffer (keyframe_interval*id_bytes length)
+    uint8_t* ids;
+} TraceBuffer_t;
+
+Trace_t* traceOpen(const char* filename, TM_t* t, uint32_t keyframe_interval);
+void traceClose(Trace_t* trace);
+void traceBegin(TraceBuffer_t* tb, Trace_t* trace, uint32_t machine, TM_t* t, uint8_t tape_size);
+void traceKeyframeStep(TraceBuffer_t* tb, uint64_t step, TM_t* t, uint8_t tape_size);
+void traceEnd(TraceBuffer_t* tb, uint64_t steps, uint8_t status);
+int replayTrace(int argc, char *argv[]);
+
+/// @brief Records a single step of a traced machine, keyframes are written every keyframe interval
+/// Inlined since it runs in the simulation hot loop
+/// @param tb           Machine Trace Buffer
+/// @param move         Move applied in this step
+/// @param step         Step Number after the move was applied
+/// @param t            Traced TM (its current state is already the new state of the move)
+/// @param tape_size    TM Tape Length
+static inline void traceStep(TraceBuffer_t* tb, Move_t* move, uint64_t step, TM_t* t, uint8_t tape_size) {
+    uint32_t id = move - t->moves;
+    if (tb->trace->id_bytes == 1) tb->ids[tb->count] = (uint8_t)id;
+    else for (uint8_t i = 0; i < tb->trace->id_bytes; i++) tb->ids[tb->count*tb->trace->id_bytes+i] = (uint8_t)(id >> (8*i));
+    if (++tb->count == tb->trace->keyframe_interval) traceKeyframeStep(tb, step, t, tape_size);
+}
+
+#endif
@@ -0,0 +1,44 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef WITNESS_H
+#define WITNESS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <rules.h>
+
+// parent of the moves applied to the initial configuration
+#define WITNESS_NONE    UINT32_MAX
+
+/// @brief Move applied to reach a NDTM configuration, linked to the move before it
+typedef struct {
+    /// @brief Node of the previous move, WITNESS_NONE for the initial configuration (next free node once reclaimed)
+    uint32_t parent;
+    /// @brief Move index in the automaton moves array
+    uint32_t move;
+    /// @brief Child nodes plus one if a branch is currently at this node
+    uint16_t refs;
+} WitnessNode_t;
+
+/// @brief Tree of the moves of every NDTM branch, nodes of stopped branches are reused
+typedef struct {
+    WitnessNode_t* nodes;
+    uint32_t nodes_size;
+    uint32_t nodes_capacity;
+    /// @brief First reclaimed node, WITNESS_NONE if there is none
+    uint32_t free;
+    /// @brief Last node of every branch
+    uint32_t* leaves;
+    uint32_t leaves_size;
+} Witness_t;
+
+Witness_t* witnessCreate();
+void witnessFree(Witness_t* w);
+void witnessStep(Witness_t* w, uint32_t branch, uint32_t from, uint32_t move);
+void witnessStop(Witness_t* w, uint32_t branch);
+void witnessPrint(Witness_t* w, uint32_t branch, TM_t* t, State_t* initial_state);
+
+#endif
@@ -0,0 +1,154 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <alphabet.h>
+
+// alphabet used to print tapes, NULL for single byte symbols only
+static Alphabet_t* alphabet_display = NULL;
+
+/// @brief Allocates an alphabet without named symbols
+/// @return Alphabet_t*
+Alphabet_t* alphabetCreate() {
+    return calloc(1, sizeof(Alphabet_t));
+}
+
+/// @brief Deallocates an alphabet with its names
+/// @param a Alphabet_t*, ignored if NULL
+void alphabetFree(Alphabet_t* a) {
+    if (a==NULL) return;
+    for (uint16_t c = 0; c < 256; c++) free(a->names[c]);
+    free(a);
+}
+
+/// @brief Code of a name, adding it with the first free code if it is new
+/// @return Cell code, -1 if every code is used
+static int16_t alphabetIntern(Alphabet_t* a, const uint8_t* name, uint8_t length) {
+    for (uint16_t c = 1; c < 256; c++) {
+        if (a->names[c]!=NULL && strlen((char*)a->names[c])==length && memcmp(a->names[c],name,length)==0) return c;
+    }
+    // 128 to 255, then control characters (1 to 31 and 127)
+    for (uint16_t k = 0; k < 160; k++) {
+        uint8_t c = (k<128) ? 128+k : ((k<159) ? k-127 : 127);
+        if (a->names[c]!=NULL || a->literal[c]) continue;
+        a->names[c] = malloc(length+1);
+        memcpy(a->names[c],name,length);
+        a->names[c][length] = 0;
+        a->size++;
+        return c;
+    }
+    return -1;
+}
+
+/// @brief Declares a symbol name, written [name] in tapes and moves
+/// @param a        Alphabet_t*
+/// @param name     Name without brackets
+/// @param length   Name Length, at most ALPHABET_NAME_MAX-2 characters without brackets, commas or quotes
+/// @return         Cell code, -1 if the name is invalid or every code is used
+int16_t alphabetDeclare(Alphabet_t* a, const uint8_t* name, uint8_t length) {
+    uint8_t bracketed[ALPHABET_NAME_MAX];
+    if (length==0 || length>ALPHABET_NAME_MAX-2) return -1;
+    for (uint8_t i = 0; i < length; i++) if (strchr("[],\"\\",name[i])!=NULL || name[i]<0x20) return -1;
+    bracketed[0] = '[';
+    memcpy(bracketed+1,name,length);
+    bracketed[length+1] = ']';
+    a->declared = 1;
+    return alphabetIntern(a,bracketed,length+2);
+}
+
+/// @brief Reads the symbol at the start of a text: a declared [name], a UTF-8 character or a single byte
+/// @param a        Alphabet_t*
+/// @param text     Text, at least one character long
+/// @param length   Output Number of bytes of the symbol
+/// @return         Cell code, -1 for invalid UTF-8 characters or if every code is used
+int16_t alphabetSymbol(Alphabet_t* a, const uint8_t* text, uint8_t* length) {
+    uint8_t c = text[0];
+    if (c=='[' && a->declared) {
+        const uint8_t* end = (const uint8_t*)strchr((const char*)text,']');
+        if (end!=NULL && end-text<ALPHABET_NAME_MAX) {
+            uint8_t name_length = end-text+1;
+            for (uint16_t k = 1; k < 256; k++) {
+                if (a->names[k]!=NULL && strlen((char*)a->names[k])==name_length && memcmp(a->names[k],text,name_length)==0) {
+                    *length = name_length;
+                    return k;
+                }
+            }
+        }
+    }
+    if (c<0x80) {
+        a->literal[c] = 1;
+        *length = 1;
+        return c;
+    }
+    uint8_t size = (c>=0xC2 && c<=0xDF) ? 2 : (c>=0xE0 && c<=0xEF) ? 3 : (c>=0xF0 && c<=0xF4) ? 4 : 0;
+    if (size==0) return -1;
+    for (uint8_t i = 1; i < size; i++) if ((text[i]&0xC0)!=0x80) return -1;
+    *length = size;
+    return alphabetIntern(a,text,size);
+}
+
+/// @brief Converts a script tape to cell codes
+/// @param a        Alphabet_t*
+/// @param text     Tape as written in the script
+/// @param cells    Output Cell codes ending with 0, at least as long as text
+/// @return         Number of cells, -1 if a symbol is invalid
+int16_t alphabetEncode(Alphabet_t* a, const uint8_t* text, uint8_t* cells) {
+    int16_t size = 0;
+    while (*text!=0) {
+        uint8_t length;
+        int16_t code = alphabetSymbol(a,text,&length);
+        if (code<0) return -1;
+        cells[size++] = code;
+        text += length;
+    }
+    cells[size] = 0;
+    return size;
+}
+
+/// @brief Finds a control character used as a single byte symbol after its code was given to a name
+/// @param a    Alphabet_t*
+/// @return     Conflicting code, 0 if there is none
+uint8_t alphabetCollision(Alphabet_t* a) {
+    for (uint16_t c = 1; c < 256; c++) if (a->names[c]!=NULL && a->literal[c]) return c;
+    return 0;
+}
+
+/// @brief Sets the alphabet used to print tape cells
+/// @param a    Alphabet_t* of the running script, NULL for single byte symbols
+void alphabetDisplay(Alphabet_t* a) {
+    alphabet_display = a;
+}
+
+/// @brief Whether if a cell is printed with a name
+/// @param cell Cell code
+/// @return     1 if the cell has a name in the display alphabet, 0 elsewhere
+uint8_t alphabetNamed(uint8_t cell) {
+    return alphabet_display!=NULL && alphabet_display->names[cell]!=NULL;
+}
+
+/// @brief Name of a cell in the display alphabet
+/// @param cell Cell code
+/// @return     Cell Name, NULL for single byte symbols
+const uint8_t* alphabetName(uint8_t cell) {
+    return alphabetNamed(cell) ? alphabet_display->names[cell] : NULL;
+}
+
+/// @brief Printed width of a cell in characters, UTF-8 characters are a single character wide
+/// @param cell Cell code
+/// @return     Width of the cell name in the display alphabet, 1 for single byte symbols
+uint8_t alphabetWidth(uint8_t cell) {
+    if (!alphabetNamed(cell)) return 1;
+    uint8_t width = 0;
+    for (uint8_t* c = alphabet_display->names[cell]; *c!=0; c++) if ((*c&0xC0)!=0x80) width++;
+    return width;
+}
+
+/// @brief Prints a cell with its name in the display alphabet
+/// @param file Output File
+/// @param cell Cell code
+void alphabetPut(FILE* file, uint8_t cell) {
+    if (alphabetNamed(cell)) fputs((char*)alphabet_display->names[cell],file); else fputc(cell,file);
+}
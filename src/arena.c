@@ -0,0 +1,134 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#if defined(OPENMP) && !defined(MINGW)
+#define _GNU_SOURCE
+#include <sched.h>
+#include <unistd.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <arena.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+/// @brief Creates the arenas of every worker thread, without memory for tapes yet
+/// @param threads  Number of threads that may run machines
+/// @param pin      1 to pin every worker to a CPU (OpenMP builds on POSIX systems only)
+/// @return         TapeArena_t array with one element per thread
+TapeArena_t* arenaCreate(uint32_t threads, uint8_t pin) {
+    TapeArena_t* arenas = calloc(threads, sizeof(TapeArena_t));
+    for (uint32_t i = 0; i < threads; i++) arenas[i].pin = pin;
+    return arenas;
+}
+
+/// @brief Arena of the calling thread, its buffer is allocated (and first written)
+/// by the thread itself, so it is placed in the thread allocator and memory node
+/// @param arenas   TapeArena_t array returned by arenaCreate
+/// @return         TapeArena_t* owned by the calling thread
+TapeArena_t* arenaThread(TapeArena_t* arenas) {
+#ifdef OPENMP
+    TapeArena_t* arena = &arenas[omp_get_thread_num()];
+#else
+    TapeArena_t* arena = arenas;
+#endif
+    if (arena->cells!=NULL) return arena;
+#if defined(OPENMP) && !defined(MINGW)
+    if (arena->pin) {
+        cpu_set_t set;
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        CPU_ZERO(&set);
+        CPU_SET(omp_get_thread_num() % (cpus>0 ? cpus : 1), &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+#endif
+    arena->cells = malloc(ARENA_CELLS);
+    memset(arena->cells, ' ', ARENA_CELLS);
+    return arena;
+}
+
+/// @brief Deallocates the buffers and final tapes of every arena at once
+/// Final tapes of the machines run in the arenas are released too
+/// @param arenas   TapeArena_t array returned by arenaCreate, can be NULL
+/// @param threads  Number of threads given to arenaCreate
+void arenaFree(TapeArena_t* arenas, uint32_t threads) {
+    if (arenas==NULL) return;
+    for (uint32_t i = 0; i < threads; i++) {
+        free(arenas[i].cells);
+        while (arenas[i].slab!=NULL) {
+            ArenaSlab_t* next = arenas[i].slab->next;
+            free(arenas[i].slab);
+            arenas[i].slab = next;
+        }
+    }
+    free(arenas);
+}
+
+/// @brief Builds the tape of a machine in an arena, t->tape points to the arena buffer
+/// until arenaEnd is called
+/// @param arena    Arena of the calling thread
+/// @param t        TM_t object to be simulated, its tape is the script tape (or a checkpoint tape)
+///                 and it is not owned by the machine
+/// @param tmlen    Tape Length
+void arenaBegin(TapeArena_t* arena, TM_t* t, uint8_t tmlen) {
+    uint8_t* tape = arena->cells+ARENA_MARGIN;
+    memcpy(tape, t->tape, tmlen+1);
+    t->tape = tape;
+}
+
+/// @brief Moves the tape of a machine from an arena to the slab of final tapes of the arena,
+/// where it is kept until arenaFree
+/// @param arena    Arena of the calling thread, the one given to arenaBegin
+/// @param t        TM_t object loaded with arenaBegin
+/// @param tmlen    Tape Length
+void arenaEnd(TapeArena_t* arena, TM_t* t, uint8_t tmlen) {
+    if (arena->slab==NULL || arena->slab->used+tmlen+1 > ARENA_SLAB) {
+        ArenaSlab_t* slab = malloc(sizeof(ArenaSlab_t));
+        slab->next = arena->slab;
+        slab->used = 0;
+        arena->slab = slab;
+    }
+    uint8_t* tape = &arena->slab->cells[arena->slab->used];
+    arena->slab->used += tmlen+1;
+    memcpy(tape, t->tape, tmlen+1);
+    // only the tape window was written, blanking it leaves the arena ready for the next machine
+    memset(t->tape, ' ', tmlen+1);
+    t->tape = tape;
+}
+
+/// @brief runStepTM for a machine whose tape is in an arena: tapes grow inside the arena
+/// buffer, without reallocating or shifting cells
+/// @param t            TM_t object loaded with arenaBegin
+/// @param tmlen        Tape Length Pointer
+/// @param last_move    Output Pointer to the Move applied in this step, ignored if NULL
+/// @return             0, if valid state transition.
+///                     1, if DTM is in a Valid Accept State
+///                     2, if DTM stops
+///                     7, if the tape would be longer than 255 cells (the move is not applied)
+uint8_t arenaStepTM(TM_t* t, uint8_t* tmlen, Move_t** last_move) {
+    if (t->current_state->type==STATE_ACCEPT) return STATUS_ACCEPT;
+    Move_t* step_move = findValidMove(t->tape,t->head,t->moves,t->moves_size,t->current_state,t->index);
+    if (step_move==NULL) return STATUS_NOMOVE;
+    uint8_t grow_left = (step_move->head_move==MOVE_LEFT && t->head==0);
+    uint8_t grow_right = (step_move->head_move==MOVE_RIGHT && t->head==*tmlen-1);
+    if ((grow_left || grow_right) && *tmlen==UINT8_MAX) return STATUS_FULL;
+    t->current_state = step_move->new_state;
+    t->tape[t->head] = step_move->write_symbol;
+    if (grow_left) {
+        // the cell before the tape is already blank
+        t->tape--;
+        t->head++;
+        (*tmlen)++;
+    }
+    if (grow_right) {
+        t->tape[*tmlen] = ' ';
+        (*tmlen)++;
+        t->tape[*tmlen] = 0;
+    }
+    moveHead(&t->head,step_move->head_move);
+    if (last_move!=NULL) *last_move = step_move;
+    return STATUS_SGMOVE;
+}
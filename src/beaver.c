@@ -0,0 +1,503 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <rules.h>
+#include <beaver.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+#define BEAVER_HALT         (uint8_t) 0
+#define BEAVER_LOOP         (uint8_t) 1
+#define BEAVER_UNDECIDED    (uint8_t) 2
+
+#define BEAVER_THREADS_DEFAULT 4
+
+/// @brief Configuration of a running enumerated machine, the tape is a window of BEAVER_CELLS cells
+typedef struct {
+    uint8_t* tape;
+    uint32_t head;
+    /// @brief Visited cells, every other cell is blank
+    uint32_t left;
+    uint32_t right;
+    uint8_t state;
+    uint64_t steps;
+} BeaverRun_t;
+
+/// @brief Configuration saved when the head reached a new cell at an end of the visited cells,
+/// for translated cycle detection
+typedef struct {
+    /// @brief Copy of the visited cells
+    uint8_t* tape;
+    uint32_t left;
+    uint32_t right;
+    /// @brief New cell and state of the saved configuration, state is BEAVER_UNDEFINED until the first save
+    uint32_t edge;
+    uint8_t state;
+    /// @brief Farthest distance of the head from this end since the save
+    uint32_t back;
+    /// @brief New cells reached at this end, the configuration is saved after 1, 2, 4, 8... of them
+    uint64_t records;
+    uint64_t interval;
+} BeaverEdge_t;
+
+/// @brief Search state of a single thread
+typedef struct {
+    uint8_t states;
+    uint8_t symbols;
+    uint64_t max_steps;
+    /// @brief Tape window of every tree depth (defined transitions), children start from a copy
+    /// of the halting configuration of their parent
+    uint8_t* tapes;
+    /// @brief Cells written in the window of every depth, cleared before it is reused
+    uint32_t* dirty_left;
+    uint32_t* dirty_right;
+    /// @brief Configuration saved for cycle detection
+    uint8_t* saved;
+    /// @brief Configurations saved at the left (MOVE_LEFT) and right (MOVE_RIGHT) end for translated cycle detection
+    BeaverEdge_t edges[2];
+    /// @brief Machines with this many transitions are collected in frontier instead of run, 0 to run every machine
+    uint8_t split;
+    BeaverMachine_t* frontier;
+    uint64_t frontier_size;
+    FILE* undecided;
+    BeaverReport_t report;
+} BeaverSearch_t;
+
+/// @brief Checks if a machine that just reached a blank cell out of its visited cells
+/// reads blanks forever: every transition on a blank from its state moves in the same direction
+/// and the chain of states repeats before reaching an undefined transition
+/// @param m        Machine
+/// @param states   Number of states
+/// @param state    Current state
+/// @param move     Direction of the move that reached the new cell
+/// @return         1 if the machine never halts
+static uint8_t beaverRunsOff(BeaverMachine_t* m, uint8_t states, uint8_t state, uint8_t move) {
+    for (uint8_t k = 0; k <= states; k++) {
+        BeaverMove_t* t = &m->table[state][0];
+        if (t->next==BEAVER_UNDEFINED || t->move!=move) return 0;
+        state = t->next;
+    }
+    return 1;
+}
+
+/// @brief Saves the configuration of a run for cycle detection
+static void beaverSave(BeaverSearch_t* s, BeaverRun_t* r, BeaverRun_t* saved) {
+    *saved = *r;
+    memcpy(s->saved+r->left, r->tape+r->left, r->right-r->left+1);
+}
+
+/// @brief Compares a run with its saved configuration, cells visited after the save must be blank
+static uint8_t beaverSame(BeaverSearch_t* s, BeaverRun_t* r, BeaverRun_t* saved) {
+    if (r->state!=saved->state || r->head!=saved->head) return 0;
+    for (uint32_t k = r->left; k < saved->left; k++) if (r->tape[k]) return 0;
+    for (uint32_t k = saved->right+1; k <= r->right; k++) if (r->tape[k]) return 0;
+    return memcmp(r->tape+saved->left, s->saved+saved->left, saved->right-saved->left+1)==0;
+}
+
+/// @brief Checks if a machine that just reached a new cell at an end of its visited cells repeats
+/// the saved configuration of that end shifted: same state and same cells as far back from the end
+/// as the head went since the save. The moves since the save only read those cells and blank cells,
+/// so they repeat shifted forever
+/// @param e        Saved configuration of the end
+/// @param r        Configuration
+/// @param move     Direction of the move that reached the new cell
+/// @return         1 if the machine never halts
+static uint8_t beaverShifted(BeaverEdge_t* e, BeaverRun_t* r, uint8_t move) {
+    if (e->state!=r->state) return 0;
+    for (uint32_t k = 0; k <= e->back; k++) {
+        uint32_t now = (move==MOVE_RIGHT) ? r->head-k : r->head+k;
+        uint32_t then = (move==MOVE_RIGHT) ? e->edge-k : e->edge+k;
+        uint8_t saved = (then>=e->left && then<=e->right) ? e->tape[then] : 0;
+        if (r->tape[now]!=saved) return 0;
+    }
+    return 1;
+}
+
+/// @brief Updates the saved configuration of an end when the head reaches a new cell there
+/// @return 1 if the machine is a translated cycler (see beaverShifted)
+static uint8_t beaverEdge(BeaverEdge_t* e, BeaverRun_t* r, uint8_t move) {
+    if (beaverShifted(e, r, move)) return 1;
+    if (++e->records==e->interval) {
+        memcpy(e->tape+r->left, r->tape+r->left, r->right-r->left+1);
+        e->left = r->left;
+        e->right = r->right;
+        e->edge = r->head;
+        e->state = r->state;
+        e->back = 0;
+        e->interval *= 2;
+    }
+    return 0;
+}
+
+/// @brief Runs an enumerated machine until it reaches an undefined transition, loops or reaches the step bound
+/// Configurations are saved after 1, 2, 4, 8... steps (Brent's method): a machine repeating a configuration
+/// returns to the saved one once the saving interval is longer than its cycle. Machines repeating a configuration
+/// shifted along the tape are found in the same way, saving configurations when the head reaches new cells
+/// @param s        Search state
+/// @param m        Machine
+/// @param r        Configuration, updated with the last configuration
+/// @return         BEAVER_HALT, BEAVER_LOOP or BEAVER_UNDECIDED (step bound or end of the tape window)
+static uint8_t beaverRun(BeaverSearch_t* s, BeaverMachine_t* m, BeaverRun_t* r) {
+    BeaverRun_t saved;
+    uint64_t since = 0, interval = 1;
+    beaverSave(s, r, &saved);
+    for (uint8_t k = MOVE_LEFT; k <= MOVE_RIGHT; k++) {
+        s->edges[k].state = BEAVER_UNDEFINED;
+        s->edges[k].records = 0;
+        s->edges[k].interval = 1;
+    }
+    while (1) {
+        BeaverMove_t* t = &m->table[r->state][r->tape[r->head]];
+        if (t->next==BEAVER_UNDEFINED) return BEAVER_HALT;
+        if (r->steps>=s->max_steps) return BEAVER_UNDECIDED;
+        r->tape[r->head] = t->write;
+        r->state = t->next;
+        if (t->move==MOVE_LEFT) r->head--; else r->head++;
+        r->steps++;
+        if (r->head<r->left || r->head>r->right) {
+            if (r->head==0 || r->head==BEAVER_CELLS-1) return BEAVER_UNDECIDED;
+            if (r->head<r->left) r->left = r->head; else r->right = r->head;
+            if (beaverRunsOff(m, s->states, r->state, t->move)) return BEAVER_LOOP;
+            if (beaverEdge(&s->edges[t->move], r, t->move)) return BEAVER_LOOP;
+        }
+        if (r->right-r->head>s->edges[MOVE_RIGHT].back) s->edges[MOVE_RIGHT].back = r->right-r->head;
+        if (r->head-r->left>s->edges[MOVE_LEFT].back) s->edges[MOVE_LEFT].back = r->head-r->left;
+        if (beaverSame(s, r, &saved)) return BEAVER_LOOP;
+        if (++since==interval) {
+            beaverSave(s, r, &saved);
+            since = 0;
+            interval *= 2;
+        }
+    }
+}
+
+/// @brief Keeps a halting machine if it beats a record, ties keep the lowest name
+/// Records given as 0 are not compared
+static void beaverRecord(BeaverReport_t* report, BeaverMachine_t* m, uint64_t steps, uint64_t ones) {
+    char name[BEAVER_NAME_SIZE], best[BEAVER_NAME_SIZE];
+    if (steps>report->steps) {
+        report->steps = steps;
+        report->steps_holder = *m;
+    } else if (steps && steps==report->steps) {
+        beaverName(m, report->states, report->symbols, name);
+        beaverName(&report->steps_holder, report->states, report->symbols, best);
+        if (strcmp(name, best)<0) report->steps_holder = *m;
+    }
+    if (ones>report->ones) {
+        report->ones = ones;
+        report->ones_holder = *m;
+    } else if (ones && ones==report->ones) {
+        beaverName(m, report->states, report->symbols, name);
+        beaverName(&report->ones_holder, report->states, report->symbols, best);
+        if (strcmp(name, best)<0) report->ones_holder = *m;
+    }
+}
+
+/// @brief Writes an undecided machine to the undecided file and keeps the first ones for the report
+static void beaverUndecided(BeaverSearch_t* s, BeaverMachine_t* m) {
+    if (s->undecided!=NULL) {
+        char name[BEAVER_NAME_SIZE];
+        beaverName(m, s->states, s->symbols, name);
+#ifdef OPENMP
+        #pragma omp critical (beaver_undecided)
+#endif
+        fprintf(s->undecided, "%s\n", name);
+    }
+    if (s->report.listed_size<BEAVER_LIST_MAX) s->report.listed[s->report.listed_size++] = *m;
+}
+
+/// @brief Runs a machine of the tree normal form and its children
+/// A machine reaching an undefined transition halts there, and every way to define that
+/// transition is a child running on from the halting configuration. New states are only
+/// reached in order (renamed machines are skipped) and the first transition moves right
+/// (mirrored machines are skipped). The last undefined transition of a machine is always its halt
+/// @param s        Search state
+/// @param m        Machine
+/// @param r        Configuration to run from, its tape is the window of the machine depth
+static void beaverNode(BeaverSearch_t* s, BeaverMachine_t* m, BeaverRun_t r) {
+    uint8_t depth = m->defined;
+    if (s->split && depth==s->split) {
+        s->frontier = realloc(s->frontier, (s->frontier_size+1)*sizeof(BeaverMachine_t));
+        s->frontier[s->frontier_size++] = *m;
+        return;
+    }
+    uint8_t status = beaverRun(s, m, &r);
+    s->dirty_left[depth] = r.left;
+    s->dirty_right[depth] = r.right;
+    s->report.enumerated++;
+    if (status==BEAVER_LOOP) {
+        s->report.looping++;
+        return;
+    }
+    if (status==BEAVER_UNDECIDED) {
+        s->report.undecided++;
+        beaverUndecided(s, m);
+        return;
+    }
+    s->report.halting++;
+    uint8_t symbol = r.tape[r.head];
+    uint64_t ones = (symbol==0);
+    for (uint32_t k = r.left; k <= r.right; k++) ones += (r.tape[k]!=0);
+    m->halt_state = r.state;
+    m->halt_symbol = symbol;
+    beaverRecord(&s->report, m, r.steps+1, ones);
+    if (m->defined+1>=s->states*s->symbols) return;
+    uint8_t* tape = s->tapes + (size_t)(depth+1)*BEAVER_CELLS;
+    uint8_t last = (m->used<s->states) ? m->used : s->states-1;
+    for (uint8_t next = 0; next <= last; next++) {
+        for (uint8_t write = 0; write < s->symbols; write++) {
+            for (uint8_t move = MOVE_LEFT; move <= MOVE_RIGHT; move++) {
+                if (depth==0 && move==MOVE_LEFT) continue;
+                BeaverMachine_t child = *m;
+                child.table[r.state][symbol].write = write;
+                child.table[r.state][symbol].move = move;
+                child.table[r.state][symbol].next = next;
+                child.defined++;
+                if (next==m->used) child.used++;
+                BeaverRun_t child_run = r;
+                if (!s->split || child.defined<s->split) {
+                    memset(tape+s->dirty_left[depth+1], 0, s->dirty_right[depth+1]-s->dirty_left[depth+1]+1);
+                    memcpy(tape+r.left, r.tape+r.left, r.right-r.left+1);
+                    s->dirty_left[depth+1] = r.left;
+                    s->dirty_right[depth+1] = r.right;
+                    child_run.tape = tape;
+                }
+                beaverNode(s, &child, child_run);
+            }
+        }
+    }
+}
+
+/// @brief Allocates the search state of a thread
+static void beaverSearchCreate(BeaverSearch_t* s, uint8_t states, uint8_t symbols, uint64_t max_steps, FILE* undecided) {
+    memset(s, 0, sizeof(BeaverSearch_t));
+    s->states = states;
+    s->symbols = symbols;
+    s->max_steps = max_steps;
+    s->tapes = calloc((size_t)(states*symbols+1)*BEAVER_CELLS, 1);
+    s->dirty_left = calloc(states*symbols+1, sizeof(uint32_t));
+    s->dirty_right = calloc(states*symbols+1, sizeof(uint32_t));
+    s->saved = malloc(BEAVER_CELLS);
+    s->edges[MOVE_LEFT].tape = malloc(BEAVER_CELLS);
+    s->edges[MOVE_RIGHT].tape = malloc(BEAVER_CELLS);
+    s->undecided = undecided;
+    s->report.states = states;
+    s->report.symbols = symbols;
+}
+
+/// @brief Frees the search state of a thread
+static void beaverSearchFree(BeaverSearch_t* s) {
+    free(s->tapes);
+    free(s->dirty_left);
+    free(s->dirty_right);
+    free(s->saved);
+    free(s->edges[MOVE_LEFT].tape);
+    free(s->edges[MOVE_RIGHT].tape);
+    free(s->frontier);
+}
+
+/// @brief Runs a machine from the blank tape with the tape window of its depth
+static void beaverStart(BeaverSearch_t* s, BeaverMachine_t* m) {
+    uint8_t depth = m->defined;
+    BeaverRun_t r;
+    r.tape = s->tapes + (size_t)depth*BEAVER_CELLS;
+    memset(r.tape+s->dirty_left[depth], 0, s->dirty_right[depth]-s->dirty_left[depth]+1);
+    r.head = r.left = r.right = BEAVER_CELLS/2;
+    r.state = 0;
+    r.steps = 0;
+    beaverNode(s, m, r);
+}
+
+/// @brief Adds the counters and records of a thread to a report
+static void beaverMerge(BeaverReport_t* report, BeaverSearch_t* s) {
+    report->enumerated += s->report.enumerated;
+    report->halting += s->report.halting;
+    report->looping += s->report.looping;
+    report->undecided += s->report.undecided;
+    beaverRecord(report, &s->report.steps_holder, s->report.steps, 0);
+    beaverRecord(report, &s->report.ones_holder, 0, s->report.ones);
+    for (uint32_t k = 0; k < s->report.listed_size && report->listed_size<BEAVER_LIST_MAX; k++) report->listed[report->listed_size++] = s->report.listed[k];
+}
+
+/// @brief Enumerates every machine with the given states and symbols in tree normal form (see beaverNode),
+/// running each one on the blank tape to find the busy beaver records
+/// Machines with BEAVER_SPLIT transitions are collected first, then run with their children in parallel
+/// (OpenMP builds); a shard only runs the collected machines whose index modulo shards is its shard, so
+/// separate runs cover the whole search. Machines with fewer transitions are only counted by shard 0
+/// @param states       Number of states (1 to BEAVER_STATES_MAX)
+/// @param symbols      Number of symbols, blank included (2 to BEAVER_SYMBOLS_MAX)
+/// @param max_steps    Step bound of every machine
+/// @param shard        Shard of this run, lower than shards
+/// @param shards       Number of shards
+/// @param threads      Number of threads
+/// @param undecided    File for the names of every undecided machine, NULL for none
+/// @return             Search Report
+BeaverReport_t beaverSearch(uint8_t states, uint8_t symbols, uint64_t max_steps, uint32_t shard, uint32_t shards, uint32_t threads, FILE* undecided) {
+    BeaverReport_t report;
+    memset(&report, 0, sizeof(BeaverReport_t));
+    report.states = states;
+    report.symbols = symbols;
+    report.max_steps = max_steps;
+    (void)threads;
+
+    BeaverSearch_t collect;
+    beaverSearchCreate(&collect, states, symbols, max_steps, (shard==0) ? undecided : NULL);
+    collect.split = BEAVER_SPLIT;
+    BeaverMachine_t root;
+    memset(&root, 0, sizeof(BeaverMachine_t));
+    for (uint8_t i = 0; i < BEAVER_STATES_MAX; i++)
+        for (uint8_t j = 0; j < BEAVER_SYMBOLS_MAX; j++) root.table[i][j].next = BEAVER_UNDEFINED;
+    root.used = 1;
+    beaverStart(&collect, &root);
+    if (shard==0) beaverMerge(&report, &collect);
+    BeaverMachine_t* frontier = collect.frontier;
+    uint64_t frontier_size = collect.frontier_size;
+    report.frontier = frontier_size;
+    report.frontier_run = (frontier_size>shard) ? (frontier_size-shard+shards-1)/shards : 0;
+#ifdef OPENMP
+    #pragma omp parallel num_threads(threads)
+#endif
+    {
+        BeaverSearch_t s;
+        beaverSearchCreate(&s, states, symbols, max_steps, undecided);
+#ifdef OPENMP
+        #pragma omp for schedule(dynamic, 1)
+#endif
+        for (uint64_t k = shard; k < frontier_size; k += shards) beaverStart(&s, &frontier[k]);
+#ifdef OPENMP
+        #pragma omp critical (beaver_merge)
+#endif
+        beaverMerge(&report, &s);
+        beaverSearchFree(&s);
+    }
+    beaverSearchFree(&collect);
+    return report;
+}
+
+/// @brief Compact name of a machine: a transition per symbol ("1RB", "---" if undefined) and "_" between states
+/// @param m        Machine
+/// @param states   Number of states
+/// @param symbols  Number of symbols
+/// @param name     Output buffer of BEAVER_NAME_SIZE characters
+void beaverName(BeaverMachine_t* m, uint8_t states, uint8_t symbols, char* name) {
+    uint32_t k = 0;
+    for (uint8_t i = 0; i < states; i++) {
+        if (i) name[k++] = '_';
+        for (uint8_t j = 0; j < symbols; j++) {
+            BeaverMove_t* t = &m->table[i][j];
+            if (t->next==BEAVER_UNDEFINED) {
+                memcpy(&name[k], "---", 3);
+            } else {
+                name[k] = '0'+t->write;
+                name[k+1] = (t->move==MOVE_LEFT) ? 'L' : 'R';
+                name[k+2] = 'A'+t->next;
+            }
+            k += 3;
+        }
+    }
+    name[k] = 0;
+}
+
+/// @brief Writes a move line of a machine script, blank symbols are empty fields
+/// The first tape cell is the symbol 0, so transitions reading a blank also read 0
+static void beaverScriptMove(FILE* file, uint8_t state, uint8_t read, uint8_t write, uint8_t move, char next) {
+    char w[2] = {write ? '0'+write : 0, 0};
+    char r[2] = {read ? '0'+read : 0, 0};
+    fprintf(file, "  %c,%s,%s,%c,%c\n", 'A'+state, r, w, (move==MOVE_LEFT) ? '<' : '>', next);
+    if (read==0) fprintf(file, "  %c,0,%s,%c,%c\n", 'A'+state, w, (move==MOVE_LEFT) ? '<' : '>', next);
+}
+
+/// @brief Writes a record holder as a script, its halting transition writes 1 and moves to the accept state Z
+static void beaverScript(FILE* file, BeaverMachine_t* m, uint8_t states, uint8_t symbols) {
+    fprintf(file, "  tape=0\n  head=0\n  initial_state=A\n  accept_states=Z\n");
+    for (uint8_t i = 0; i < states; i++) {
+        for (uint8_t j = 0; j < symbols; j++) {
+            BeaverMove_t* t = &m->table[i][j];
+            if (t->next!=BEAVER_UNDEFINED) beaverScriptMove(file, i, j, t->write, t->move, 'A'+t->next);
+            else if (i==m->halt_state && j==m->halt_symbol) beaverScriptMove(file, i, j, 1, MOVE_RIGHT, 'Z');
+        }
+    }
+}
+
+/// @brief Writes the counters of a search, its record holders as scripts and the first undecided machines
+/// @param file     Output File
+/// @param report   Search Report
+void beaverReportPrint(FILE* file, BeaverReport_t* report) {
+    char name[BEAVER_NAME_SIZE];
+    fprintf(file, "Busy beaver search: %u states, %u symbols, at most %llu steps\n", report->states, report->symbols,
+            (unsigned long long)report->max_steps);
+    fprintf(file, "  Machines       %llu\n  Halting        %llu\n  Looping        %llu\n  Undecided      %llu\n",
+            (unsigned long long)report->enumerated, (unsigned long long)report->halting,
+            (unsigned long long)report->looping, (unsigned long long)report->undecided);
+    fprintf(file, "  Split          %llu (%llu run)\n", (unsigned long long)report->frontier, (unsigned long long)report->frontier_run);
+    if (report->steps) {
+        beaverName(&report->steps_holder, report->states, report->symbols, name);
+        fprintf(file, "Most steps: %llu by %s\n", (unsigned long long)report->steps, name);
+        beaverScript(file, &report->steps_holder, report->states, report->symbols);
+        beaverName(&report->ones_holder, report->states, report->symbols, name);
+        fprintf(file, "Most non blank cells: %llu by %s\n", (unsigned long long)report->ones, name);
+        beaverScript(file, &report->ones_holder, report->states, report->symbols);
+    }
+    if (report->listed_size) {
+        fprintf(file, "Undecided machines%s:\n", (report->undecided>report->listed_size) ? " (first found)" : "");
+        for (uint32_t k = 0; k < report->listed_size; k++) {
+            beaverName(&report->listed[k], report->states, report->symbols, name);
+            fprintf(file, "  %s\n", name);
+        }
+    }
+}
+
+/// @brief Busy beaver subcommand: tmsim beaver <states> [--symbols <n>] [--steps <n>] [--shard <i>/<n>] [--threads <n>] [--undecided <file>]
+/// @param argc     Arguments after the subcommand
+/// @param argv     Arguments after the subcommand
+/// @return         0 if the search ran, 1 for invalid arguments
+int beaverMain(int argc, char *argv[]) {
+    uint32_t states = 0, symbols = 2, shard = 0, shards = 1, threads = BEAVER_THREADS_DEFAULT;
+    uint64_t max_steps = BEAVER_STEPS_DEFAULT;
+    const char* undecided_filename = NULL;
+    char* end_ptr;
+    if (argc>0) states = strtoul(argv[0], &end_ptr, 10);
+    if (argc<1 || end_ptr==argv[0]) {
+        printf("Usage: tmsim beaver <states> [--symbols <n>] [--steps <n>] [--shard <i>/<n>] [--threads <n>] [--undecided <file>]\n");
+        return 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--symbols")==0 && i+1 < argc) symbols = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--steps")==0 && i+1 < argc) max_steps = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--threads")==0 && i+1 < argc) {
+            threads = strtoul(argv[++i], NULL, 10);
+            if (threads==0) threads = 1;
+        } else if (strcmp(argv[i], "--undecided")==0 && i+1 < argc) undecided_filename = argv[++i];
+        else if (strcmp(argv[i], "--shard")==0 && i+1 < argc) {
+            if (sscanf(argv[++i], "%u/%u", &shard, &shards)!=2 || shards==0 || shard>=shards) {
+                printf("Shards must be given as <shard>/<shards>, counting from 0.\n");
+                return 1;
+            }
+        } else {
+            printf("Unknown beaver option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (states<1 || states>BEAVER_STATES_MAX || symbols<2 || symbols>BEAVER_SYMBOLS_MAX) {
+        printf("Busy beaver searches need 1 to %u states and 2 to %u symbols.\n", BEAVER_STATES_MAX, BEAVER_SYMBOLS_MAX);
+        return 1;
+    }
+    if (max_steps==0) max_steps = BEAVER_STEPS_DEFAULT;
+    FILE* undecided = NULL;
+    if (undecided_filename!=NULL) {
+        undecided = fopen(undecided_filename, "w");
+        if (undecided==NULL) {
+            fprintf(stderr, "Error opening file %s\n", undecided_filename);
+            return 1;
+        }
+    }
+    BeaverReport_t report = beaverSearch(states, symbols, max_steps, shard, shards, threads, undecided);
+    if (undecided!=NULL) fclose(undecided);
+    beaverReportPrint(stdout, &report);
+    return 0;
+}
@@ -0,0 +1,87 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <breakpoint.h>
+#include <debugger.h>
+
+/// @brief Resolves breakpoints given by state name
+/// @param t            TM_t object with the automaton, every DTM of a script has the same state order
+/// @param states       State Names with a breakpoint
+/// @param states_size  Number of State Names
+/// @param cells        Watched Cells
+/// @param cells_size   Number of Watched Cells
+/// @param step         Step count that stops every machine, 0 for none
+/// @return             Breakpoints_t*, NULL if a state is not in the automaton
+Breakpoints_t* breakpointsCreate(TM_t* t, char** states, uint32_t states_size, int32_t* cells, uint32_t cells_size, uint64_t step) {
+    Breakpoints_t* b = malloc(sizeof(Breakpoints_t));
+    b->states = calloc(t->states_size+1, 1);
+    for (uint32_t i = 0; i < states_size; i++) {
+        uint8_t found = 0;
+        for (uint32_t k = 0; k < t->states_size; k++) {
+            if (strcmp((char*)t->states[k].name, states[i])==0) {b->states[k] = 1; found = 1;}
+        }
+        if (!found) {
+            printf("State %s of a breakpoint is not in the automaton.\n", states[i]);
+            breakpointsFree(b);
+            return NULL;
+        }
+    }
+    b->cells = malloc((cells_size+1)*sizeof(int32_t));
+    memcpy(b->cells, cells, cells_size*sizeof(int32_t));
+    b->cells_size = cells_size;
+    b->step = step;
+    return b;
+}
+
+/// @brief Deallocates breakpoints
+/// @param b Breakpoints_t*, ignored if NULL
+void breakpointsFree(Breakpoints_t* b) {
+    if (b==NULL) return;
+    free(b->states);
+    free(b->cells);
+    free(b);
+}
+
+/// @brief Checks the breakpoints after a step
+/// @param b        Breakpoints_t*
+/// @param t        TM_t object after the step
+/// @param m        Move applied in the step
+/// @param cell     Cell written by the step, counted like watched cells
+/// @param reason   Output Description of the hit, BREAKPOINT_REASON_SIZE characters
+/// @return         1 if a breakpoint or watchpoint is hit, 0 elsewhere
+uint8_t breakpointHit(Breakpoints_t* b, TM_t* t, Move_t* m, int32_t cell, char* reason) {
+    if (b->states[t->current_state-t->states] && m->current_state!=m->new_state) {
+        snprintf(reason, BREAKPOINT_REASON_SIZE, "Breakpoint: state %s", t->current_state->name);
+        return 1;
+    }
+    if (m->write_symbol!=m->read_symbol) {
+        for (uint32_t i = 0; i < b->cells_size; i++) {
+            if (b->cells[i]!=cell) continue;
+            snprintf(reason, BREAKPOINT_REASON_SIZE, "Watchpoint: cell %d changed", cell);
+            return 1;
+        }
+    }
+    if (t->steps==b->step) {
+        snprintf(reason, BREAKPOINT_REASON_SIZE, "Breakpoint: step %llu", (unsigned long long)b->step);
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Interactive inspector of a machine stopped by a breakpoint
+/// It is the debugger on a copy of the machine: steps forward and backward do not change the run,
+/// which continues from the breakpoint after quit
+/// @param t        TM_t object stopped by a breakpoint
+/// @param tm_num   TM Number in the running list
+/// @param reason   Description of the hit
+void breakpointInspect(TM_t* t, uint32_t tm_num, const char* reason) {
+    printf("%s, Turing Machine %u at step %llu (quit resumes the run)\n", reason, tm_num, (unsigned long long)t->steps);
+    Debugger_t* d = debugCreate(t);
+    debugRepl(d, stdin);
+    debugFree(d);
+}
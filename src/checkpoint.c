@@ -0,0 +1,272 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <checkpoint.h>
+#ifndef MINGW
+#include <unistd.h>
+#endif
+
+/// @brief Writes an unsigned integer to a checkpoint file as little endian bytes
+static void checkpointWriteUint(FILE* file, uint64_t value, uint8_t bytes) {
+    uint8_t buffer[8];
+    for (uint8_t i = 0; i < bytes; i++) buffer[i] = (uint8_t)(value >> (8*i));
+    fwrite(buffer, 1, bytes, file);
+}
+
+/// @brief Reads a little endian unsigned integer from a checkpoint file, exits program on truncated files
+static uint64_t checkpointReadUint(FILE* file, uint8_t bytes, const char* filename) {
+    uint8_t buffer[8];
+    uint64_t value = 0;
+    if (fread(buffer, 1, bytes, file)!=bytes) {
+        fprintf(stderr, "Checkpoint file %s is corrupted or truncated.\n", filename);
+        exit(1);
+    }
+    for (uint8_t i = 0; i < bytes; i++) value |= ((uint64_t)buffer[i]) << (8*i);
+    return value;
+}
+
+/// @brief FNV-1a hash step over a byte array
+static uint64_t hashBytes(uint64_t hash, const uint8_t* bytes, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/// @brief Hashes the automaton of a TM (states names and types, moves), so a checkpoint
+/// is never resumed with a different machine definition
+/// @param t    TM_t with the automaton
+/// @return     64-bit FNV-1a hash
+uint64_t automataHash(TM_t* t) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint32_t i = 0; i < t->states_size; i++) {
+        hash = hashBytes(hash, t->states[i].name, strlen(t->states[i].name)+1);
+        hash = hashBytes(hash, &t->states[i].type, 1);
+    }
+    for (uint32_t i = 0; i < t->moves_size; i++) {
+        uint32_t move[5];
+        move[0] = t->moves[i].current_state - t->states;
+        move[1] = t->moves[i].new_state - t->states;
+        move[2] = t->moves[i].read_symbol;
+        move[3] = t->moves[i].write_symbol;
+        move[4] = t->moves[i].head_move;
+        hash = hashBytes(hash, (uint8_t*)move, sizeof(move));
+    }
+    return hash;
+}
+
+/// @brief Copies the current state of a TM into a snapshot slot
+static void snapshotMachine(MachineSnapshot_t* m, TM_t* t, State_t* current_state, uint64_t steps, uint8_t status) {
+    free(m->tape);
+    m->tape = malloc(strlen(t->tape)+1);
+    strcpy(m->tape, t->tape);
+    m->head = t->head;
+    m->state = 0;
+    // NDTM branches keep State_t copies, names are shared with the automaton states
+    for (uint32_t j = 0; j < t->states_size; j++) {
+        if (t->states[j].name == current_state->name) {m->state = j; break;}
+    }
+    m->steps = steps;
+    m->status = status;
+}
+
+/// @brief Creates a checkpoint with snapshots of every TM in a batch
+/// @param filename         Checkpoint File Path in Disk
+/// @param t                TM_t array
+/// @param t_number         TM_t array length
+/// @param mode             CHECKPOINT_MODE_DTM or CHECKPOINT_MODE_NDTM
+/// @param interval_steps   Steps between two machine snapshots
+/// @param interval_seconds Minimum seconds between two checkpoint file writes
+/// @return                 Checkpoint_t* object
+Checkpoint_t* checkpointCreate(const char* filename, TM_t* t, uint32_t t_number, uint8_t mode, uint64_t interval_steps, uint32_t interval_seconds) {
+    Checkpoint_t* c = malloc(sizeof(Checkpoint_t));
+    c->filename = filename;
+    c->automata_hash = automataHash(&t[0]);
+    c->mode = mode;
+    c->machines_size = t_number;
+    c->machines = calloc(t_number+1, sizeof(MachineSnapshot_t));
+    for (uint32_t i = 0; i < t_number; i++) snapshotMachine(&c->machines[i], &t[i], t[i].current_state, t[i].steps, t[i].status);
+    c->frontier_index = 0;
+    c->steps = 0;
+    c->interval_steps = interval_steps;
+    c->interval_seconds = interval_seconds;
+    c->last_write = time(NULL);
+    c->pending_steps = 0;
+    return c;
+}
+
+/// @brief Updates the snapshot of a single DTM, it is safe to be called by concurrent machines
+/// @param c        Checkpoint_t object
+/// @param t        TM_t to be saved
+/// @param tm_num   TM Number in the running list
+void checkpointUpdate(Checkpoint_t* c, TM_t* t, uint32_t tm_num) {
+#ifdef OPENMP
+    #pragma omp critical (checkpoint)
+#endif
+    {
+        c->pending_steps += t->steps-c->machines[tm_num].steps;
+        snapshotMachine(&c->machines[tm_num], t, t->current_state, t->steps, t->status);
+    }
+}
+
+/// @brief Replaces every snapshot with the branches of a NDTM frontier
+/// @param c                Checkpoint_t object
+/// @param t                NDTM branches array
+/// @param flagStatus       NDTM branches status array
+/// @param current_state    NDTM branches current states array
+/// @param t_number         Last NDTM branch index
+/// @param frontier_index   Index of the next branch to be stepped
+/// @param steps            Total steps over all branches
+void checkpointUpdateNDTM(Checkpoint_t* c, TM_t* t, uint32_t* flagStatus, State_t* current_state, uint32_t t_number, uint32_t frontier_index, uint64_t steps) {
+    for (uint32_t i = t_number+1; i < c->machines_size; i++) free(c->machines[i].tape);
+    c->machines = realloc(c->machines, (t_number+1)*sizeof(MachineSnapshot_t));
+    for (uint32_t i = c->machines_size; i <= t_number; i++) c->machines[i].tape = NULL;
+    c->machines_size = t_number+1;
+    for (uint32_t i = 0; i <= t_number; i++) snapshotMachine(&c->machines[i], &t[i], &current_state[i], 0, flagStatus[i]);
+    c->frontier_index = frontier_index;
+    c->pending_steps += steps-c->steps;
+    c->steps = steps;
+}
+
+/// @brief Atomically writes the checkpoint file: data goes to a temporary file that replaces the old one
+/// @param c        Checkpoint_t object
+/// @param force    if 0, the file is only written when the snapshots took interval_steps steps and
+///                 interval_seconds have passed since the last write, so machines that finish do not
+///                 rewrite the whole batch each
+void checkpointWrite(Checkpoint_t* c, uint8_t force) {
+#ifdef OPENMP
+    #pragma omp critical (checkpoint)
+#endif
+    {
+        time_t now = time(NULL);
+        if (force || (c->pending_steps >= c->interval_steps && difftime(now, c->last_write) >= c->interval_seconds)) {
+            char* temporary = malloc(strlen(c->filename)+5);
+            sprintf(temporary, "%s.tmp", c->filename);
+            FILE* file = fopen(temporary, "wb");
+            if (file == NULL) {
+                fprintf(stderr, "Error creating checkpoint file %s\n", temporary);
+                exit(1);
+            }
+            fwrite(CHECKPOINT_MAGIC, 1, 4, file);
+            checkpointWriteUint(file, CHECKPOINT_VERSION, 1);
+            checkpointWriteUint(file, c->mode, 1);
+            checkpointWriteUint(file, c->automata_hash, 8);
+            checkpointWriteUint(file, c->frontier_index, 4);
+            checkpointWriteUint(file, c->steps, 8);
+            checkpointWriteUint(file, c->machines_size, 4);
+            for (uint32_t i = 0; i < c->machines_size; i++) {
+                MachineSnapshot_t* m = &c->machines[i];
+                uint32_t tape_size = strlen(m->tape);
+                checkpointWriteUint(file, m->status, 1);
+                checkpointWriteUint(file, m->state, 4);
+                checkpointWriteUint(file, m->head, 4);
+                checkpointWriteUint(file, m->steps, 8);
+                checkpointWriteUint(file, tape_size, 4);
+                fwrite(m->tape, 1, tape_size, file);
+            }
+            fflush(file);
+#ifndef MINGW
+            fsync(fileno(file));
+#endif
+            fclose(file);
+#ifdef MINGW
+            // rename does not replace existing files on windows
+            remove(c->filename);
+#endif
+            if (rename(temporary, c->filename) != 0) {
+                fprintf(stderr, "Error replacing checkpoint file %s\n", c->filename);
+                exit(1);
+            }
+            free(temporary);
+            c->last_write = now;
+            c->pending_steps = 0;
+        }
+    }
+}
+
+/// @brief Reads a checkpoint file
+/// @param filename Checkpoint File Path in Disk
+/// @return         Checkpoint_t* object, exits program if the file is invalid
+Checkpoint_t* checkpointLoad(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file %s\n", filename);
+        exit(1);
+    }
+    char magic[4];
+    if (fread(magic, 1, 4, file)!=4 || memcmp(magic, CHECKPOINT_MAGIC, 4)!=0 || checkpointReadUint(file, 1, filename)!=CHECKPOINT_VERSION) {
+        fprintf(stderr, "%s is not a checkpoint file.\n", filename);
+        exit(1);
+    }
+    Checkpoint_t* c = malloc(sizeof(Checkpoint_t));
+    c->filename = filename;
+    c->mode = checkpointReadUint(file, 1, filename);
+    c->automata_hash = checkpointReadUint(file, 8, filename);
+    c->frontier_index = checkpointReadUint(file, 4, filename);
+    c->steps = checkpointReadUint(file, 8, filename);
+    c->machines_size = checkpointReadUint(file, 4, filename);
+    c->machines = calloc(c->machines_size+1, sizeof(MachineSnapshot_t));
+    for (uint32_t i = 0; i < c->machines_size; i++) {
+        MachineSnapshot_t* m = &c->machines[i];
+        m->status = checkpointReadUint(file, 1, filename);
+        m->state = checkpointReadUint(file, 4, filename);
+        uint64_t head = checkpointReadUint(file, 4, filename);
+        m->steps = checkpointReadUint(file, 8, filename);
+        uint64_t tape_size = checkpointReadUint(file, 4, filename);
+        // tapes have at most 255 cells
+        if (tape_size > UINT8_MAX || head >= tape_size) {
+            fprintf(stderr, "Checkpoint file %s is corrupted or truncated.\n", filename);
+            exit(1);
+        }
+        m->head = head;
+        m->tape = malloc(tape_size+1);
+        // tapes are strings, a zero cell would cut the tape before the head
+        if (fread(m->tape, 1, tape_size, file)!=tape_size || memchr(m->tape, 0, tape_size)!=NULL) {
+            fprintf(stderr, "Checkpoint file %s is corrupted or truncated.\n", filename);
+            exit(1);
+        }
+        m->tape[tape_size] = 0;
+    }
+    fclose(file);
+    c->interval_steps = CHECKPOINT_STEPS_DEFAULT;
+    c->interval_seconds = 0;
+    c->last_write = time(NULL);
+    c->pending_steps = 0;
+    return c;
+}
+
+/// @brief Restores a batch of DTMs from a loaded checkpoint
+/// Exits program if the checkpoint does not match the automaton or the batch
+/// @param c        Checkpoint_t object loaded with checkpointLoad
+/// @param t        TM_t array already created from the same script, machines point to the checkpoint
+///                 tapes, which stay owned by the checkpoint
+/// @param t_number TM_t array length
+void checkpointRestore(Checkpoint_t* c, TM_t* t, uint32_t t_number) {
+    if (c->automata_hash != automataHash(&t[0])) {
+        printf("Checkpoint %s was created with a different automaton.\n", c->filename);
+        exit(1);
+    }
+    if (c->mode != CHECKPOINT_MODE_DTM || c->machines_size != t_number) {
+        printf("Checkpoint %s does not match this batch of Turing Machines.\n", c->filename);
+        exit(1);
+    }
+    for (uint32_t i = 0; i < t_number; i++) {
+        MachineSnapshot_t* m = &c->machines[i];
+        if (m->state >= t[i].states_size) {
+            printf("Checkpoint %s has an invalid state.\n", c->filename);
+            exit(1);
+        }
+        // like script tapes, checkpoint tapes are copied into the tape arenas when machines run
+        t[i].tape = m->tape;
+        t[i].head = m->head;
+        t[i].current_state = &t[i].states[m->state];
+        t[i].steps = m->steps;
+        // machines cancelled by a first accept run again when resumed
+        t[i].status = (m->status==STATUS_CANCEL) ? STATUS_SGMOVE : m->status;
+    }
+}
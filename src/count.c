@@ -0,0 +1,224 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <count.h>
+
+/// @brief Adds a big integer to another one (a += b)
+static void bigAdd(BigCount_t* a, BigCount_t* b) {
+    uint32_t size = (a->size > b->size ? a->size : b->size)+1;
+    if (size > a->capacity) {
+        a->limbs = realloc(a->limbs, size*sizeof(uint32_t));
+        a->capacity = size;
+    }
+    memset(a->limbs+a->size, 0, (size-a->size)*sizeof(uint32_t));
+    uint64_t carry = 0;
+    for (uint32_t i = 0; i < size; i++) {
+        uint64_t sum = (uint64_t)a->limbs[i] + (i < b->size ? b->limbs[i] : 0) + carry;
+        a->limbs[i] = (uint32_t)sum;
+        carry = sum >> 32;
+    }
+    // keeps the size without leading zero limbs
+    while (size > 0 && a->limbs[size-1] == 0) size--;
+    a->size = size;
+}
+
+/// @brief Copies a big integer
+static BigCount_t bigCopy(BigCount_t* a) {
+    BigCount_t c = {NULL, 0, 0};
+    bigAdd(&c, a);
+    return c;
+}
+
+/// @brief Writes a big integer in decimal
+static void bigPrint(FILE* file, BigCount_t* a) {
+    if (a->size == 0) {
+        fprintf(file, "0");
+        return;
+    }
+    // base 10^9 digits, from the least significant
+    uint32_t* value = malloc(a->size*sizeof(uint32_t));
+    uint32_t* digits = malloc((a->size*10/9+2)*sizeof(uint32_t));
+    uint32_t size = a->size, digits_size = 0;
+    memcpy(value, a->limbs, size*sizeof(uint32_t));
+    while (size > 0) {
+        uint64_t remainder = 0;
+        for (uint32_t i = size; i-- > 0;) {
+            uint64_t current = (remainder << 32) | value[i];
+            value[i] = (uint32_t)(current / 1000000000u);
+            remainder = current % 1000000000u;
+        }
+        digits[digits_size++] = (uint32_t)remainder;
+        while (size > 0 && value[size-1] == 0) size--;
+    }
+    fprintf(file, "%u", digits[digits_size-1]);
+    for (uint32_t i = digits_size-1; i-- > 0;) fprintf(file, "%09u", digits[i]);
+    free(value);
+    free(digits);
+}
+
+/// @brief Removes blank cells at the tape ends, except the cell under the head, and hashes the configuration
+static void countCanonical(CountConfig_t* c) {
+    uint32_t first = 0, last = c->length;
+    while (first < c->head && c->cells[first] == ' ') first++;
+    while (last-1 > c->head && c->cells[last-1] == ' ') last--;
+    memmove(c->cells, c->cells+first, last-first);
+    c->length = last-first;
+    c->head -= first;
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    hash = (hash ^ c->state) * 1099511628211ull;
+    hash = (hash ^ c->head) * 1099511628211ull;
+    for (uint32_t i = 0; i < c->length; i++) hash = (hash ^ c->cells[i]) * 1099511628211ull;
+    c->hash = hash;
+}
+
+/// @brief Doubles the hash table of a level
+static void countGrowTable(CountLevel_t* level) {
+    uint32_t size = level->table_size ? 2*level->table_size : 1024;
+    uint32_t* table = calloc(size, sizeof(uint32_t));
+    for (uint32_t i = 0; i < level->size; i++) {
+        uint32_t slot = level->configs[i].hash & (size-1);
+        while (table[slot]) slot = (slot+1) & (size-1);
+        table[slot] = i+1;
+    }
+    free(level->table);
+    level->table = table;
+    level->table_size = size;
+}
+
+/// @brief Adds the computations of a configuration to a level, merging them with an equal configuration
+/// The level takes the tape cells of the configuration
+static void countAdd(CountLevel_t* level, CountConfig_t* c, BigCount_t* paths) {
+    if (2*(level->size+1) > level->table_size) countGrowTable(level);
+    uint32_t slot = c->hash & (level->table_size-1);
+    while (level->table[slot]) {
+        CountConfig_t* other = &level->configs[level->table[slot]-1];
+        if (other->hash == c->hash && other->state == c->state && other->head == c->head &&
+            other->length == c->length && memcmp(other->cells, c->cells, c->length) == 0) {
+            bigAdd(&other->paths, paths);
+            free(c->cells);
+            return;
+        }
+        slot = (slot+1) & (level->table_size-1);
+    }
+    if (level->size == level->capacity) {
+        level->capacity = level->capacity ? 2*level->capacity : 1024;
+        level->configs = realloc(level->configs, level->capacity*sizeof(CountConfig_t));
+    }
+    c->paths = bigCopy(paths);
+    level->configs[level->size] = *c;
+    level->table[slot] = ++level->size;
+}
+
+/// @brief Deallocates every configuration of a level, keeping its memory for the next level
+static void countClear(CountLevel_t* level) {
+    for (uint32_t i = 0; i < level->size; i++) {
+        free(level->configs[i].cells);
+        free(level->configs[i].paths.limbs);
+    }
+    level->size = 0;
+    if (level->table!=NULL) memset(level->table, 0, level->table_size*sizeof(uint32_t));
+}
+
+/// @brief Counts the accepting, stopped and running computations of a NDTM within a step bound
+/// The frontier advances level by level: every configuration of a level applies each of its
+/// valid moves, and equal configurations of the next level are merged into a single one with
+/// the sum of their computations, so time and memory grow with the number of distinct
+/// configurations instead of the number of computations. A computation ends when it reaches
+/// an accept state or has no valid move, like NDTM branches
+/// @param t        TM_t object with the automaton, tape and head of the NDTM
+/// @param steps    Step bound
+/// @return         Count Report (free with countReportFree)
+CountReport_t countPaths(TM_t* t, uint64_t steps) {
+    CountReport_t report;
+    CountLevel_t levels[2];
+    CountConfig_t c;
+    BigCount_t one = {malloc(sizeof(uint32_t)), 1, 1};
+    memset(&report, 0, sizeof(report));
+    memset(levels, 0, sizeof(levels));
+    one.limbs[0] = 1;
+    c.state = t->current_state - t->states;
+    c.head = t->head;
+    c.length = strlen((char*)t->tape);
+    c.cells = malloc(c.length+1);
+    memcpy(c.cells, t->tape, c.length);
+    countCanonical(&c);
+    countAdd(&levels[0], &c, &one);
+    for (uint64_t level = 0; levels[level&1].size; level++) {
+        CountLevel_t* current = &levels[level&1];
+        CountLevel_t* next = &levels[(level+1)&1];
+        report.levels = level;
+        report.configs_last = current->size;
+        if (current->size > report.configs_max) report.configs_max = current->size;
+        for (uint32_t i = 0; i < current->size; i++) {
+            CountConfig_t* config = &current->configs[i];
+            State_t* state = &t->states[config->state];
+            uint8_t symbol = config->cells[config->head];
+            uint8_t moved = 0;
+            if (state->type == STATE_ACCEPT) {
+                bigAdd(&report.accepted, &config->paths);
+                continue;
+            }
+            for (Move_t* m = moveIndexFind(t->index, state, symbol); m != NULL; m = moveIndexNext(t->index, m)) {
+                moved = 1;
+                if (level == steps) break;
+                // one blank cell on each side is enough for a single move
+                CountConfig_t s;
+                s.state = m->new_state - t->states;
+                s.length = config->length+2;
+                s.cells = malloc(s.length);
+                s.cells[0] = ' ';
+                memcpy(s.cells+1, config->cells, config->length);
+                s.cells[s.length-1] = ' ';
+                s.head = config->head+1;
+                s.cells[s.head] = m->write_symbol;
+                if (m->head_move == MOVE_LEFT) s.head--;
+                if (m->head_move == MOVE_RIGHT) s.head++;
+                countCanonical(&s);
+                countAdd(next, &s, &config->paths);
+            }
+            if (!moved) bigAdd(&report.stopped, &config->paths);
+            else if (level == steps) bigAdd(&report.running, &config->paths);
+        }
+        countClear(current);
+    }
+    for (uint8_t i = 0; i < 2; i++) {
+        countClear(&levels[i]);
+        free(levels[i].configs);
+        free(levels[i].table);
+    }
+    free(one.limbs);
+    return report;
+}
+
+/// @brief Writes a path count report
+/// @param file     Output File
+/// @param report   Count Report
+/// @param steps    Step bound
+void countReportPrint(FILE* file, CountReport_t* report, uint64_t steps) {
+    BigCount_t halting = bigCopy(&report->accepted);
+    bigAdd(&halting, &report->stopped);
+    fprintf(file, "Computations within %llu steps (deepest level %llu)\n", (unsigned long long)steps, (unsigned long long)report->levels);
+    fprintf(file, "  Accepting      ");
+    bigPrint(file, &report->accepted);
+    fprintf(file, "\n  Stopped        ");
+    bigPrint(file, &report->stopped);
+    fprintf(file, "\n  Halting        ");
+    bigPrint(file, &halting);
+    fprintf(file, "\n  Running        ");
+    bigPrint(file, &report->running);
+    fprintf(file, "\nDistinct configurations: %u in the largest level, %u in the last level\n", report->configs_max, report->configs_last);
+    free(halting.limbs);
+}
+
+/// @brief Deallocates the counters of a report
+/// @param report Count Report returned by countPaths
+void countReportFree(CountReport_t* report) {
+    free(report->accepted.limbs);
+    free(report->stopped.limbs);
+    free(report->running.limbs);
+}
@@ -0,0 +1,197 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <debugger.h>
+#include <io.h>
+
+#define DEBUG_GROW_LEFT     (uint8_t) 1
+#define DEBUG_GROW_RIGHT    (uint8_t) 2
+
+/// @brief Saves the current configuration if it is the first visit of a snapshot step
+static void debugSnapshot(Debugger_t* d) {
+    if (d->step%DEBUG_SNAPSHOT_STEPS!=0 || d->step/DEBUG_SNAPSHOT_STEPS!=d->snapshots_size) return;
+    d->snapshots = realloc(d->snapshots,(d->snapshots_size+1)*sizeof(DebugSnapshot_t));
+    DebugSnapshot_t* s = &d->snapshots[d->snapshots_size++];
+    memcpy(s->cells,d->cells+d->start,d->length);
+    s->length = d->length;
+    s->head = d->head;
+    s->state = d->state-d->t->states;
+}
+
+/// @brief Loads a snapshot, the undo log starts empty from it
+static void debugRestore(Debugger_t* d, uint32_t k) {
+    DebugSnapshot_t* s = &d->snapshots[k];
+    memset(d->cells,' ',DEBUG_CELLS);
+    d->start = DEBUG_MARGIN;
+    memcpy(d->cells+d->start,s->cells,s->length);
+    d->length = s->length;
+    d->head = s->head;
+    d->state = &d->t->states[s->state];
+    d->step = (uint64_t)k*DEBUG_SNAPSHOT_STEPS;
+    d->log_size = 0;
+}
+
+/// @brief Creates a debugger at the current configuration of a DTM, working on its own copy of the tape
+/// @param t    TM_t object with the tape, head, current state and automaton to be debugged
+/// @return     Debugger_t*
+Debugger_t* debugCreate(TM_t* t) {
+    Debugger_t* d = calloc(1,sizeof(Debugger_t));
+    d->t = t;
+    memset(d->cells,' ',DEBUG_CELLS);
+    d->start = DEBUG_MARGIN;
+    d->length = strlen((char*)t->tape);
+    memcpy(d->cells+d->start,t->tape,d->length);
+    d->head = t->head;
+    d->state = t->current_state;
+    d->base = t->steps;
+    d->log = malloc(DEBUG_LOG_STEPS*sizeof(DebugUndo_t));
+    debugSnapshot(d);
+    return d;
+}
+
+/// @brief Deallocates a debugger, the debugged TM is not changed
+/// @param d Debugger_t*
+void debugFree(Debugger_t* d) {
+    free(d->log);
+    free(d->snapshots);
+    free(d);
+}
+
+/// @brief Runs a step forward, recording how to undo it
+/// @param d    Debugger_t*
+/// @return     0, if valid state transition
+///             1, if DTM is in a Valid Accept State
+///             2, if DTM stops
+///             7, if its tape would be longer than 255 cells (the step is not run)
+uint8_t debugStep(Debugger_t* d) {
+    if (d->state->type==STATE_ACCEPT) return STATUS_ACCEPT;
+    Move_t* m = findValidMove(d->cells+d->start,d->head,d->t->moves,d->t->moves_size,d->state,d->t->index);
+    if (m==NULL) return STATUS_NOMOVE;
+    uint8_t growth = 0;
+    if (m->head_move==MOVE_LEFT && d->head==0) growth = DEBUG_GROW_LEFT;
+    if (m->head_move==MOVE_RIGHT && d->head==d->length-1) growth = DEBUG_GROW_RIGHT;
+    if (growth && d->length==UINT8_MAX) return STATUS_FULL;
+    DebugUndo_t* e = &d->log[d->log_next];
+    e->head = d->head;
+    e->symbol = d->cells[d->start+d->head];
+    e->state = d->state-d->t->states;
+    e->growth = growth;
+    d->log_next = (d->log_next+1)%DEBUG_LOG_STEPS;
+    if (d->log_size<DEBUG_LOG_STEPS) d->log_size++;
+    d->cells[d->start+d->head] = m->write_symbol;
+    d->state = m->new_state;
+    if (growth==DEBUG_GROW_LEFT) {d->start--; d->head++;}
+    if (growth) d->length++;
+    moveHead(&d->head,m->head_move);
+    d->step++;
+    debugSnapshot(d);
+    return STATUS_SGMOVE;
+}
+
+/// @brief Undoes the last step with the undo log
+/// @param d    Debugger_t*
+/// @return     1 if a step was undone, 0 if the log is empty (see debugJump for older steps)
+uint8_t debugBack(Debugger_t* d) {
+    if (d->log_size==0) return 0;
+    d->log_next = (d->log_next+DEBUG_LOG_STEPS-1)%DEBUG_LOG_STEPS;
+    d->log_size--;
+    DebugUndo_t* e = &d->log[d->log_next];
+    // grown cells are blank again, since every later write is already undone
+    if (e->growth==DEBUG_GROW_LEFT) d->start++;
+    if (e->growth) d->length--;
+    d->head = e->head;
+    d->cells[d->start+d->head] = e->symbol;
+    d->state = &d->t->states[e->state];
+    d->step--;
+    return 1;
+}
+
+/// @brief Goes to a step: forward by running, backward by undoing when the log reaches it,
+/// from the closest snapshot before it elsewhere
+/// @param d    Debugger_t*
+/// @param step Target Step, the debugger stops earlier if the machine stops before it
+void debugJump(Debugger_t* d, uint64_t step) {
+    if (step<d->step && d->step-step>d->log_size) debugRestore(d,step/DEBUG_SNAPSHOT_STEPS);
+    while (d->step>step) debugBack(d);
+    while (d->step<step && debugStep(d)==STATUS_SGMOVE);
+}
+
+/// @brief Goes back to the last step before the current one in a state
+/// Recent steps are undone with the log, older intervals between snapshots are run again
+/// from their snapshots, the latest first
+/// @param d        Debugger_t*
+/// @param state    State Pointer of the debugged automaton
+/// @return         1 if found, 0 if the state was not visited before (the debugger does not move)
+uint8_t debugLastVisit(Debugger_t* d, State_t* state) {
+    uint64_t origin = d->step;
+    while (debugBack(d)) if (d->state==state) return 1;
+    uint64_t end = d->step;
+    while (end>0) {
+        uint32_t k = (end-1)/DEBUG_SNAPSHOT_STEPS;
+        uint64_t found = UINT64_MAX;
+        debugRestore(d,k);
+        while (d->step<end) {
+            if (d->state==state) found = d->step;
+            if (debugStep(d)!=STATUS_SGMOVE) break;
+        }
+        if (found!=UINT64_MAX) {
+            debugJump(d,found);
+            return 1;
+        }
+        end = (uint64_t)k*DEBUG_SNAPSHOT_STEPS;
+    }
+    debugJump(d,origin);
+    return 0;
+}
+
+/// @brief Prints the current step, state and tape
+/// @param d Debugger_t*
+void debugPrint(Debugger_t* d) {
+    uint8_t tape[UINT8_MAX+1];
+    memcpy(tape,d->cells+d->start,d->length);
+    tape[d->length] = 0;
+    printf("Step %llu, state %s\n",(unsigned long long)(d->base+d->step),d->state->name);
+    printTape(tape,d->head);
+    Move_t* m = findValidMove(tape,d->head,d->t->moves,d->t->moves_size,d->state,d->t->index);
+    if (d->state->type==STATE_ACCEPT) printTMStatus(STATUS_ACCEPT);
+    else if (m==NULL) printTMStatus(STATUS_NOMOVE);
+    else if (d->length==UINT8_MAX && ((m->head_move==MOVE_LEFT && d->head==0) || (m->head_move==MOVE_RIGHT && d->head==d->length-1))) printTMStatus(STATUS_FULL);
+}
+
+/// @brief Reads debugger commands until quit or the end of the input, printing the configuration after each one
+/// @param d        Debugger_t*
+/// @param input    Command Stream
+void debugRepl(Debugger_t* d, FILE* input) {
+    char line[MAX_DEBUG_LINE];
+    debugPrint(d);
+    while (printf("(debug) "), fflush(stdout), fgets(line,sizeof(line),input)!=NULL) {
+        char command[MAX_DEBUG_LINE] = "", argument[MAX_DEBUG_LINE] = "";
+        int fields = sscanf(line,"%s %s",command,argument);
+        if (fields<1) continue;
+        uint64_t value = (fields>1) ? strtoull(argument,NULL,10) : 1;
+        if (strcmp(command,"q")==0 || strcmp(command,"quit")==0) break;
+        if (strcmp(command,"s")==0 || strcmp(command,"step")==0) {
+            while (value-- && debugStep(d)==STATUS_SGMOVE);
+        } else if (strcmp(command,"b")==0 || strcmp(command,"back")==0) {
+            debugJump(d,value>d->step ? 0 : d->step-value);
+        } else if (strcmp(command,"j")==0 || strcmp(command,"jump")==0) {
+            if (fields<2) {printf("Usage: jump <step>\n"); continue;}
+            debugJump(d,value>d->base ? value-d->base : 0);
+        } else if (strcmp(command,"c")==0 || strcmp(command,"continue")==0) {
+            while (debugStep(d)==STATUS_SGMOVE);
+        } else if (strcmp(command,"l")==0 || strcmp(command,"last")==0) {
+            State_t* state = NULL;
+            for (uint32_t k = 0; k < d->t->states_size; k++) if (strcmp((char*)d->t->states[k].name,argument)==0) state = &d->t->states[k];
+            if (state==NULL) {printf("Usage: last <state>, with a state of the automaton\n"); continue;}
+            if (!debugLastVisit(d,state)) printf("State %s was not visited before step %llu.\n",argument,(unsigned long long)(d->base+d->step));
+        } else if (strcmp(command,"p")!=0 && strcmp(command,"print")!=0) {
+            printf("Commands: step [n], back [n], jump <step>, continue, last <state>, print, quit\n");
+            continue;
+        }
+        debugPrint(d);
+    }
+}
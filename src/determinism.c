@@ -0,0 +1,76 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <determinism.h>
+#include <alphabet.h>
+
+/// @brief Writes the read symbols of a move, one per tape
+static void determinismPrintSymbols(FILE* file, uint64_t read_key, uint8_t tapes_number) {
+    for (uint8_t k = 0; k < tapes_number; k++) {
+        fprintf(file, "%s'", k ? "," : "");
+        alphabetPut(file, (uint8_t)(read_key>>(8*k)));
+        fputc('\'', file);
+    }
+}
+
+/// @brief Orders moves by state name and read symbols, moves of the same pair stay in definition order
+static int determinismCompare(const void* x, const void* y) {
+    const Move_t* a = *(Move_t* const*)x;
+    const Move_t* b = *(Move_t* const*)y;
+    int order = strcmp((const char*)a->current_state->name, (const char*)b->current_state->name);
+    if (order) return order;
+    if (a->read_key!=b->read_key) return (a->read_key<b->read_key) ? -1 : 1;
+    return (a<b) ? -1 : (a>b);
+}
+
+/// @brief 1 if two moves have the same state and read symbols
+static uint8_t determinismSamePair(const Move_t* a, const Move_t* b) {
+    return a->read_key==b->read_key && !strcmp((const char*)a->current_state->name, (const char*)b->current_state->name);
+}
+
+/// @brief Orders conflicts by the definition order of their first move
+static int determinismCompareFirst(const void* x, const void* y) {
+    const Move_t* a = **(Move_t** const*)x;
+    const Move_t* b = **(Move_t** const*)y;
+    return (a<b) ? -1 : (a>b);
+}
+
+/// @brief Finds every (state, read symbols) pair with more than one move
+/// Moves leaving accept states are ignored, since machines stop as soon as they accept.
+/// Each conflict is written with the script lines of its moves, in definition order
+/// (DTMs apply the first one). Moves are sorted by pair, so large automata are checked in O(n log n)
+/// @param a    AutomataParser_t object
+/// @param file Output File for the conflict list, NULL to only count them
+/// @return     Number of (state, read symbols) pairs with more than one move, zero if the automaton is deterministic
+uint32_t determinismConflicts(AutomataParser_t a, FILE* file) {
+    uint32_t conflicts = 0;
+    Move_t** sorted = malloc((a.moves_size+1)*sizeof(Move_t*));
+    for (uint32_t i = 0; i < a.moves_size; i++) sorted[i] = &a.moves[i];
+    qsort(sorted, a.moves_size, sizeof(Move_t*), determinismCompare);
+    // first element of every pair with more than one move
+    Move_t*** pairs = malloc((a.moves_size+1)*sizeof(Move_t**));
+    for (uint32_t i = 0; i < a.moves_size; ) {
+        uint32_t j = i+1;
+        while (j < a.moves_size && determinismSamePair(sorted[i], sorted[j])) j++;
+        if (j-i>1 && sorted[i]->current_state->type!=STATE_ACCEPT) pairs[conflicts++] = &sorted[i];
+        i = j;
+    }
+    qsort(pairs, conflicts, sizeof(Move_t**), determinismCompareFirst);
+    for (uint32_t c = 0; c < conflicts && file!=NULL; c++) {
+        Move_t** pair = pairs[c];
+        Move_t* m = pair[0];
+        fprintf(file, "State %s reading ", m->current_state->name);
+        determinismPrintSymbols(file, m->read_key, a.tapes_number);
+        fprintf(file, " has moves in lines %u", m->line_number);
+        for (Move_t** other = pair+1; other < sorted+a.moves_size && determinismSamePair(*other, m); other++)
+            fprintf(file, ", %u", (*other)->line_number);
+        fprintf(file, "\n");
+    }
+    free(pairs);
+    free(sorted);
+    return conflicts;
+}
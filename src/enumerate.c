@@ -0,0 +1,206 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <enumerate.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+/// @brief Reads an enumeration given as ALPHABET:MAXLEN, like 01:12 or ab#:6
+/// The alphabet is written like a tape (UTF-8 characters and [names] of the script), repeated symbols are dropped
+/// @param text     Enumeration Text, the length follows the last colon
+/// @param alphabet Alphabet_t* of the script, NULL if every symbol is a single character
+/// @param report   Output Report with the symbols, the longest input length and the number of inputs
+/// @return         0 if valid, -1 for an invalid text, -2 for more than 2^64 - 1 inputs
+int8_t enumerateParse(const char* text, Alphabet_t* alphabet, EnumerateReport_t* report) {
+    memset(report, 0, sizeof(EnumerateReport_t));
+    const char* colon = strrchr(text, ':');
+    if (colon==NULL || colon==text || colon-text>=256) return -1;
+    char* end_ptr;
+    long length = strtol(colon+1, &end_ptr, 10);
+    if (end_ptr==colon+1 || *end_ptr!=0 || length<0 || length>ENUMERATE_LENGTH_MAX) return -1;
+    uint8_t symbols[256], cells[256];
+    memcpy(symbols, text, colon-text);
+    symbols[colon-text] = 0;
+    if (alphabet!=NULL) {
+        if (alphabetEncode(alphabet, symbols, cells)<0) return -1;
+    } else strcpy((char*)cells, (char*)symbols);
+    uint8_t seen[256] = {0};
+    for (uint8_t* c = cells; *c; c++) {
+        if (seen[*c]) continue;
+        seen[*c] = 1;
+        report->symbols[report->symbols_size++] = *c;
+    }
+    report->max_length = length;
+    // inputs of every length up to the longest one, the empty input included
+    uint64_t count = 1;
+    report->inputs = 1;
+    for (long l = 1; l <= length; l++) {
+        if (count>UINT64_MAX/report->symbols_size) return -2;
+        count *= report->symbols_size;
+        if (report->inputs>UINT64_MAX-count) return -2;
+        report->inputs += count;
+    }
+    return 0;
+}
+
+/// @brief Writes the input of an index in shortlex order as symbol indexes
+/// @param report   Report with the symbols
+/// @param index    Input Index
+/// @param digits   Output symbol indexes
+/// @return         Input Length
+static uint8_t enumerateDecode(EnumerateReport_t* report, uint64_t index, uint8_t* digits) {
+    uint8_t length = 0;
+    uint64_t count = 1;
+    while (index>=count) {
+        index -= count;
+        count *= report->symbols_size;
+        length++;
+    }
+    for (uint8_t k = length; k > 0; k--) {
+        digits[k-1] = index % report->symbols_size;
+        index /= report->symbols_size;
+    }
+    return length;
+}
+
+/// @brief Goes to the next input in shortlex order, the first input one symbol longer after the last input of a length
+static void enumerateNext(EnumerateReport_t* report, uint8_t* digits, uint8_t* length) {
+    for (uint8_t k = *length; k > 0; k--) {
+        if (++digits[k-1]<report->symbols_size) return;
+        digits[k-1] = 0;
+    }
+    digits[(*length)++] = 0;
+}
+
+/// @brief Runs a DTM on an input written at the start of a window of cells with the head on its first cell
+/// An empty input is a single blank cell
+/// @param t            TM_t object with the automaton
+/// @param cells        Buffer of ENUMERATE_CELLS cells, the input starts at ENUMERATE_MARGIN
+/// @param length       Input Length
+/// @param max_steps    Step bound
+/// @return             STATUS_ACCEPT, STATUS_NOMOVE, STATUS_FULL or STATUS_SGMOVE (still running)
+static uint8_t enumerateRun(TM_t* t, uint8_t* cells, uint32_t length, uint64_t max_steps) {
+    uint32_t start = ENUMERATE_MARGIN, head = 0;
+    State_t* current = t->current_state;
+    if (length==0) length = 1;
+    for (uint64_t steps = 0; steps < max_steps; steps++) {
+        if (current->type==STATE_ACCEPT) return STATUS_ACCEPT;
+        Move_t* m = findValidMove(cells+start, head, t->moves, t->moves_size, current, t->index);
+        if (m==NULL) return STATUS_NOMOVE;
+        uint8_t grow_left = (m->head_move==MOVE_LEFT && head==0);
+        uint8_t grow_right = (m->head_move==MOVE_RIGHT && head==length-1);
+        // longer tapes than DTM engines support
+        if ((grow_left || grow_right) && length==UINT8_MAX) return STATUS_FULL;
+        cells[start+head] = m->write_symbol;
+        current = m->new_state;
+        if (grow_left) {start--; head++; length++;}
+        if (grow_right) length++;
+        if (m->head_move==MOVE_LEFT) head--;
+        if (m->head_move==MOVE_RIGHT) head++;
+    }
+    return (current->type==STATE_ACCEPT) ? STATUS_ACCEPT : STATUS_SGMOVE;
+}
+
+/// @brief Runs a DTM on every input up to a length, in shortlex order
+/// Inputs are never stored: each worker thread (OpenMP builds) takes chunks of ENUMERATE_CHUNK consecutive inputs,
+/// decodes the first one from its index and steps to the next ones like a counter, writing them in its own tape window
+/// @param t            TM_t object with the automaton, its tape is not used
+/// @param report       Report from enumerateParse, counters are written to it
+/// @param max_steps    Step bound of every input
+/// @param threads      Number of threads
+void enumerateInputs(TM_t* t, EnumerateReport_t* report, uint64_t max_steps, uint32_t threads) {
+    uint64_t chunks = report->inputs/ENUMERATE_CHUNK + (report->inputs%ENUMERATE_CHUNK!=0);
+    report->max_steps = max_steps;
+    (void)threads;
+#ifdef OPENMP
+    #pragma omp parallel num_threads(threads)
+#endif
+    {
+        uint8_t* cells = malloc(ENUMERATE_CELLS);
+        uint8_t digits[ENUMERATE_LENGTH_MAX+1], length;
+        uint64_t accepted[ENUMERATE_LENGTH_MAX+1] = {0}, rejected[ENUMERATE_LENGTH_MAX+1] = {0};
+        uint64_t full[ENUMERATE_LENGTH_MAX+1] = {0}, looping[ENUMERATE_LENGTH_MAX+1] = {0};
+        // indexes only grow in each thread, so its first accepted inputs hold the first ones of the whole run
+        uint64_t listed[ENUMERATE_LIST_MAX];
+        uint32_t listed_size = 0;
+#ifdef OPENMP
+        #pragma omp for schedule(dynamic, 1)
+#endif
+        for (uint64_t c = 0; c < chunks; c++) {
+            uint64_t first = c*ENUMERATE_CHUNK, last = first+ENUMERATE_CHUNK;
+            if (last>report->inputs) last = report->inputs;
+            length = enumerateDecode(report, first, digits);
+            for (uint64_t index = first; index < last; index++) {
+                memset(cells, ' ', ENUMERATE_CELLS);
+                for (uint8_t k = 0; k < length; k++) cells[ENUMERATE_MARGIN+k] = report->symbols[digits[k]];
+                uint8_t status = enumerateRun(t, cells, length, max_steps);
+                if (status==STATUS_ACCEPT) {
+                    accepted[length]++;
+                    if (listed_size<ENUMERATE_LIST_MAX) listed[listed_size++] = index;
+                } else if (status==STATUS_NOMOVE) rejected[length]++;
+                else if (status==STATUS_FULL) full[length]++;
+                else looping[length]++;
+                if (index+1<last) enumerateNext(report, digits, &length);
+            }
+        }
+#ifdef OPENMP
+        #pragma omp critical (enumerate)
+#endif
+        {
+            for (uint16_t l = 0; l <= report->max_length; l++) {
+                report->accepted[l] += accepted[l];
+                report->rejected[l] += rejected[l];
+                report->full[l] += full[l];
+                report->looping[l] += looping[l];
+            }
+            // keeps the lowest indexes of every thread
+            for (uint32_t k = 0; k < listed_size; k++) {
+                uint32_t position = report->listed_size;
+                while (position>0 && report->listed[position-1]>listed[k]) position--;
+                if (position>=ENUMERATE_LIST_MAX) continue;
+                uint32_t moved = (report->listed_size<ENUMERATE_LIST_MAX) ? report->listed_size-position : ENUMERATE_LIST_MAX-1-position;
+                memmove(&report->listed[position+1], &report->listed[position], moved*sizeof(uint64_t));
+                report->listed[position] = listed[k];
+                if (report->listed_size<ENUMERATE_LIST_MAX) report->listed_size++;
+            }
+        }
+        free(cells);
+    }
+}
+
+/// @brief Writes the accepted, rejected, tape full and looping inputs of every length and the first accepted inputs
+/// @param file     Output File
+/// @param report   Report given to enumerateInputs
+void enumerateReportPrint(FILE* file, EnumerateReport_t* report) {
+    uint64_t accepted = 0, rejected = 0, full = 0, looping = 0;
+    uint8_t digits[ENUMERATE_LENGTH_MAX+1];
+    fprintf(file, "Inputs over \"");
+    for (uint16_t k = 0; k < report->symbols_size; k++) alphabetPut(file, report->symbols[k]);
+    fprintf(file, "\" up to length %u: %llu (at most %llu steps each)\n", report->max_length,
+            (unsigned long long)report->inputs, (unsigned long long)report->max_steps);
+    fprintf(file, "  Length       Accepted       Rejected      Tape full        Looping\n");
+    for (uint16_t l = 0; l <= report->max_length; l++) {
+        fprintf(file, "  %6u %14llu %14llu %14llu %14llu\n", l, (unsigned long long)report->accepted[l],
+                (unsigned long long)report->rejected[l], (unsigned long long)report->full[l], (unsigned long long)report->looping[l]);
+        accepted += report->accepted[l];
+        rejected += report->rejected[l];
+        full += report->full[l];
+        looping += report->looping[l];
+    }
+    fprintf(file, "  Total  %14llu %14llu %14llu %14llu\n", (unsigned long long)accepted, (unsigned long long)rejected,
+            (unsigned long long)full, (unsigned long long)looping);
+    if (report->listed_size==0) return;
+    if (accepted>report->listed_size) fprintf(file, "First %u accepted inputs:\n", report->listed_size);
+    else fprintf(file, "Accepted inputs:\n");
+    for (uint32_t k = 0; k < report->listed_size; k++) {
+        uint8_t length = enumerateDecode(report, report->listed[k], digits);
+        fprintf(file, "  \"");
+        for (uint8_t j = 0; j < length; j++) alphabetPut(file, report->symbols[digits[j]]);
+        fprintf(file, "\"\n");
+    }
+}
@@ -5,15 +5,76 @@
 
 #include <string.h>
 #include <ctype.h>
+#include <stdarg.h>
+#include <setjmp.h>
 #include <interpreter.h>
+#include <preprocessor.h>
 
 const char *STR_TAPE_DEFINITION         = "tape=";
 const char *STR_HEAD_DEFINITION         = "head=";
 const char *STR_INITIAL_STATE           = "initial_state=";
 const char *STR_ACCEPT_STATES           = "accept_states=";
+const char *STR_TAPES_NUMBER            = "tapes=";
+const char *STR_SYMBOLS                 = "symbols=";
 const char *STR_COMMENT_MARK            = "//";
 const char *INTERPRETER_ERROR_MESSAGE   = "Invalid Command in Line %i.\n";
 
+// Error recovery of the calling thread (see interpreterRecover)
+static _Thread_local jmp_buf* interpreter_recover = NULL;
+static _Thread_local char* interpreter_messages = NULL;
+static _Thread_local size_t interpreter_messages_size = 0;
+// path of the script parsed by parseFile, included files are found from its directory
+static _Thread_local const char* interpreter_filename = NULL;
+// script opened by parseFile and preprocessor of the script being parsed, closed when an error jumps back
+static _Thread_local FILE* interpreter_file = NULL;
+static _Thread_local Preprocessor_t* interpreter_pp = NULL;
+// allocations of the script being parsed (see ParseState_t)
+typedef struct ParseState ParseState_t;
+static _Thread_local ParseState_t* interpreter_parse = NULL;
+static void parseStateFree(ParseState_t* s);
+
+/// @brief Makes interpreter errors of the calling thread recoverable
+/// By default, the interpreter prints its messages and exits program on invalid scripts.
+/// While a recovery point is set, messages are written to a buffer and errors jump back to it,
+/// so the interpreter can be used by programs that must not exit
+/// @param recover  jmp_buf set with setjmp by the caller, NULL to restore the default behavior
+/// @param messages Output buffer with the interpreter messages
+/// @param size     Output buffer length
+void interpreterRecover(jmp_buf* recover, char* messages, size_t size) {
+    interpreter_recover = recover;
+    interpreter_messages = messages;
+    interpreter_messages_size = size;
+    if (messages!=NULL && size>0) messages[0] = 0;
+}
+
+/// @brief Prints an interpreter message, or appends it to the recovery messages buffer
+/// @param format printf format string
+void interpreterMessage(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    if (interpreter_recover!=NULL && interpreter_messages!=NULL) {
+        size_t length = strlen(interpreter_messages);
+        if (length+1 < interpreter_messages_size) vsnprintf(interpreter_messages+length, interpreter_messages_size-length, format, args);
+    } else vprintf(format, args);
+    va_end(args);
+}
+
+/// @brief Stops the interpreter on an invalid script: jumps back to the recovery point
+/// of the calling thread if there is one, exits program elsewhere
+void interpreterExit() {
+    if (interpreter_recover!=NULL) {
+        // long running callers (serve, libtmsim) would run out of file descriptors and memory
+        if (interpreter_parse!=NULL) parseStateFree(interpreter_parse);
+        interpreter_parse = NULL;
+        preprocessorFree(interpreter_pp);
+        interpreter_pp = NULL;
+        if (interpreter_file!=NULL) fclose(interpreter_file);
+        interpreter_file = NULL;
+        longjmp(*interpreter_recover, 1);
+    }
+    exit(1);
+}
+
 /// @brief Reads a file in disk and parses what is written to a Parser_t object
 /// in order to generate Turing Machines Simulations in later phases
 /// Exits Program if it finds invalid syntax
@@ -24,10 +85,327 @@ Parser_t parseFile(const int8_t *filename) {
     // reads text file
     FILE *file = fopen(filename, "r");
     if (file == NULL) {
-        fprintf(stderr, "Error opening file %s\n", filename);
-        exit(1);
+        if (interpreter_recover==NULL) fprintf(stderr, "Error opening file %s\n", filename);
+        else interpreterMessage("Error opening file %s\n", filename);
+        interpreterExit();
+    }
+    interpreter_filename = (const char*)filename;
+    interpreter_file = file;
+    Parser_t parser = parseStream(file);
+    interpreter_file = NULL;
+    fclose(file);
+    return parser;
+}
+
+/// @brief Symbol of a move field: a single character, a UTF-8 character or a declared [name]
+/// Empty fields and fields with other text are blank cells
+/// @param alphabet Alphabet_t* of the script
+/// @param field    Field text, not ending with 0
+/// @param length   Field Length
+/// @return         Cell code
+static uint8_t parseSymbol(Alphabet_t* alphabet, const uint8_t* field, uint8_t length) {
+    if (length==1) {
+        if (field[0]<0x80) alphabet->literal[field[0]] = 1;
+        return field[0];
     }
+    if (length<2) return ' ';
+    uint8_t text[ALPHABET_NAME_MAX+1], symbol_length;
+    if (length>ALPHABET_NAME_MAX) return ' ';
+    memcpy(text,field,length);
+    text[length] = 0;
+    int16_t code = alphabetSymbol(alphabet,text,&symbol_length);
+    if (code<0 || symbol_length!=length) return ' ';
+    return code;
+}
+
+/// @brief Moves of a script being parsed
+typedef struct {
+    MoveParser_t* moves;
+    uint32_t size;
+    /// @brief Moves reading *, expanded after the last line for every symbol without another move from their state
+    MoveParser_t* templates;
+    uint32_t templates_size;
+} MoveTable_t;
+
+/// @brief Open addressing table of state names, so states are found by name without comparing every state
+typedef struct {
+    /// @brief State index plus one of every slot, 0 for a free slot
+    uint32_t* slots;
+    /// @brief Number of slots - 1, a power of two minus one
+    uint32_t mask;
+} StateNames_t;
+
+/// @brief Allocations of the script being parsed by parseStream and of the states found by parserToAutomata
+/// An error jumping back releases them (see interpreterExit), members not allocated yet are NULL
+struct ParseState {
+    MoveTable_t table;
+    uint8_t* tape_heads;
+    uint8_t* initial_state_name;
+    uint8_t** tape_string_names;
+    uint32_t tape_string_name_index;
+    uint8_t** accept_states_names;
+    uint8_t accept_states_size;
+    Alphabet_t* alphabet;
+    State_t* states;
+    uint32_t states_size;
+    uint32_t* current_states;
+    uint32_t* new_states;
+    StateNames_t names;
+};
+
+/// @brief Deallocates every member of a ParseState_t
+static void parseStateFree(ParseState_t* s) {
+    for (uint32_t i = 0; i < s->table.size; i++) {
+        free(s->table.moves[i].current_state_name);
+        free(s->table.moves[i].new_state_name);
+    }
+    free(s->table.moves);
+    for (uint32_t i = 0; i < s->table.templates_size; i++) {
+        free(s->table.templates[i].current_state_name);
+        free(s->table.templates[i].new_state_name);
+    }
+    free(s->table.templates);
+    for (uint32_t i = 0; i < s->tape_string_name_index; i++) free(s->tape_string_names[i]);
+    free(s->tape_string_names);
+    free(s->tape_heads);
+    free(s->initial_state_name);
+    for (uint8_t i = 0; i < s->accept_states_size; i++) free(s->accept_states_names[i]);
+    free(s->accept_states_names);
+    alphabetFree(s->alphabet);
+    for (uint32_t i = 0; i < s->states_size; i++) free(s->states[i].name);
+    free(s->states);
+    free(s->current_states);
+    free(s->new_states);
+    free(s->names.slots);
+}
 
+/// @brief Creates a state names table for a number of states
+static void stateNamesCreate(StateNames_t* names, uint32_t states_size) {
+    uint32_t slots = 8;
+    while (slots < 2*(uint64_t)states_size) slots *= 2;
+    names->slots = calloc(slots, sizeof(uint32_t));
+    names->mask = slots-1;
+}
+
+/// @brief Slot of a state name: the slot of the state with the name, or the free slot where it goes
+/// @param names    State names table
+/// @param states   States of the table
+/// @param name     State Name
+/// @return         Slot pointer, 0 if the state is not in the table
+static uint32_t* stateNamesSlot(StateNames_t* names, State_t* states, const uint8_t* name) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const uint8_t* c = name; *c; c++) hash = (hash ^ *c) * 16777619u;
+    uint32_t slot = hash & names->mask;
+    while (names->slots[slot]!=0 && strcmp(states[names->slots[slot]-1].name,name)!=0) slot = (slot+1) & names->mask;
+    return &names->slots[slot];
+}
+
+/// @brief Parses a move line and appends it to the moves of the script, or to its * templates
+/// Exits Program if it finds invalid syntax (see interpreterRecover)
+/// @param line_buffer  Move line without whitespaces
+/// @param line_number  Script Line Number
+/// @param tapes_number Number of tapes of the script
+/// @param alphabet     Alphabet_t* of the script
+/// @param table        Moves of the script
+static void parseMove(char* line_buffer, uint32_t line_number, uint8_t tapes_number, Alphabet_t* alphabet, MoveTable_t* table) {
+    // Initialize comma count for iteration line
+    uint8_t comma_count;
+    // Initialize string comma positions
+    uint8_t comma_position[MAX_COMMAS+1];
+
+    // count commas in buffer
+    countCommas(line_buffer,comma_position,&comma_count);
+
+    // a move has a current state, k read symbols, k write symbols, k head moves and a new state
+    if (comma_count!=3*tapes_number+1) {
+        errorLineMessage(line_number);
+        if (tapes_number>1) interpreterMessage("Moves of %u tapes must have %u fields.\n",tapes_number,3*tapes_number+2);
+        interpreterExit();
+    }
+
+    // Command Lines here
+    for (uint8_t k = 0; k < tapes_number; k++) {
+        uint8_t head_field = 2*tapes_number+k;
+        if (comma_position[head_field+1]-comma_position[head_field]!=2) {
+            errorLineMessage(line_number);
+            interpreterMessage("Head movement must have a single character length.\n");
+            interpreterExit();
+        }
+        uint8_t move_char = (uint8_t)line_buffer[comma_position[head_field]+1];
+        if ((move_char!='<')&&(move_char!='>')&&(move_char!='-')) {
+            errorLineMessage(line_number);
+            interpreterMessage("Head movement must be < (left), > (right) or - (no move).\n");
+            interpreterExit();
+        }
+    }
+
+    // Valid Command Lines here
+    // Parsing current state name string
+    uint8_t nstate_name_size, j;
+    uint8_t *cstate_name,*nstate_name,rchar[1],wchar[1],hmove;
+    cstate_name = malloc((comma_position[0]+1)*sizeof(uint8_t));
+    for (uint8_t i = 0; i<comma_position[0];i++) cstate_name[i] = line_buffer[i];
+    cstate_name[comma_position[0]]='\0';
+    
+    for (uint8_t aux = comma_position[comma_count-1]+1; line_buffer[aux]!='\0'; aux++) nstate_name_size=aux-comma_position[comma_count-1];
+    // Parsing new state name string
+    nstate_name = malloc((nstate_name_size+1)*sizeof(uint8_t));
+    j=0;
+    for (uint8_t i = comma_position[comma_count-1]+1; line_buffer[i]!='\0';i++) {
+        nstate_name[j] = line_buffer[i];
+        j++;
+    }
+    nstate_name[nstate_name_size]='\0';
+
+    // a * read symbol (single tape) is a template for the symbols without another move from the state
+    uint8_t any_symbol = (tapes_number==1 && comma_position[1]-comma_position[0]==2 && line_buffer[comma_position[0]+1]=='*');
+    MoveParser_t** moves = any_symbol ? &table->templates : &table->moves;
+    uint32_t* moves_size = any_symbol ? &table->templates_size : &table->size;
+    *moves = realloc(*moves,(++(*moves_size))*sizeof(MoveParser_t));
+    MoveParser_t* move = &(*moves)[*moves_size-1];
+    // Parsing read characters, write characters and head moves of every tape
+    // empty symbol fields are blank cells
+    for (uint8_t k = 0; k < TAPES_MAX; k++) {
+        uint8_t read_field = k, write_field = tapes_number+k, head_field = 2*tapes_number+k;
+        if (k>=tapes_number) {
+            rchar[0] = ' '; wchar[0] = ' '; hmove = MOVE_WAIT;
+        } else {
+            rchar[0] = parseSymbol(alphabet,&line_buffer[comma_position[read_field]+1],comma_position[read_field+1]-comma_position[read_field]-1);
+            wchar[0] = parseSymbol(alphabet,&line_buffer[comma_position[write_field]+1],comma_position[write_field+1]-comma_position[write_field]-1);
+            if ((uint8_t)line_buffer[comma_position[head_field]+1]=='<') hmove=MOVE_LEFT;  else
+            if ((uint8_t)line_buffer[comma_position[head_field]+1]=='>') hmove=MOVE_RIGHT; else 
+            hmove=MOVE_WAIT;
+        }
+        move->read_symbols[k]=rchar[0];
+        move->write_symbols[k]=wchar[0];
+        move->head_moves[k]=hmove;
+    }
+    move->current_state_name=cstate_name;
+    move->new_state_name=nstate_name;
+    move->read_symbol=move->read_symbols[0];
+    move->write_symbol=move->write_symbols[0];
+    move->head_move=move->head_moves[0];
+    move->line_number=line_number;
+
+}
+
+/// @brief Exits Program on a {name} that is neither a foreach variable nor a define (see interpreterRecover)
+/// @param pp           Preprocessor of the script
+/// @param line_number  Script Line Number
+/// @param error        Result of preprocessorSubstitute or preprocessorDefine
+static void parseUndefined(Preprocessor_t* pp, uint32_t line_number, int8_t error) {
+    if (error!=-3) return;
+    errorLineMessage(line_number);
+    interpreterMessage("{%s} is neither a define nor a foreach variable.\n",pp->undefined);
+    interpreterExit();
+}
+
+/// @brief Expands a foreach directive: "<variable> in <list> : <body>", the body is a move or another foreach
+/// Each move is substituted and parsed straight into the moves of the script
+/// Exits Program if it finds invalid syntax (see interpreterRecover)
+/// @param pp           Preprocessor of the script
+/// @param text         Directive text after foreach
+/// @param line_number  Script Line Number
+/// @param tapes_number Number of tapes of the script
+/// @param alphabet     Alphabet_t* of the script
+/// @param table        Moves of the script
+static void parseForeach(Preprocessor_t* pp, char* text, uint32_t line_number, uint8_t tapes_number, Alphabet_t* alphabet, MoveTable_t* table) {
+    char variable[PREPROCESSOR_NAME_MAX], items[MAX_LINE_LENGTH], value[PREPROCESSOR_VALUE_MAX];
+    char substituted[MAX_LINE_LENGTH], move[MAX_LINE_LENGTH];
+    uint8_t length = 0;
+    while (isalnum((unsigned char)text[length]) || text[length]=='_') length++;
+    char* in = text+length;
+    while (isspace((unsigned char)*in)) in++;
+    char* separator = strchr(in,':');
+    if (length==0 || length>=PREPROCESSOR_NAME_MAX || isdigit((unsigned char)text[0]) || strncmp(in,"in",2)!=0 || !isspace((unsigned char)in[2]) || separator==NULL) {
+        errorLineMessage(line_number);
+        interpreterMessage("Loops must be written as foreach <variable> in <list> : <move>.\n");
+        interpreterExit();
+    }
+    memcpy(variable,text,length);
+    variable[length] = 0;
+    *separator = 0;
+    char* body = separator+1;
+    char* rest;
+    uint8_t nested = (preprocessorDirective(body,&rest)==PREPROCESSOR_FOREACH);
+    int8_t error = preprocessorSubstitute(pp,in+2,items,sizeof(items));
+    parseUndefined(pp,line_number,error);
+    if (error<0) {
+        errorLineMessage(line_number);
+        interpreterMessage("Loop list is too long or adds to a value that is not an integer.\n");
+        interpreterExit();
+    }
+    PreprocessorList_t list;
+    preprocessorListBegin(&list,items);
+    while (preprocessorListNext(&list,value)) {
+        if (preprocessorPush(pp,variable,value)<0) {
+            errorLineMessage(line_number);
+            interpreterMessage("No more than %u nested loops.\n",PREPROCESSOR_DEPTH_MAX);
+            interpreterExit();
+        }
+        if (nested) {
+            // the inner loop changes its text, every iteration starts from a copy
+            strcpy(substituted,rest);
+            parseForeach(pp,substituted,line_number,tapes_number,alphabet,table);
+        } else {
+            error = preprocessorSubstitute(pp,body,substituted,sizeof(substituted));
+            parseUndefined(pp,line_number,error);
+            if (error<0) {
+                errorLineMessage(line_number);
+                interpreterMessage("Move is too long or adds to a value that is not an integer.\n");
+                interpreterExit();
+            }
+            cleanBuffer(substituted,move);
+            if (move[0]!=0) parseMove(move,line_number,tapes_number,alphabet,table);
+        }
+        preprocessorPop(pp);
+    }
+}
+
+/// @brief Expands the * templates of a script: every symbol of its tapes and moves (blank included) without
+/// a move from the template state gets the template move, writing the read symbol if the template writes *
+/// @param table        Moves of the script
+/// @param tapes        Tape Strings of the script
+/// @param tapes_size   Number of Tape Strings
+static void parseTemplates(MoveTable_t* table, uint8_t** tapes, uint32_t tapes_size) {
+    uint8_t symbols[256] = {0};
+    symbols[' '] = 1;
+    for (uint32_t i = 0; i < tapes_size; i++) for (uint8_t* c = tapes[i]; *c; c++) symbols[*c] = 1;
+    for (uint32_t i = 0; i < table->size; i++) symbols[table->moves[i].read_symbol] = symbols[table->moves[i].write_symbol] = 1;
+    for (uint32_t i = 0; i < table->templates_size; i++) if (table->templates[i].write_symbol!='*') symbols[table->templates[i].write_symbol] = 1;
+    for (uint32_t i = 0; i < table->templates_size; i++) {
+        MoveParser_t* t = &table->templates[i];
+        // symbols already read by a move from the template state
+        uint8_t defined[256] = {0};
+        for (uint32_t k = 0; k < table->size; k++)
+            if (!strcmp(table->moves[k].current_state_name,t->current_state_name)) defined[table->moves[k].read_symbol] = 1;
+        for (uint16_t c = 1; c < 256; c++) {
+            if (!symbols[c] || defined[c]) continue;
+            defined[c] = 1;
+            table->moves = realloc(table->moves,(++table->size)*sizeof(MoveParser_t));
+            MoveParser_t* move = &table->moves[table->size-1];
+            *move = *t;
+            move->current_state_name = malloc(strlen(t->current_state_name)+1);
+            strcpy(move->current_state_name,t->current_state_name);
+            move->new_state_name = malloc(strlen(t->new_state_name)+1);
+            strcpy(move->new_state_name,t->new_state_name);
+            move->read_symbol = move->read_symbols[0] = c;
+            if (t->write_symbol=='*') move->write_symbol = move->write_symbols[0] = c;
+        }
+        free(t->current_state_name);
+        free(t->new_state_name);
+    }
+    free(table->templates);
+    table->templates = NULL;
+    table->templates_size = 0;
+}
+
+/// @brief Parses a script from an open stream, like parseFile
+/// Exits Program if it finds invalid syntax (see interpreterRecover)
+/// @param file Script Stream, it is not closed
+/// @return Parser_t file with Turing Machine Variables to Assemble TMs
+Parser_t parseStream(FILE* file) {
     Parser_t parser;
 
     uint32_t line_number = 1;
@@ -36,31 +414,66 @@ Parser_t parseFile(const int8_t *filename) {
     // line buffer without whitespaces
     char line_buffer[MAX_LINE_LENGTH];
 
-    // defining Move Parser Array
-    MoveParser_t* mparser;
-    uint8_t mparser_size=0;
-    uint8_t *tape_heads,tape_heads_index=0;
-    uint8_t *initial_state_name,tape_string_name_index=0,**tape_string_names,hmove;
-    // Parser pointers
-    uint8_t *cstate_name,*nstate_name,rchar[1],wchar[1];
-    uint8_t **accept_states_names;
-    uint8_t accept_states_size=0;
+    // moves, tapes, heads and states of the script, released by interpreterExit on errors
+    ParseState_t s = {0};
+    interpreter_parse = &s;
+    uint32_t tape_heads_index=0;
 
     uint8_t initial_state_defined = 0,accept_states_defined = 0,tape_head_defined = 0,tape_defined = 0;
+    uint8_t tapes_number = 1;
+    // UTF-8 and named symbols, kept only if the script has any
+    s.alphabet = alphabetCreate();
 
     // general purpose counters
     uint8_t i = 0, j = 0;
 
+    // defines, loops and included files
+    Preprocessor_t* pp = preprocessorCreate(file, interpreter_filename);
+    interpreter_filename = NULL;
+    interpreter_pp = pp;
+    char substituted[MAX_LINE_LENGTH];
+    char* directive_text;
+
     // iterate over textfile lines
-    while (fgets(line, sizeof(line), file) != NULL) {
+    while (preprocessorRead(pp, line, sizeof(line), &line_number) != NULL) {
         // Process each line here
 
         // Wipe Off Comments
         wipeOffSubstring(line, line, STR_COMMENT_MARK);
-        
+
+        // Preprocessor directives
+        uint8_t directive = preprocessorDirective(line, &directive_text);
+        int8_t defined = (directive==PREPROCESSOR_DEFINE) ? preprocessorDefine(pp, directive_text) : 0;
+        parseUndefined(pp, line_number, defined);
+        if (defined<0) {
+            interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+            interpreterMessage("Defines must be written as define <name> <value> (at most %u defines).\n",PREPROCESSOR_DEFINES_MAX);
+            interpreterExit();
+        }
+        if (directive==PREPROCESSOR_FOREACH) parseForeach(pp, directive_text, line_number, tapes_number, s.alphabet, &s.table);
+        if (directive==PREPROCESSOR_INCLUDE) {
+            line_number++;
+            if (preprocessorInclude(pp, directive_text, &line_number)<0) {
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number-1);
+                interpreterMessage("Included file %s can not be opened (at most %u nested includes).\n",directive_text,PREPROCESSOR_DEPTH_MAX);
+                interpreterExit();
+            }
+            continue;
+        }
+        if (directive!=PREPROCESSOR_NONE) {
+            line_number++; continue;
+        }
+        int8_t error = preprocessorSubstitute(pp, line, substituted, sizeof(substituted));
+        parseUndefined(pp, line_number, error);
+        if (error<0) {
+            interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+            interpreterMessage("Line is too long after substitutions or adds to a value that is not an integer.\n");
+            interpreterExit();
+        }
+
         // Ignore whitespaces
         // Every non-whitespace character will be copied
-        cleanBuffer(line,line_buffer);
+        cleanBuffer(substituted,line_buffer);
 
         // Checks for Empty Lines or Lines with whitespaces only
         if (line_buffer[0]==0) {
@@ -73,24 +486,24 @@ Parser_t parseFile(const int8_t *filename) {
         j = 0;
         for (uint8_t k = 0;k<255;k++) if(line_buffer[k]==0) j=1;
         if (j==0) {
-            printf("Error in Line %i\n",line_number);
-            printf("Command must not have more than 256 valid characters.\n");
-            exit(1);
+            interpreterMessage("Error in Line %i\n",line_number);
+            interpreterMessage("Command must not have more than 256 valid characters.\n");
+            interpreterExit();
         }
 
         // Check for initial state pattern
         if (strncmp(line_buffer, STR_INITIAL_STATE,strlen(STR_INITIAL_STATE)) == 0) {
             if (strlen(line_buffer)==strlen(STR_INITIAL_STATE)) {
-                printf(INTERPRETER_ERROR_MESSAGE,line_number);
-                printf("Initial State must not be empty.\n");
-                exit(1);
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Initial State must not be empty.\n");
+                interpreterExit();
             }
             if (initial_state_defined) {
-                printf("Initial State in Line %i redefinition.\n",line_number);
-                free(initial_state_name);
+                interpreterMessage("Initial State in Line %i redefinition.\n",line_number);
+                free(s.initial_state_name);
             }
-            initial_state_name = malloc((strlen(line_buffer)-strlen(STR_INITIAL_STATE)) * sizeof(uint8_t));
-            strcpy(initial_state_name, line_buffer + strlen(STR_INITIAL_STATE));
+            s.initial_state_name = malloc((strlen(line_buffer)-strlen(STR_INITIAL_STATE)+1) * sizeof(uint8_t));
+            strcpy(s.initial_state_name, line_buffer + strlen(STR_INITIAL_STATE));
             line_number++;
             initial_state_defined=1;
             continue;
@@ -99,47 +512,48 @@ Parser_t parseFile(const int8_t *filename) {
         // Check for accept states pattern
         if (strncmp(line_buffer, STR_ACCEPT_STATES,strlen(STR_ACCEPT_STATES)) == 0) {
             if (strlen(line_buffer)==strlen(STR_ACCEPT_STATES)) {
-                printf(INTERPRETER_ERROR_MESSAGE,line_number);
-                printf("Accept States Definition must not be empty.\n");
-                exit(1);
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Accept States Definition must not be empty.\n");
+                interpreterExit();
             }
             
             // drop all accept states defined before
             if (accept_states_defined) {
-                printf("Accept States in Line %i redefinition.\n",line_number);
-                free(accept_states_names);
-                accept_states_size=0;
+                interpreterMessage("Accept States in Line %i redefinition.\n",line_number);
+                for (uint8_t k = 0; k < s.accept_states_size; k++) free(s.accept_states_names[k]);
+                free(s.accept_states_names);
+                s.accept_states_size=0;
             }
 
             // allocate memory
-            accept_states_names = malloc((accept_states_size+1)*sizeof(uint8_t*));
+            s.accept_states_names = malloc((s.accept_states_size+1)*sizeof(uint8_t*));
 
             // sweep string right to left to find commas and parse accept states
             i = strlen(line_buffer)-strlen(STR_ACCEPT_STATES);
             while (i!=0) {
                 if (line_buffer[i+strlen(STR_ACCEPT_STATES)-1] == ',') {
                     if (strlen(&line_buffer[i+strlen(STR_ACCEPT_STATES)])==0) {
-                        printf(INTERPRETER_ERROR_MESSAGE,line_number);
-                        printf("Accept States Definition must not be empty.\n");
-                        exit(1);
+                        interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                        interpreterMessage("Accept States Definition must not be empty.\n");
+                        interpreterExit();
                     }
-                    accept_states_names[accept_states_size] = malloc(strlen(&line_buffer[i+strlen(STR_ACCEPT_STATES)]) + 1);
-                    strcpy(accept_states_names[accept_states_size],&line_buffer[i+strlen(STR_ACCEPT_STATES)]);
-                    accept_states_size++;
-                    accept_states_names = realloc(accept_states_names,accept_states_size*sizeof(uint8_t*));
+                    s.accept_states_names[s.accept_states_size] = malloc(strlen(&line_buffer[i+strlen(STR_ACCEPT_STATES)]) + 1);
+                    strcpy(s.accept_states_names[s.accept_states_size],&line_buffer[i+strlen(STR_ACCEPT_STATES)]);
+                    s.accept_states_size++;
+                    s.accept_states_names = realloc(s.accept_states_names,(s.accept_states_size+1)*sizeof(uint8_t*));
                     // Write 0 in comma mark to make string smaller
                     line_buffer[i+strlen(STR_ACCEPT_STATES)-1]=0;
                 }
                 i--;
             }
             if (strlen(&line_buffer[strlen(STR_ACCEPT_STATES)])==0) {
-                printf(INTERPRETER_ERROR_MESSAGE,line_number);
-                printf("Accept States Definition must not be empty.\n");
-                exit(1);
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Accept States Definition must not be empty.\n");
+                interpreterExit();
             }
-            accept_states_names[accept_states_size] = malloc(strlen(&line_buffer[strlen(STR_ACCEPT_STATES)]) + 1);
-            strcpy(accept_states_names[accept_states_size],&line_buffer[strlen(STR_ACCEPT_STATES)]);
-            accept_states_size++;
+            s.accept_states_names[s.accept_states_size] = malloc(strlen(&line_buffer[strlen(STR_ACCEPT_STATES)]) + 1);
+            strcpy(s.accept_states_names[s.accept_states_size],&line_buffer[strlen(STR_ACCEPT_STATES)]);
+            s.accept_states_size++;
             line_number++;
             accept_states_defined=1;
             continue;
@@ -148,19 +562,23 @@ Parser_t parseFile(const int8_t *filename) {
         // Check for tape definition pattern
         if (strncmp(line_buffer, STR_TAPE_DEFINITION,strlen(STR_TAPE_DEFINITION)) == 0) {
             if (strlen(line_buffer)==strlen(STR_TAPE_DEFINITION)) {
-                printf(INTERPRETER_ERROR_MESSAGE,line_number);
-                printf("Tape String must not be empty.\n");
-                exit(1);
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Tape String must not be empty.\n");
+                interpreterExit();
             }
             if (tape_defined) {
-                // printf("New Tape Definition in Line %i.\n",line_number);
-                tape_string_names = realloc(tape_string_names,(++tape_string_name_index)*sizeof(uint8_t*));
+                // interpreterMessage("New Tape Definition in Line %i.\n",line_number);
+                s.tape_string_names = realloc(s.tape_string_names,(++s.tape_string_name_index)*sizeof(uint8_t*));
                 // free(tape_string_name);
             } else {
-                tape_string_names = malloc((++tape_string_name_index)*sizeof(uint8_t*));
+                s.tape_string_names = malloc((++s.tape_string_name_index)*sizeof(uint8_t*));
+            }
+            s.tape_string_names[s.tape_string_name_index-1] = malloc((strlen(line_buffer)-strlen(STR_TAPE_DEFINITION)+1)*sizeof(uint8_t));
+            if (alphabetEncode(s.alphabet,line_buffer + strlen(STR_TAPE_DEFINITION),s.tape_string_names[s.tape_string_name_index-1])<0) {
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Tape String has an invalid UTF-8 character or too many symbols.\n");
+                interpreterExit();
             }
-            tape_string_names[tape_string_name_index-1] = malloc((strlen(line_buffer)-strlen(STR_TAPE_DEFINITION))*sizeof(uint8_t));
-            strcpy(tape_string_names[tape_string_name_index-1], line_buffer + strlen(STR_TAPE_DEFINITION));
             line_number++;
             tape_defined=1;
             continue;
@@ -170,218 +588,205 @@ Parser_t parseFile(const int8_t *filename) {
         if (strncmp(line_buffer, STR_HEAD_DEFINITION,strlen(STR_HEAD_DEFINITION)) == 0) {
             uint8_t* hd_ptr = line_buffer + strlen(STR_HEAD_DEFINITION);
             if (*hd_ptr==0) {
-                printf(INTERPRETER_ERROR_MESSAGE,line_number);
-                printf("Tape Head Index invalid.\n");
-                exit(1);
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Tape Head Index invalid.\n");
+                interpreterExit();
             }
-            if (atoi(hd_ptr)>=strlen(tape_string_names[0])) {
-                printf(INTERPRETER_ERROR_MESSAGE,line_number);
-                printf("Tape Head Index must be lesser than Tape length.\n");
-                printf("Take note that tape index is zero-based.\n");
-                exit(1);
+            if (s.tape_string_names==NULL || atoi(hd_ptr)>=strlen(s.tape_string_names[0])) {
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Tape Head Index must be lesser than Tape length.\n");
+                interpreterMessage("Take note that tape index is zero-based.\n");
+                interpreterExit();
             }
             if (tape_head_defined) {
-                // printf("New Tape Head Definition in Line %i.\n",line_number);
-                tape_heads = realloc(tape_heads,(++tape_heads_index)*sizeof(uint8_t));
+                // interpreterMessage("New Tape Head Definition in Line %i.\n",line_number);
+                s.tape_heads = realloc(s.tape_heads,(++tape_heads_index)*sizeof(uint8_t));
             } else {
-                tape_heads = malloc((++tape_heads_index)*sizeof(uint8_t));
+                s.tape_heads = malloc((++tape_heads_index)*sizeof(uint8_t));
             }
-            tape_heads[tape_heads_index-1]=atoi(hd_ptr);
+            s.tape_heads[tape_heads_index-1]=atoi(hd_ptr);
             tape_head_defined=1;
             line_number++;
             continue;
         }
 
-        // Initialize comma count for iteration line
-        uint8_t comma_count;
-        // Initialize string comma positions
-        uint8_t comma_position[6];
-
-        // count commas in buffer
-        countCommas(line_buffer,comma_position,&comma_count);
-
-        if (comma_count!=4) {
-            errorLineMessage(line_number);
-            exit(1);
-        }
-
-        // Command Lines here
-        if (comma_position[3]-comma_position[2]!=2) {
-            errorLineMessage(line_number);
-            printf("Head movement must have a single character length.\n");
-            exit(1);
-        }
-        uint8_t move_char = (uint8_t)line_buffer[comma_position[2]+1];
-        if ((move_char!='<')&&(move_char!='>')&&(move_char!='-')) {
-            errorLineMessage(line_number);
-            printf("Head movement must be < (left), > (right) or - (no move).\n");
-            exit(1);
-        }
-
-        // Valid Command Lines here
-        // Parsing current state name string
-        uint8_t nstate_name_size;
-        cstate_name = malloc((comma_position[0]+1)*sizeof(uint8_t));
-        for (uint8_t i = 0; i<comma_position[0];i++) cstate_name[i] = line_buffer[i];
-        cstate_name[comma_position[0]]='\0';
-        
-        for (uint8_t aux = comma_position[3]+1; line_buffer[aux]!='\0'; aux++) nstate_name_size=aux-comma_position[3];
-        // Parsing new state name string
-        nstate_name = malloc((nstate_name_size+1)*sizeof(uint8_t));
-        j=0;
-        for (uint8_t i = comma_position[3]+1; line_buffer[i]!='\0';i++) {
-            nstate_name[j] = line_buffer[i];
-            j++;
+        // Check for symbol names pattern, it must be given before any tape or move
+        if (strncmp(line_buffer, STR_SYMBOLS,strlen(STR_SYMBOLS)) == 0) {
+            if (tape_defined || s.table.size!=0 || s.table.templates_size!=0) {
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Symbols must be defined before tapes and moves.\n");
+                interpreterExit();
+            }
+            uint8_t* name = line_buffer + strlen(STR_SYMBOLS);
+            while (1) {
+                uint8_t* end = strchr(name,',');
+                uint8_t length = (end!=NULL) ? end-name : strlen(name);
+                if (alphabetDeclare(s.alphabet,name,length)<0) {
+                    interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                    interpreterMessage("Symbol names must have 1 to %u characters without brackets, commas or quotes (at most 160 symbols).\n",ALPHABET_NAME_MAX-2);
+                    interpreterExit();
+                }
+                if (end==NULL) break;
+                name = end+1;
+            }
+            line_number++;
+            continue;
         }
-        nstate_name[nstate_name_size]='\0';
-
-        // Parsing read character
-        if (comma_position[1]-comma_position[0]!=2) rchar[0] = ' '; else rchar[0] = line_buffer[comma_position[0]+1];
-        if (comma_position[2]-comma_position[1]!=2) wchar[0] = ' '; else wchar[0] = line_buffer[comma_position[1]+1];
-        if ((uint8_t)line_buffer[comma_position[2]+1]=='<') hmove=MOVE_LEFT;  else
-        if ((uint8_t)line_buffer[comma_position[2]+1]=='>') hmove=MOVE_RIGHT; else 
-        hmove=MOVE_WAIT;
 
-        if (mparser_size==0) {
-            mparser = malloc((++mparser_size)*sizeof(Parser_t));
-        } else {
-            mparser = realloc(mparser,(++mparser_size)*sizeof(Parser_t));
+        // Check for number of tapes pattern, it must be given before any move
+        if (strncmp(line_buffer, STR_TAPES_NUMBER,strlen(STR_TAPES_NUMBER)) == 0) {
+            uint8_t* tn_ptr = line_buffer + strlen(STR_TAPES_NUMBER);
+            if (*tn_ptr==0 || atoi(tn_ptr)<1 || atoi(tn_ptr)>TAPES_MAX) {
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Number of tapes must be between 1 and %u.\n",TAPES_MAX);
+                interpreterExit();
+            }
+            if (s.table.size!=0 || s.table.templates_size!=0) {
+                interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
+                interpreterMessage("Number of tapes must be defined before moves.\n");
+                interpreterExit();
+            }
+            tapes_number=atoi(tn_ptr);
+            line_number++;
+            continue;
         }
-        mparser[mparser_size-1].current_state_name=cstate_name;
-        mparser[mparser_size-1].new_state_name=nstate_name;
-        mparser[mparser_size-1].read_symbol=rchar[0];
-        mparser[mparser_size-1].write_symbol=wchar[0];
-        mparser[mparser_size-1].head_move=hmove;
 
+        parseMove(line_buffer,line_number,tapes_number,s.alphabet,&s.table);
         line_number++;
     }
-    fclose(file);
-    parser.tapes=tape_string_names;
-    parser.tapes_size=tape_string_name_index-1;
-    parser.heads=tape_heads;
+    preprocessorFree(pp);
+    interpreter_pp = NULL;
+    parseTemplates(&s.table,s.tape_string_names,s.tape_string_name_index);
+    if (alphabetCollision(s.alphabet)) {
+        interpreterMessage("Too many symbols: control character %u is also used as a single character symbol.\n",alphabetCollision(s.alphabet));
+        interpreterExit();
+    }
+    if (s.alphabet->size==0) {
+        alphabetFree(s.alphabet);
+        s.alphabet = NULL;
+    }
+    interpreter_parse = NULL;
+    parser.tapes=s.tape_string_names;
+    parser.tapes_size=s.tape_string_name_index-1;
+    parser.heads=s.tape_heads;
     parser.head_size=tape_heads_index-1;
-    parser.initial_state =initial_state_name;
-    parser.accept_states=accept_states_names;
-    parser.accept_states_size=accept_states_size;
-    parser.move_parser=mparser;
-    parser.mparser_size=mparser_size;
+    parser.initial_state =s.initial_state_name;
+    parser.accept_states=s.accept_states_names;
+    parser.accept_states_size=s.accept_states_size;
+    parser.move_parser=s.table.moves;
+    parser.mparser_size=s.table.size;
+    parser.tapes_number=tapes_number;
+    parser.alphabet=s.alphabet;
     return parser;
 }
 
+/// @brief Index of a state name in a names table, the state is appended to the states if it is a new name
+/// @param names        State names table
+/// @param states       States, with room for a new state
+/// @param states_size  States Length, incremented for a new state
+/// @param name         State Name
+/// @return             State Index
+static uint32_t stateNamesAdd(StateNames_t* names, State_t* states, uint32_t* states_size, const uint8_t* name) {
+    uint32_t* slot = stateNamesSlot(names,states,name);
+    if (*slot!=0) return *slot-1;
+    if (*states_size==MAX_STATES) {
+        interpreterMessage("No more than %u states.\n",MAX_STATES);
+        interpreterExit();
+    }
+    states[*states_size].name=malloc((strlen(name)+1)*sizeof(uint8_t));
+    strcpy(states[*states_size].name,name);
+    states[*states_size].type = STATE_NORMAL;
+    *slot = ++(*states_size);
+    return *states_size-1;
+}
+
+/// @brief Copy of a state owned by a move (see freeAutomata)
+static State_t* stateCopy(State_t* state) {
+    State_t* copy = malloc(1*sizeof(State_t));
+    copy->name = malloc((strlen(state->name)+1)*sizeof(uint8_t));
+    strcpy(copy->name,state->name);
+    copy->type = state->type;
+    return copy;
+}
+
 /// @brief Checks Automata Definition from Parser_t given
 /// and Allocates Memory to AutomataParser_t output, if valid
 /// Parser_t p (input) still has memory allocated after function call!!!
+/// States are found by name through a hash table, so large expanded scripts load in linear time
 /// @param p Parser_t input to be checked
 /// @return AutomataParser_t object with Memory Allocated
 AutomataParser_t parserToAutomata(Parser_t p) {
-    // States
-    uint8_t is_unique,states_size=0;
-    uint8_t **unique_states;
-    unique_states = malloc(1*sizeof(uint8_t*));
-    // get all unique values of uint8_t** accept_states array
-    for (uint8_t i = 0; i < p.mparser_size; i++) {
-        // iterate over current state name
-        is_unique=1;
-        for (uint8_t j = 0; j < states_size; j++) {
-            if (!strcmp(unique_states[j],p.move_parser[i].current_state_name)) {is_unique=0; break;}
-        }
-        if (is_unique) {
-            unique_states=realloc(unique_states,(states_size+1)*sizeof(uint8_t*));
-            unique_states[states_size]=malloc(strlen(p.move_parser[i].current_state_name+1)*sizeof(uint8_t));
-            strcpy(unique_states[states_size],p.move_parser[i].current_state_name);
-            states_size++;
-        }
-        // iterate over new state name
-        is_unique=1;
-        for (uint8_t j = 0; j < states_size; j++) {
-            if (!strcmp(unique_states[j],p.move_parser[i].new_state_name)) {is_unique=0; break;}
-        }
-        if (is_unique) {
-            unique_states=realloc(unique_states,(states_size+1)*sizeof(uint8_t*));
-            unique_states[states_size]=malloc(strlen(p.move_parser[i].new_state_name+1)*sizeof(uint8_t));
-            strcpy(unique_states[states_size],p.move_parser[i].new_state_name);
-            states_size++;
-        }
-    }
-    // Once we have all unique states from moves definition, we need to allocate memory
-    // for each unique state object to assemble Automata_t object
-    State_t* states;
-    states = malloc((states_size+1)*sizeof(State_t));
-    for (uint8_t i = 0; i < states_size; i++) {
-        states[i].name=malloc(strlen(unique_states[i]+1)*sizeof(uint8_t));
-        strcpy(states[i].name,unique_states[i]);
-        states[i].type = STATE_NORMAL;
-        free(unique_states[i]);
+    // States: unique state names of the moves, in order of appearance, released by interpreterExit on errors
+    ParseState_t s = {0};
+    interpreter_parse = &s;
+    s.states = malloc((2*(uint64_t)p.mparser_size+1)*sizeof(State_t));
+    s.current_states = malloc((p.mparser_size+1)*sizeof(uint32_t));
+    s.new_states = malloc((p.mparser_size+1)*sizeof(uint32_t));
+    stateNamesCreate(&s.names,2*p.mparser_size);
+    for (uint32_t i = 0; i < p.mparser_size; i++) {
+        s.current_states[i] = stateNamesAdd(&s.names,s.states,&s.states_size,p.move_parser[i].current_state_name);
+        s.new_states[i] = stateNamesAdd(&s.names,s.states,&s.states_size,p.move_parser[i].new_state_name);
     }
+    s.states = realloc(s.states,(s.states_size+1)*sizeof(State_t));
     // Defining accept states to assemble Automata_t object
+    uint8_t thereIsValidState = 0;
     for (uint8_t i = 0; i < p.accept_states_size ; i++) {
-        for (uint8_t j = 0; j < states_size ; j++) {
-            if (!strcmp(states[j].name,p.accept_states[i])) {
-                states[j].type=STATE_ACCEPT;
-                break;
-            }
+        uint32_t* slot = stateNamesSlot(&s.names,s.states,p.accept_states[i]);
+        if (*slot!=0) {
+            s.states[*slot-1].type=STATE_ACCEPT;
+            thereIsValidState=1;
         }
     }
     // Checking if there were any accept state defined to validate Automata_t object
-    uint8_t thereIsValidState = 0;
-    for (uint8_t j = 0; j < states_size ; j++) {
-        if (states[j].type==STATE_ACCEPT) {thereIsValidState=1; break;}
-    }
     if (!thereIsValidState) {
-        printf("No valid Accept State defined.\n");
-        exit(1);
+        interpreterMessage("No valid Accept State defined.\n");
+        interpreterExit();
     }
     // Defining initial state to assemble Automata_t object
     // And checks if there is an initial state defined to validate Automata_t object
-    thereIsValidState = 0;
-    for (uint8_t j = 0; j < states_size ; j++) {
-        if (!strcmp(states[j].name,p.initial_state)) {
-            if (states[j].type!=STATE_ACCEPT) {
-                states[j].type=STATE_INITIAL;
-                thereIsValidState=1;
-            } else {
-                printf("Accept States cannot be Initial State.\n");
-                exit(1);
-            }
-            break;
-        }
+    uint32_t* initial = (p.initial_state!=NULL) ? stateNamesSlot(&s.names,s.states,p.initial_state) : NULL;
+    if (initial==NULL || *initial==0) {
+        interpreterMessage("No valid Initial State defined.\n");
+        interpreterExit();
     }
-    if (!thereIsValidState) {
-        printf("No valid Initial State defined.\n");
-        exit(1);
+    if (s.states[*initial-1].type==STATE_ACCEPT) {
+        interpreterMessage("Accept States cannot be Initial State.\n");
+        interpreterExit();
     }
+    s.states[*initial-1].type=STATE_INITIAL;
+    free(s.names.slots);
+    interpreter_parse = NULL;
 
     // Defining Moves from Parser_t object and defined States_t with their memory already allocated
     // it does not perform any DTM or NDTM checks in this execution
-    uint8_t moves_size=0;
-    Move_t* moves=malloc((moves_size+1)*sizeof(Move_t));
-    for (uint8_t i = 0; i < p.mparser_size ; i++) {
-        moves=realloc(moves,(moves_size+1)*sizeof(Move_t));
-        for (uint8_t j = 0; j < states_size ; j++) {
-            if (!strcmp(states[j].name,p.move_parser[i].current_state_name)) {
-                moves[moves_size].current_state = malloc(1*sizeof(State_t));
-                moves[moves_size].current_state->name = malloc((strlen(p.move_parser[i].current_state_name)+1)*sizeof(uint8_t));
-                strcpy(moves[moves_size].current_state->name,states[j].name);
-                moves[moves_size].current_state->type=states[j].type;
-                
-            }
-            if (!strcmp(states[j].name,p.move_parser[i].new_state_name)) {
-                moves[moves_size].new_state = malloc(1*sizeof(State_t));
-                moves[moves_size].new_state->name = malloc((strlen(p.move_parser[i].new_state_name)+1)*sizeof(uint8_t));
-                strcpy(moves[moves_size].new_state->name,states[j].name);
-                moves[moves_size].new_state->type=states[j].type;
-            }
-        }
+    uint32_t moves_size=0;
+    Move_t* moves=malloc((p.mparser_size+1)*sizeof(Move_t));
+    for (uint32_t i = 0; i < p.mparser_size ; i++) {
+        moves[moves_size].current_state = stateCopy(&s.states[s.current_states[i]]);
+        moves[moves_size].new_state = stateCopy(&s.states[s.new_states[i]]);
         moves[moves_size].head_move=p.move_parser[i].head_move;
         moves[moves_size].read_symbol=p.move_parser[i].read_symbol;
         moves[moves_size].write_symbol=p.move_parser[i].write_symbol;
+        moves[moves_size].line_number=p.move_parser[i].line_number;
+        // packed symbols and head moves of every tape for multi-tape engines
+        moves[moves_size].read_key=0;
+        moves[moves_size].write_key=0;
+        moves[moves_size].head_moves=0;
+        for (uint8_t k = 0; k < p.tapes_number; k++) {
+            moves[moves_size].read_key|=((uint64_t)p.move_parser[i].read_symbols[k])<<(8*k);
+            moves[moves_size].write_key|=((uint64_t)p.move_parser[i].write_symbols[k])<<(8*k);
+            moves[moves_size].head_moves|=((uint16_t)p.move_parser[i].head_moves[k])<<(2*k);
+        }
         moves_size++;
     }
+    free(s.current_states);
+    free(s.new_states);
     AutomataParser_t a;
     a.moves = moves;
     a.moves_size = moves_size;
-    a.states = states;
-    a.states_size = states_size;
+    a.states = s.states;
+    a.states_size = s.states_size;
+    a.tapes_number = p.tapes_number;
     return a;
 }
 
@@ -395,75 +800,130 @@ HeadParser_t parserToHeadParser(Parser_t p) {
 
     // Double Check Tape and Heads
     if (p.head_size!=p.tapes_size) {
-        printf("Number of Tape Definitions and Head Definitions must match.\n");
-        exit(1);
+        interpreterMessage("Number of Tape Definitions and Head Definitions must match.\n");
+        interpreterExit();
     } else hp.size = p.head_size+1;
 
     // Copying to objects in array
     hp.tapes = malloc((hp.size+1)*sizeof(uint8_t*));
-    for (uint8_t aux = 0; aux<hp.size; aux++) {
+    for (uint32_t aux = 0; aux<hp.size; aux++) {
         // Tapes
-        hp.tapes[aux] = malloc(strlen(p.tapes[aux]+1)*sizeof(uint8_t));
+        hp.tapes[aux] = malloc((strlen(p.tapes[aux])+1)*sizeof(uint8_t));
         strcpy(hp.tapes[aux],p.tapes[aux]);
         // free(p.tapes[aux]);
     }
     // Heads
     hp.heads = malloc((hp.size+1)*sizeof(uint8_t));
-    for (uint8_t i=0;i<hp.size;i++) hp.heads[i]=p.heads[i];
+    for (uint32_t i=0;i<hp.size;i++) hp.heads[i]=p.heads[i];
     return hp;
 }
 
 /// @brief Generates a Deterministic Turing Machine (DTM) Object
-/// TO DO: Rejects TM_t when there is more than one valid move, this verification is not made here, yet!
-/// @param tape uint8_t* tape string
+/// Moves are not checked for determinism here: with more than one valid move, the first one is applied
+/// (determinismConflicts lists them)
+/// @param tape uint8_t* tape string, NULL to leave the tape to the caller (tape arenas use the script tape)
 /// @param head uint8_t 0-based number INDEX (not pointer) pointing to tape head string
 /// @param a AutomataParser_t Automata Object
 /// @return TM_t Deterministic Turing Machine
 TM_t DTM(uint8_t* tape, uint8_t head,AutomataParser_t a) {
     TM_t t;
     // Memory Allocating TM Tape
-    t.tape = malloc((strlen(tape)+1)*sizeof(uint8_t));
-    strcpy(t.tape,tape);
+    t.tape = NULL;
+    if (tape!=NULL) {
+        t.tape = malloc((strlen(tape)+1)*sizeof(uint8_t));
+        strcpy(t.tape,tape);
+    }
     // Memory Allocating TM Head
     t.head = head;
     // Memory Allocating TM States
     // TO DO: This is not necessary and can lead to memory overload
     // when running multiple Turing Machines, in later code revisions replace that to
     // states that are already defined and allocated to Automata_t a object
-    t.states = malloc((a.states_size)*sizeof(State_t));
+    t.states = malloc((a.states_size+1)*sizeof(State_t));
     t.states_size = a.states_size;
-    for (uint8_t i = 0; i < a.states_size; i++) {
+    StateNames_t names;
+    stateNamesCreate(&names,t.states_size);
+    for (uint32_t i = 0; i < a.states_size; i++) {
         t.states[i].name = malloc((strlen(a.states[i].name)+1)*sizeof(uint8_t));
         strcpy(t.states[i].name,a.states[i].name);
         t.states[i].type=a.states[i].type;
+        *stateNamesSlot(&names,t.states,t.states[i].name) = i+1;
     }
     // Memory Allocating TM Moves
-    t.moves = malloc((a.moves_size)*sizeof(Move_t));
+    t.moves = malloc((a.moves_size+1)*sizeof(Move_t));
     t.moves_size = a.moves_size;
-    for (uint8_t i = 0; i < a.moves_size; i++) {
+    for (uint32_t i = 0; i < a.moves_size; i++) {
         // find the pointer that match the actual state pointer instead of memory allocate a state
-        uint8_t foundCurrentState=0,foundNewState=0;
-        for (uint8_t j = 0; j < t.states_size; j++) {
-            if (!foundCurrentState) {
-                if (!strcmp(a.moves[i].current_state->name,t.states[j].name)) {
-                    foundCurrentState = 1;
-                    t.moves[i].current_state=&t.states[j];
-                }
-            }
-            if (!foundNewState) {
-                if (!strcmp(a.moves[i].new_state->name,t.states[j].name)) {
-                    foundNewState = 1;
-                    t.moves[i].new_state=&t.states[j];
-                }
-            }
-        }
+        t.moves[i].current_state=&t.states[*stateNamesSlot(&names,t.states,a.moves[i].current_state->name)-1];
+        t.moves[i].new_state=&t.states[*stateNamesSlot(&names,t.states,a.moves[i].new_state->name)-1];
         t.moves[i].read_symbol = a.moves[i].read_symbol;
         t.moves[i].write_symbol = a.moves[i].write_symbol;
         t.moves[i].head_move = a.moves[i].head_move;
-    }    
+        t.moves[i].line_number = a.moves[i].line_number;
+        t.moves[i].read_key = a.moves[i].read_key;
+        t.moves[i].write_key = a.moves[i].write_key;
+        t.moves[i].head_moves = a.moves[i].head_moves;
+    }
+    free(names.slots);
+    t.index = moveIndexCreate(t.states,t.moves,t.moves_size);
+    // Simulation starts from the initial state
+    for (uint32_t i = 0; i < t.states_size; i++) {
+        if (t.states[i].type==STATE_INITIAL) {t.current_state=&t.states[i];break;}
+    }
+    t.steps = 0;
+    t.status = STATUS_SGMOVE;
     return t;
 }
 
+/// @brief Deallocates every Parser_t object member
+/// @param p Parser_t object returned by parseFile or parseStream
+void freeParser(Parser_t* p) {
+    if (p->tapes!=NULL) for (uint32_t i = 0; i <= p->tapes_size; i++) free(p->tapes[i]);
+    free(p->tapes);
+    free(p->heads);
+    free(p->initial_state);
+    for (uint8_t i = 0; i < p->accept_states_size; i++) free(p->accept_states[i]);
+    free(p->accept_states);
+    for (uint32_t i = 0; i < p->mparser_size; i++) {
+        free(p->move_parser[i].current_state_name);
+        free(p->move_parser[i].new_state_name);
+    }
+    free(p->move_parser);
+    alphabetFree(p->alphabet);
+}
+
+/// @brief Deallocates every AutomataParser_t object member
+/// @param a AutomataParser_t object returned by parserToAutomata
+void freeAutomata(AutomataParser_t* a) {
+    for (uint32_t i = 0; i < a->moves_size; i++) {
+        free(a->moves[i].current_state->name);
+        free(a->moves[i].current_state);
+        free(a->moves[i].new_state->name);
+        free(a->moves[i].new_state);
+    }
+    free(a->moves);
+    for (uint32_t i = 0; i < a->states_size; i++) free(a->states[i].name);
+    free(a->states);
+}
+
+/// @brief Deallocates every HeadParser_t object member
+/// @param hp HeadParser_t object returned by parserToHeadParser
+void freeHeadParser(HeadParser_t* hp) {
+    for (uint32_t i = 0; i < hp->size; i++) free(hp->tapes[i]);
+    free(hp->tapes);
+    free(hp->heads);
+}
+
+/// @brief Deallocates a Turing Machine created by DTM()
+/// @param t TM_t object, its tape, states and moves
+void freeTM(TM_t* t) {
+    free(t->tape);
+    for (uint32_t i = 0; i < t->states_size; i++) free(t->states[i].name);
+    free(t->states);
+    free(t->moves);
+    moveIndexFree(t->index);
+}
+
 /// @brief Inputs a line buffer with whitespaces strings
 /// Outputs a line buffer with no whitespaces strings
 /// Every non-whitespace character will be copied
@@ -473,14 +933,13 @@ TM_t DTM(uint8_t* tape, uint8_t head,AutomataParser_t a) {
 void cleanBuffer(char* buffer, char* clean_buffer) {
     uint8_t i = 0;
     uint8_t j = 0;
-    while (buffer[i]!='\n' || buffer[i]!='\0' || buffer[i] != EOF) {
+    // stop at the end of the string or at MAX_LINE_LENGTH
+    while (i<MAX_LINE_LENGTH && buffer[i]!='\0') {
         if (!isspace((char)buffer[i])) {
             clean_buffer[j]=(char)buffer[i];
             j++;
         }
-        // stop at MAX_LINE_LENGTH
-        // prevents infinite loop
-        if (i==MAX_LINE_LENGTH) break; else i++;
+        i++;
     }
     clean_buffer[j]='\0';
 }
@@ -494,29 +953,29 @@ void wipeOffSubstring(char* input, char* output, const char* substring) {
     if (pos) {
         // Copy everything up to the found substring into the output buffer
         size_t length = pos - input;
-        strncpy(output, input, length);
+        memmove(output, input, length);
         output[length] = 0;  // Null-terminate the output string
     } else {
         // If the substring is not found, copy the entire input to output
-        strcpy(output, input);
+        // (input and output may be the same buffer)
+        memmove(output, input, strlen(input)+1);
     }
 }
 
 /// @brief This function writes a positions array with indexes with ',' character
 /// @param line_buffer input buffer to seek ',' character
-/// @param positions output array with 5 non-zero elements with ',' indexes, ends with \0
-/// @param count number of commas in buffer
+/// @param positions output array (MAX_COMMAS+1 length) with ',' indexes, ends with \0
+/// @param count number of commas in buffer (positions only keeps the first MAX_COMMAS)
 void countCommas(char* line_buffer,uint8_t* positions,uint8_t* count) {
     uint8_t i = 0, j = 0;
     // initialize all elements with 255
-    for (uint8_t aux = 0; aux<5; aux++) positions[aux]=255;
+    for (uint8_t aux = 0; aux<MAX_COMMAS; aux++) positions[aux]=255;
     // set end of array with 0 to avoid pointer problems
-    positions[5]=0;
+    positions[MAX_COMMAS]=0;
     (*count)=0;
     while (line_buffer[i]!='\0') {
         if (line_buffer[i]==',') {
-            positions[j]=i;
-            j++;
+            if (j<MAX_COMMAS) positions[j++]=i;
             (*count)++;
         }
         i++;
@@ -527,5 +986,5 @@ void countCommas(char* line_buffer,uint8_t* positions,uint8_t* count) {
 /// @brief Print Error Message with line number input
 /// @param line_number uint32_t line number where interpreter found an error
 void errorLineMessage(uint32_t line_number) {
-    printf(INTERPRETER_ERROR_MESSAGE,line_number);
+    interpreterMessage(INTERPRETER_ERROR_MESSAGE,line_number);
 }
\ No newline at end of file
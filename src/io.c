@@ -4,6 +4,7 @@
 // ======================================================================
 
 #include <io.h>
+#include <alphabet.h>
 #include <string.h>
 #ifdef MINGW
 #include <windows.h>
@@ -19,9 +20,11 @@ void printTape(uint8_t* TM_string,uint8_t TM_head) {
     uint8_t TM_string_size = strlen(TM_string);
     for (uint8_t a = 0; a<TM_string_size; a++){
 #ifdef MINGW
-    printf("%c",TM_string[a]);
+        alphabetPut(stdout,TM_string[a]);
 #else
-    if (a==TM_head) printf("\e[1;31m%c\e[0m",TM_string[a]); else printf("%c",TM_string[a]);
+        if (a==TM_head) printf("\e[1;31m");
+        alphabetPut(stdout,TM_string[a]);
+        if (a==TM_head) printf("\e[0m");
 #endif
         str++;
     }
@@ -33,6 +36,8 @@ void printTape(uint8_t* TM_string,uint8_t TM_head) {
 #else
         if (a==TM_head) printf("\e[1;31m^\e[0m"); else printf(" ");
 #endif
+        // names wider than a character
+        for (uint8_t w = 1; w<alphabetWidth(TM_string[a]); w++) printf(" ");
         str++;
     }
     printf("\n");
@@ -42,15 +47,17 @@ void printTape(uint8_t* TM_string,uint8_t TM_head) {
 /// @param TM_string    DTM Tape String
 /// @param TM_head      DTM Tape Head
 /// @param TM_num       DTM Number in a Greater List (given) of running DTMs
-void printTapeNum(uint8_t* TM_string,uint8_t TM_head,uint8_t TM_num) {
+void printTapeNum(uint8_t* TM_string,uint8_t TM_head,uint32_t TM_num) {
     uint8_t* str = TM_string;
     uint8_t TM_string_size = strlen(TM_string);
-    printf("Turing Machine %i Running...\n",TM_num);
+    printf("Turing Machine %u Running...\n",TM_num);
     for (uint8_t a = 0; a<TM_string_size; a++){
 #ifdef MINGW
-        printf("%c",TM_string[a]);
+        alphabetPut(stdout,TM_string[a]);
 #else
-        if (a==TM_head) printf("\e[1;31m%c\e[0m",TM_string[a]); else printf("%c",TM_string[a]);
+        if (a==TM_head) printf("\e[1;31m");
+        alphabetPut(stdout,TM_string[a]);
+        if (a==TM_head) printf("\e[0m");
 #endif
         str++;
     }
@@ -62,6 +69,8 @@ void printTapeNum(uint8_t* TM_string,uint8_t TM_head,uint8_t TM_num) {
 #else
         if (a==TM_head) printf("\e[1;31m^\e[0m"); else printf(" ");
 #endif
+        // names wider than a character
+        for (uint8_t w = 1; w<alphabetWidth(TM_string[a]); w++) printf(" ");
         str++;
     }
     printf("\n");
@@ -87,6 +96,13 @@ void printTMStatus(uint8_t stepStatus) {
         printf("Turing Machine Stopped!\n");
 #else
         printf("\e[1;31m\e[1mTuring Machine Stopped!\e[0m\n");
+#endif
+        break;
+    case 7:
+#ifdef MINGW
+        printf("Turing Machine Filled its Tape (255 cells)!\n");
+#else
+        printf("\e[1;36mTuring Machine Filled its Tape (255 cells)!\e[0m\n");
 #endif
         break;
     
@@ -98,7 +114,7 @@ void printTMStatus(uint8_t stepStatus) {
 /// @brief Print DTM Current Status with its number in a greater list of running DTMs
 /// @param stepStatus   DTM Status Number
 /// @param TM_num       DTM Number in List
-void printTMStatusNum(uint8_t stepStatus,uint8_t TM_num) {
+void printTMStatusNum(uint8_t stepStatus,uint32_t TM_num) {
     switch (stepStatus)
     {
     case 0:
@@ -106,16 +122,44 @@ void printTMStatusNum(uint8_t stepStatus,uint8_t TM_num) {
         break;
     case 1:
 #ifdef MINGW
-        printf("Turing Machine %i in Accept State!\n",TM_num);
+        printf("Turing Machine %u in Accept State!\n",TM_num);
 #else
-        printf("\e[1;32mTuring Machine %i in Accept State!\e[0m\n",TM_num);
+        printf("\e[1;32mTuring Machine %u in Accept State!\e[0m\n",TM_num);
 #endif
         break;
     case 2:
 #ifdef MINGW
-        printf("Turing Machine %i Stopped!\n",TM_num);
+        printf("Turing Machine %u Stopped!\n",TM_num);
+#else
+        printf("\e[1;31m\e[1mTuring Machine %u Stopped!\e[0m\n",TM_num);
+#endif
+        break;
+    case 4:
+#ifdef MINGW
+        printf("Turing Machine %u Cancelled!\n",TM_num);
+#else
+        printf("\e[1;33mTuring Machine %u Cancelled!\e[0m\n",TM_num);
+#endif
+        break;
+    case 5:
+#ifdef MINGW
+        printf("Turing Machine %u Crashed!\n",TM_num);
+#else
+        printf("\e[1;35mTuring Machine %u Crashed!\e[0m\n",TM_num);
+#endif
+        break;
+    case 6:
+#ifdef MINGW
+        printf("Turing Machine %u Ran Off the Tape!\n",TM_num);
+#else
+        printf("\e[1;36mTuring Machine %u Ran Off the Tape!\e[0m\n",TM_num);
+#endif
+        break;
+    case 7:
+#ifdef MINGW
+        printf("Turing Machine %u Filled its Tape (255 cells)!\n",TM_num);
 #else
-        printf("\e[1;31m\e[1mTuring Machine %i Stopped!\e[0m\n",TM_num);
+        printf("\e[1;36mTuring Machine %u Filled its Tape (255 cells)!\e[0m\n",TM_num);
 #endif
         break;
     
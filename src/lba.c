@@ -0,0 +1,74 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <lba.h>
+
+/// @brief Moves the tapes of every machine to a slab, tapes shorter than the bound are
+/// completed with blank cells on the right
+/// @param t        TM_t array
+/// @param machines Number of machines
+/// @param bound    Cells of every tape, at least the length of the longest tape
+/// @return         LBASlab_t*, NULL if a tape is longer than the bound
+LBASlab_t* lbaCreate(TM_t* t, uint32_t machines, uint8_t bound) {
+    for (uint32_t i = 0; i < machines; i++) if (strlen((char*)t[i].tape)>bound) return NULL;
+    LBASlab_t* slab = malloc(sizeof(LBASlab_t));
+    slab->cells = malloc((size_t)machines*(bound+1));
+    slab->bound = bound;
+    slab->machines = machines;
+    for (uint32_t i = 0; i < machines; i++) {
+        uint8_t* tape = slab->cells+(size_t)i*(bound+1);
+        size_t length = strlen((char*)t[i].tape);
+        memcpy(tape, t[i].tape, length);
+        memset(tape+length, ' ', bound-length);
+        tape[bound] = 0;
+        free(t[i].tape);
+        t[i].tape = tape;
+    }
+    return slab;
+}
+
+/// @brief Deallocates a slab with every tape in it
+/// @param slab LBASlab_t*, ignored if NULL
+void lbaFree(LBASlab_t* slab) {
+    if (slab==NULL) return;
+    free(slab->cells);
+    free(slab);
+}
+
+/// @brief Runs a linear-bounded machine for at most a number of steps
+/// Tapes never grow: a move leaving the tape is not applied and stops the machine with STATUS_OFFEND
+/// @param t            TM_t object with a tape of bound cells
+/// @param bound        Cells of the tape
+/// @param steps        Maximum number of steps
+/// @param last_move    Output Pointer to the last Move applied, ignored if NULL
+/// @return             STATUS_SGMOVE if still running after the given steps,
+///                     STATUS_ACCEPT, STATUS_NOMOVE or STATUS_OFFEND elsewhere
+uint8_t lbaRun(TM_t* t, uint8_t bound, uint64_t steps, Move_t** last_move) {
+    uint8_t* tape = t->tape;
+    uint8_t head = t->head;
+    State_t* state = t->current_state;
+    Move_t* m = NULL;
+    uint8_t status = STATUS_SGMOVE;
+    for (uint64_t k = 0; k < steps; k++) {
+        if (state->type==STATE_ACCEPT) {status = STATUS_ACCEPT; break;}
+        Move_t* next = findValidMove(tape,head,t->moves,t->moves_size,state,t->index);
+        if (next==NULL) {status = STATUS_NOMOVE; break;}
+        if ((next->head_move==MOVE_LEFT && head==0) || (next->head_move==MOVE_RIGHT && head==bound-1)) {status = STATUS_OFFEND; break;}
+        m = next;
+        tape[head] = m->write_symbol;
+        state = m->new_state;
+        if (m->head_move==MOVE_LEFT) head--;
+        if (m->head_move==MOVE_RIGHT) head++;
+        t->steps++;
+    }
+    // same status of runStepTM for a machine reaching an accept state in its last step
+    if (status==STATUS_SGMOVE && state->type==STATE_ACCEPT) status = STATUS_ACCEPT;
+    t->head = head;
+    t->current_state = state;
+    if (last_move!=NULL && m!=NULL) *last_move = m;
+    return status;
+}
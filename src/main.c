@@ -5,6 +5,26 @@
 
 #include <rules.h>
 #include <interpreter.h>
+#include <trace.h>
+#include <checkpoint.h>
+#include <stats.h>
+#include <profile.h>
+#include <multitape.h>
+#include <optimize.h>
+#include <sweep.h>
+#include <determinism.h>
+#include <arena.h>
+#include <shard.h>
+#include <output.h>
+#include <count.h>
+#include <sample.h>
+#include <witness.h>
+#include <lba.h>
+#include <debugger.h>
+#include <breakpoint.h>
+#include <beaver.h>
+#include <enumerate.h>
+#include <serve.h>
 #include <main.h>
 #include <io.h>
 #ifdef OPENMP
@@ -19,7 +39,21 @@ int8_t main(int argc, char *argv[]) {
 #endif
     TM_t* t;
     uint32_t t_number=0;
+    double startTime;
+    // subcommands
+    if (argc>1 && strcmp(argv[1], "replay") == 0) return (int8_t) replayTrace(argc-2, argv+2);
+    if (argc>1 && strcmp(argv[1], "beaver") == 0) return (int8_t) beaverMain(argc-2, argv+2);
+#ifndef MINGW
+    if (argc>1 && strcmp(argv[1], "serve") == 0) return (int8_t) serveMain(argc-2, argv+2);
+#endif
     parseArgs(argc, argv);
+    if (statsFile==NULL) statsFile=stdout;
+    if (outputFormat) {
+        outputQuiet = (outputFile==NULL);
+        if (outputFile==NULL) outputFile=stdout;
+    }
+    if (profileFile==NULL) profileFile=stdout;
+    startTime = statsClock();
 
     // if there is a TM define request, checks TM mode
     // raises error elsewhere
@@ -28,20 +62,108 @@ int8_t main(int argc, char *argv[]) {
             printf("You can't use both DTM and NDTM modes.\n");
             exit(1);
         }
-        if (!DTM_mode && !NDTM_mode) {
-            printf("You must define a Turing Machine Simulation mode.\n");
+        if (countEnabled && DTM_mode) {
+            printf("Path counting is only available in NDTM mode.\n");
+            exit(1);
+        }
+        if (sampleWalksNumber && (DTM_mode || countEnabled)) {
+            printf("Random walks are only available in NDTM mode, without path counting.\n");
+            exit(1);
+        }
+        // counting and sampling explore the nondeterministic choices, deterministic or not
+        if ((countEnabled || sampleWalksNumber) && !AUTO_mode) NDTM_mode=1;
+        if (AUTO_mode && (DTM_mode || NDTM_mode)) {
+            printf("You can't use the automatic mode with DTM or NDTM modes.\n");
             exit(1);
         }
+        // without a mode, deterministic automata run in DTM mode and the others in NDTM mode
+        if (!DTM_mode && !NDTM_mode) {
+            AutomataParser_t a = parserToAutomata(p);
+            uint32_t conflicts = determinismConflicts(a,NULL);
+            if (conflicts) {
+                printf("Non deterministic automaton (%u conflicts), running NDTM mode:\n",conflicts);
+                determinismConflicts(a,stdout);
+                NDTM_mode=1;
+            } else {
+                if (!outputQuiet) printf("Deterministic automaton, running DTM mode.\n");
+                DTM_mode=1;
+            }
+            freeAutomata(&a);
+        }
         if (DTM_mode) {
             AutomataParser_t a;
             HeadParser_t hp;
             a = parserToAutomata(p);
             hp = parserToHeadParser(p);
-            t = malloc((t_number+1)*sizeof(TM_t));
-            for (uint8_t i = 0; i < hp.size; i++) {
-                t[i] = DTM(hp.tapes[i],hp.heads[i],a);
+            if (shards && (traceFilename!=NULL || checkpointFilename!=NULL || resumeFilename!=NULL || profileEnabled)) {
+                // every worker process would write its own file
+                printf("Traces, checkpoints and profiles are not available with shards.\n");
+                exit(1);
+            }
+            if (!AUTO_mode && determinismConflicts(a,NULL)) {
+                printf("Warning: non deterministic automaton, DTM mode applies the first move defined for:\n");
+                determinismConflicts(a,stdout);
+            }
+            if (optimizeEnabled) {
+                if (a.tapes_number>1) {
+                    printf("Automaton optimization is only available for single tape machines.\n");
+                    exit(1);
+                }
+                OptimizeReport_t report;
+                AutomataParser_t optimized = optimizeAutomata(a,optimizeDead,&report);
+                // result records written to the console keep stdout for themselves
+                FILE* messages = outputQuiet ? stderr : stdout;
+                optimizeReportPrint(messages,&report);
+                if (optimizeCheck && !optimizeVerify(messages,a,optimized,&report,hp)) exit(1);
+                optimizeReportFree(&report);
+                freeAutomata(&a);
+                a = optimized;
+            }
+            t = malloc((hp.size+1)*sizeof(TM_t));
+            // single tape machines run in tape arenas, that build their tapes from the script tapes
+            uint8_t arena_run = (a.tapes_number==1 && !lbaEnabled);
+            for (uint32_t i = 0; i < hp.size; i++) {
+                t[i] = DTM(arena_run ? NULL : hp.tapes[i],hp.heads[i],a);
+                if (arena_run) t[i].tape = hp.tapes[i];
                 (t_number)++;
-                t = realloc(t,(t_number+1)*sizeof(TM_t));
+            }
+            if (a.tapes_number>1) {
+                if (traceFilename!=NULL || checkpointFilename!=NULL || profileEnabled) {
+                    printf("Traces, checkpoints and profiles are only available for single tape machines.\n");
+                    exit(1);
+                }
+                // the first tape of each machine is its tape definition, the others start blank
+                multi = malloc((t_number+1)*sizeof(MultiTM_t));
+                for (uint32_t i = 0; i < t_number; i++) multi[i] = multiTM(&t[i],a.tapes_number);
+            }
+            // CSV columns depend on the number of tapes
+            if (outputFormat) outputBegin(outputFile,outputFormat,a.tapes_number);
+            if (lbaEnabled) {
+                if (multi!=NULL || traceFilename!=NULL || checkpointFilename!=NULL || resumeFilename!=NULL || profileEnabled) {
+                    printf("Linear-bounded mode is only available for single tape machines, without traces, checkpoints or profiles.\n");
+                    exit(1);
+                }
+                // without a declared bound, every tape has the cells of the longest tape
+                if (lbaBound==0) for (uint32_t i = 0; i < t_number; i++) if (strlen(t[i].tape)>lbaBound) lbaBound=strlen(t[i].tape);
+                for (uint32_t i = 0; i < t_number; i++) {
+                    if (t[i].head>=lbaBound) {
+                        printf("Head of Turing Machine %u is out of the linear-bounded mode bound of %u cells.\n",i,lbaBound);
+                        exit(1);
+                    }
+                }
+                lba = lbaCreate(t,t_number,lbaBound);
+                if (lba==NULL) {
+                    printf("Tapes must fit in the linear-bounded mode bound of %u cells.\n",lbaBound);
+                    exit(1);
+                }
+            }
+            if (breakNamesSize || watchCellsSize || breakStep) {
+                if (multi!=NULL || lba!=NULL || shards || traceFilename!=NULL || checkpointFilename!=NULL || profileEnabled) {
+                    printf("Breakpoints are only available for single tape DTMs, without linear-bounded mode, shards, traces, checkpoints or profiles.\n");
+                    exit(1);
+                }
+                breakpoints = breakpointsCreate(&t[0],breakNames,breakNamesSize,watchCells,watchCellsSize,breakStep);
+                if (breakpoints==NULL) exit(1);
             }
         }
         if (NDTM_mode) {
@@ -53,11 +175,100 @@ int8_t main(int argc, char *argv[]) {
                 printf("You can only run a single NDTM per file.\n");
                 exit(1);
             }
+            if (traceFilename!=NULL) {
+                printf("Trace files are only available in DTM mode.\n");
+                exit(1);
+            }
+            if (a.tapes_number>1) {
+                printf("Multi-tape machines are only available in DTM mode.\n");
+                exit(1);
+            }
+            if (optimizeEnabled || shards || outputFormat || lbaEnabled) {
+                printf("Automaton optimization, shards, result output and linear-bounded mode are only available in DTM mode.\n");
+                exit(1);
+            }
+            if (breakNamesSize || watchCellsSize || breakStep) {
+                printf("Breakpoints are only available in DTM mode.\n");
+                exit(1);
+            }
             t = malloc(1*sizeof(TM_t));
             t[0] = DTM(hp.tapes[0],hp.heads[0],a);
         }
+#ifdef OPENMP
+        if (DTM_mode) profileThreads = jobs;
+#endif
+        // every machine shares the automaton layout of the first one
+        if (profileEnabled) profile = profileCreate(&t[0],profileThreads);
+        // sweeps skip steps, so they are only used when no step is recorded or printed
+        // every worker thread runs its machines in its own tape arena
+        if (DTM_mode && multi==NULL && lba==NULL) arenas = arenaCreate(profileThreads,arenaPin);
+        if (DTM_mode && sweepEnabled && multi==NULL && lba==NULL && breakpoints==NULL && !isVerbose && traceFilename==NULL && checkpointFilename==NULL && !profileEnabled) sweep = sweepCreate(&t[0]);
     }
     
+    if (NDTM_mode && countEnabled) {
+        if (checkpointFilename!=NULL || resumeFilename!=NULL || profileEnabled) {
+            printf("Checkpoints and profiles are not available with path counting.\n");
+            exit(1);
+        }
+        CountReport_t report = countPaths(&t[0],countSteps);
+        countReportPrint(stdout,&report,countSteps);
+        countReportFree(&report);
+        return (int8_t) 0;
+    }
+    if (NDTM_mode && sampleWalksNumber) {
+        if (checkpointFilename!=NULL || resumeFilename!=NULL || profileEnabled) {
+            printf("Checkpoints and profiles are not available with random walks.\n");
+            exit(1);
+        }
+        uint32_t threads = 1;
+#ifdef OPENMP
+        threads = jobs;
+#endif
+        SampleReport_t report = sampleWalks(&t[0],sampleWalksNumber,sampleSeed,sampleSteps,threads);
+        sampleReportPrint(stdout,&report,&t[0],sampleSeed,sampleSteps);
+        return (int8_t) 0;
+    }
+    if (enumerateText!=NULL) {
+        if (!DTM_mode || multi!=NULL || lba!=NULL || shards || breakpoints!=NULL || debugEnabled) {
+            printf("Input enumeration is only available for single tape DTMs, without linear-bounded mode, shards, breakpoints or the debugger.\n");
+            exit(1);
+        }
+        if (traceFilename!=NULL || checkpointFilename!=NULL || resumeFilename!=NULL || profileEnabled) {
+            printf("Traces, checkpoints and profiles are not available with input enumeration.\n");
+            exit(1);
+        }
+        EnumerateReport_t report;
+        int8_t parsed = enumerateParse(enumerateText,p.alphabet,&report);
+        if (parsed==-1) {
+            printf("Input enumeration needs symbols of the script and a length up to %u, like 01:12.\n",ENUMERATE_LENGTH_MAX);
+            exit(1);
+        }
+        if (parsed==-2) {
+            printf("Too many inputs to enumerate.\n");
+            exit(1);
+        }
+        uint32_t threads = 1;
+#ifdef OPENMP
+        threads = jobs;
+#endif
+        enumerateInputs(&t[0],&report,enumerateSteps,threads);
+        enumerateReportPrint(stdout,&report);
+        return (int8_t) 0;
+    }
+    if (debugEnabled) {
+        if (!DTM_mode || multi!=NULL || lba!=NULL || shards) {
+            printf("The debugger is only available for single tape DTMs, without linear-bounded mode or shards.\n");
+            exit(1);
+        }
+        if (debugMachine>=t_number) {
+            printf("Turing Machine %u is not defined in the script.\n",debugMachine);
+            exit(1);
+        }
+        Debugger_t* d = debugCreate(&t[debugMachine]);
+        debugRepl(d,stdin);
+        debugFree(d);
+        return (int8_t) 0;
+    }
     if (NDTM_mode) {
         uint8_t stop = 0;
         uint32_t* flagStatus = malloc(1*sizeof(uint32_t));
@@ -72,11 +283,65 @@ int8_t main(int argc, char *argv[]) {
         valid_moves[0].base = malloc(1*sizeof(Move_t*));
         StatusNDTM_t status_ndtm;
         // finds initial state for original TM
-        for (uint8_t k = 0; k < t[0].states_size; k++) {
+        for (uint32_t k = 0; k < t[0].states_size; k++) {
             if (t[0].states[k].type==STATE_INITIAL) {current_state[0]=t[0].states[k];break;}
         }
         // defines tape for original TM
         tmlen[0]=strlen(t[0].tape);
+        uint64_t ndtm_steps = 0, ndtm_reallocations = 0;
+        uint8_t ndtm_status = STATUS_NOMOVE;
+        // restores the whole frontier from a checkpoint, every branch shares the original automaton
+        if (resumeFilename!=NULL) {
+            Checkpoint_t* r = checkpointLoad(resumeFilename);
+            if (r->automata_hash!=automataHash(&t[0])) {
+                printf("Checkpoint %s was created with a different automaton.\n",resumeFilename);
+                exit(1);
+            }
+            if (r->mode!=CHECKPOINT_MODE_NDTM || r->machines_size==0) {
+                printf("Checkpoint %s does not match a Non Deterministic Turing Machine.\n",resumeFilename);
+                exit(1);
+            }
+            t_number         = r->machines_size-1;
+            t                = realloc(t,(t_number+1)*sizeof(TM_t));
+            flagStatus       = realloc(flagStatus,(t_number+1)*sizeof(uint32_t));
+            tmlen            = realloc(tmlen,(t_number+1)*sizeof(uint8_t));
+            tm_string_length = realloc(tm_string_length,(t_number+1)*sizeof(uint8_t*));
+            valid_moves      = realloc(valid_moves,(t_number+1)*sizeof(ValidMoves_t));
+            current_state    = realloc(current_state,(t_number+1)*sizeof(State_t));
+            free(t[0].tape);
+            for (uint32_t k = 0; k <= t_number; k++) {
+                if (r->machines[k].state>=t[0].states_size) {
+                    printf("Checkpoint %s has an invalid state.\n",resumeFilename);
+                    exit(1);
+                }
+                if (k>0) {
+                    t[k] = t[0];
+                    valid_moves[k].base = malloc(1*sizeof(Move_t*));
+                }
+                valid_moves[k].length = 0;
+                t[k].tape = r->machines[k].tape;
+                t[k].head = r->machines[k].head;
+                tmlen[k] = strlen(t[k].tape);
+                tm_string_length[k] = &tmlen[k];
+                flagStatus[k] = r->machines[k].status;
+                current_state[k] = t[0].states[r->machines[k].state];
+            }
+            i = r->frontier_index;
+            ndtm_steps = r->steps;
+        }
+        if (checkpointFilename!=NULL) checkpoint = checkpointCreate(checkpointFilename,t,1,CHECKPOINT_MODE_NDTM,checkpointSteps,checkpointSeconds);
+        // records the moves of every branch to print the accepting one, verbose mode already prints every step
+        // resumed frontiers do not have the moves before the checkpoint
+        Witness_t* witness = NULL;
+        TM_t witness_origin = t[0];
+        State_t witness_state = current_state[0];
+        if (witnessEnabled && !isVerbose && resumeFilename==NULL) {
+            witness = witnessCreate();
+            witness_origin.tape = malloc((tmlen[0]+1)*sizeof(uint8_t));
+            strcpy(witness_origin.tape,t[0].tape);
+        }
+        // branches are interleaved, so state runs are not tracked in NDTM mode
+        Profile_t* pr = (profile!=NULL) ? profileThread(profile) : NULL;
         while (!stop) {
             // find Valid Moves on Non Deterministic Turing Machine
             // this is different from a Valid Move search on a DTM
@@ -102,13 +367,22 @@ int8_t main(int argc, char *argv[]) {
                     printTapeNum(t[i].tape,t[i].head,i);
                     printTMStatusNum(flagStatus[i],i);
                 }
+                if (witness!=NULL) {
+                    witnessPrint(witness,i,&witness_origin,&witness_state);
+                    printTMStatusNum(flagStatus[i],i);
+                }
+                if (checkpoint!=NULL) {
+                    checkpointUpdateNDTM(checkpoint,t,flagStatus,current_state,t_number,i,ndtm_steps);
+                    checkpointWrite(checkpoint,1);
+                }
+                ndtm_status=STATUS_ACCEPT;
                 break;
             } else {
                 // Reinitializes input valid_moves given object
                 if (valid_moves[i].length!=0) valid_moves[i].length=0;
 
                 // Find valid moves in current turing machine
-                for (uint8_t j = 0;j<t[i].moves_size;j++) {
+                for (uint32_t j = 0;j<t[i].moves_size;j++) {
                     if (t[i].moves[j].current_state->name==current_state[i].name) {
                         if (t[i].moves[j].read_symbol==t[i].tape[t[i].head]) {
                             valid_moves[i].base[valid_moves[i].length] = &(t[i].moves[j]);
@@ -123,6 +397,11 @@ int8_t main(int argc, char *argv[]) {
                     status_ndtm.status=STATUS_NOMOVE;
                     status_ndtm.valid_moves.length=0;
                     status_ndtm.valid_moves.base=NULL;
+                    if (witness!=NULL) witnessStop(witness,i);
+                    // NDTM stops when every branch is stopped
+                    uint32_t k = 0;
+                    while (k<=t_number && flagStatus[k]==STATUS_NOMOVE) k++;
+                    if (k>t_number) stop=1;
                 } else {
                     // Checks if there is only 1 Valid Move, if so STATUS=0, 3 elsewhere
                     if (valid_moves[i].length==1) status_ndtm.status=STATUS_SGMOVE; else status_ndtm.status=STATUS_MMOVES;
@@ -140,11 +419,11 @@ int8_t main(int argc, char *argv[]) {
                 current_state    = realloc(current_state,(t_number+status_ndtm.valid_moves.length+1)*sizeof(State_t));
                 // counter does not starts at zero because the first non-deterministic move found is already updated in
                 // extending arrays to add children NDTM instances (zero is skipped since has been overwriten in i-index)
-                for (uint8_t j = 1; j<status_ndtm.valid_moves.length; j++) {
+                for (uint32_t j = 1; j<status_ndtm.valid_moves.length; j++) {
                     valid_moves[t_number+j].length = 0;
                     valid_moves[t_number+j].base = malloc(1*sizeof(Move_t*));
                     flagStatus[t_number+j] = STATUS_SGMOVE;
-                    t[t_number+j].tape = malloc(strlen(t[i].tape)*sizeof(uint8_t));
+                    t[t_number+j].tape = malloc((strlen(t[i].tape)+1)*sizeof(uint8_t));
                     strcpy(t[t_number+j].tape,t[i].tape);
                     tmlen[t_number+j] = strlen(t[t_number+j].tape);
                     tm_string_length[t_number+j] = &tmlen[t_number+j];
@@ -153,6 +432,7 @@ int8_t main(int argc, char *argv[]) {
                     t[t_number+j].moves_size = t[i].moves_size;
                     t[t_number+j].states = t[i].states;
                     t[t_number+j].states_size = t[i].states_size;
+                    t[t_number+j].index = t[i].index;
                     // moving NDTM instance (t_number+1 to t_number+valid_moves_length+1)
                     // writing character to tape
                     t[t_number+j].tape[t[t_number+j].head] = status_ndtm.valid_moves.base[j]->write_symbol;
@@ -160,9 +440,9 @@ int8_t main(int argc, char *argv[]) {
                     // Checking if it is necessary to append a character leftside
                     if (status_ndtm.valid_moves.base[j]->head_move==MOVE_LEFT && t[t_number+j].head==0) {
                         // Append Left
-                        t[t_number+j].tape = realloc(t[t_number+j].tape, (tmlen[t_number+j]+1)*sizeof(uint8_t));
+                        t[t_number+j].tape = realloc(t[t_number+j].tape, (tmlen[t_number+j]+2)*sizeof(uint8_t));
                         // shift every character one position right
-                        for (uint16_t aux = tmlen[t_number+j]-1;aux>=0;aux--) t[t_number+j].tape[aux+1]=t[t_number+j].tape[aux];
+                        for (int16_t aux = tmlen[t_number+j]-1;aux>=0;aux--) t[t_number+j].tape[aux+1]=t[t_number+j].tape[aux];
                         // add blank space to first element
                         t[t_number+j].tape[0] = ' ';
                         // finish tape string with 0
@@ -171,23 +451,27 @@ int8_t main(int argc, char *argv[]) {
                         t[t_number+j].head++;
                         // Update Tape Size
                         tmlen[t_number+j]++;
+                        ndtm_reallocations++;
                     }
                     // Checking if it is necessary to append a character rightside
                     if (status_ndtm.valid_moves.base[j]->head_move==MOVE_RIGHT && t[t_number+j].head==tmlen[t_number+j]-1) {
                         // Append Right
-                        t[t_number+j].tape = realloc(t[t_number+j].tape, (tmlen[t_number+j]+1)*sizeof(uint8_t));
+                        t[t_number+j].tape = realloc(t[t_number+j].tape, (tmlen[t_number+j]+2)*sizeof(uint8_t));
                         // add blank space to last element
                         t[t_number+j].tape[tmlen[t_number+j]] = ' ';
                         // finish tape string with 0
                         t[t_number+j].tape[tmlen[t_number+j]+1] = (uint8_t)0;
                         // Update Tape Size
                         tmlen[t_number+j]++;
+                        ndtm_reallocations++;
                         // Not necessary to move string head to the left
                     }
                     // move head
                     moveHead(&t[t_number+j].head,status_ndtm.valid_moves.base[j]->head_move);
                     // update current_state for new instances
                     current_state[t_number+j] = *status_ndtm.valid_moves.base[j]->new_state;
+                    if (pr!=NULL) profileMove(pr,&t[i],status_ndtm.valid_moves.base[j]);
+                    if (witness!=NULL) witnessStep(witness,t_number+j,i,status_ndtm.valid_moves.base[j]-t[0].moves);
                 }
                 // moving original instance with the first valid move in non-deterministic state found
                 t[i].tape[t[i].head] = status_ndtm.valid_moves.base[0]->write_symbol;
@@ -196,9 +480,9 @@ int8_t main(int argc, char *argv[]) {
                 // Checking if it is necessary to append a character leftside
                 if (status_ndtm.valid_moves.base[0]->head_move==MOVE_LEFT && t[i].head==0) {
                     // Append Left
-                    t[i].tape = realloc(t[i].tape, (tmlen[i]+1)*sizeof(uint8_t));
+                    t[i].tape = realloc(t[i].tape, (tmlen[i]+2)*sizeof(uint8_t));
                     // shift every character one position right
-                    for (uint16_t aux = tmlen[i]-1;aux>=0;aux--) t[i].tape[aux+1]=t[i].tape[aux];
+                    for (int16_t aux = tmlen[i]-1;aux>=0;aux--) t[i].tape[aux+1]=t[i].tape[aux];
                     // add blank space to first element
                     t[i].tape[0] = ' ';
                     // finish tape string with 0
@@ -207,23 +491,27 @@ int8_t main(int argc, char *argv[]) {
                     t[i].head++;
                     // Update Tape Size
                     tmlen[i]++;
+                    ndtm_reallocations++;
                 }
                 // Checking if it is necessary to append a character rightside
                 if (status_ndtm.valid_moves.base[0]->head_move==MOVE_RIGHT && t[i].head==tmlen[i]-1) {
                     // Append Right
-                    t[i].tape = realloc(t[i].tape, (tmlen[i]+1)*sizeof(uint8_t));
+                    t[i].tape = realloc(t[i].tape, (tmlen[i]+2)*sizeof(uint8_t));
                     // add blank space to last element
                     t[i].tape[tmlen[i]] = ' ';
                     // finish tape string with 0
                     t[i].tape[tmlen[i]+1] = (uint8_t)0;
                     // Update Tape Size
                     tmlen[i]++;
+                    ndtm_reallocations++;
                     // Not necessary to move string head to the left
                 }
                 // move head
                 moveHead(&t[i].head,status_ndtm.valid_moves.base[0]->head_move);
                 // update current_state
                 current_state[i] = *status_ndtm.valid_moves.base[0]->new_state;
+                if (pr!=NULL) profileMove(pr,&t[i],status_ndtm.valid_moves.base[0]);
+                if (witness!=NULL) witnessStep(witness,i,i,status_ndtm.valid_moves.base[0]-t[0].moves);
                 // update t_number
                 t_number=t_number+status_ndtm.valid_moves.length-1;
             }
@@ -235,9 +523,9 @@ int8_t main(int argc, char *argv[]) {
                 // Checking if it is necessary to append a character leftside
                 if (status_ndtm.valid_moves.base[0]->head_move==MOVE_LEFT && t[i].head==0) {
                     // Append Left
-                    t[i].tape = realloc(t[i].tape, (tmlen[i]+1)*sizeof(uint8_t));
+                    t[i].tape = realloc(t[i].tape, (tmlen[i]+2)*sizeof(uint8_t));
                     // shift every character one position right
-                    for (uint16_t aux = tmlen[i]-1;aux>=0;aux--) t[i].tape[aux+1]=t[i].tape[aux];
+                    for (int16_t aux = tmlen[i]-1;aux>=0;aux--) t[i].tape[aux+1]=t[i].tape[aux];
                     // add blank space to first element
                     t[i].tape[0] = ' ';
                     // finish tape string with 0
@@ -246,23 +534,27 @@ int8_t main(int argc, char *argv[]) {
                     t[i].head++;
                     // Update Tape Size
                     tmlen[i]++;
+                    ndtm_reallocations++;
                 }
                 // Checking if it is necessary to append a character rightside
                 if (status_ndtm.valid_moves.base[0]->head_move==MOVE_RIGHT && t[i].head==tmlen[i]-1) {
                     // Append Right
-                    t[i].tape = realloc(t[i].tape, (tmlen[i]+1)*sizeof(uint8_t));
+                    t[i].tape = realloc(t[i].tape, (tmlen[i]+2)*sizeof(uint8_t));
                     // add blank space to last element
                     t[i].tape[tmlen[i]] = ' ';
                     // finish tape string with 0
                     t[i].tape[tmlen[i]+1] = (uint8_t)0;
                     // Update Tape Size
                     tmlen[i]++;
+                    ndtm_reallocations++;
                     // Not necessary to move string head to the left
                 }
                 // move head
                 moveHead(&t[i].head,status_ndtm.valid_moves.base[0]->head_move);
                 // update current_state
                 current_state[i] = *status_ndtm.valid_moves.base[0]->new_state;
+                if (pr!=NULL) profileMove(pr,&t[i],status_ndtm.valid_moves.base[0]);
+                if (witness!=NULL) witnessStep(witness,i,i,status_ndtm.valid_moves.base[0]-t[0].moves);
             }
 
             if (isVerbose) {
@@ -275,118 +567,350 @@ int8_t main(int argc, char *argv[]) {
             i++;
             // resets index on t_number overflow
             if (i>t_number) i=0;
+
+            // saves the whole frontier every checkpoint interval
+            ndtm_steps++;
+            if (checkpoint!=NULL && ndtm_steps%checkpointSteps==0) {
+                checkpointUpdateNDTM(checkpoint,t,flagStatus,current_state,t_number,i,ndtm_steps);
+                checkpointWrite(checkpoint,0);
+            }
+        }
+        if (statsFormat) {
+            // the whole NDTM is reported as a single machine with all its branches
+            MachineStats_t ndtm_stats = {0};
+            ndtm_stats.status = ndtm_status;
+            ndtm_stats.steps = ndtm_steps;
+            ndtm_stats.tape_reallocations = ndtm_reallocations;
+            ndtm_stats.branches = t_number+1;
+            for (uint32_t k = 0; k <= t_number; k++) if (tmlen[k]>ndtm_stats.tape_max) ndtm_stats.tape_max = tmlen[k];
+            ndtm_stats.seconds = statsClock()-startTime;
+            statsReport(statsFile,statsFormat,"NDTM",&ndtm_stats,1,ndtm_stats.seconds);
         }
+        if (witness!=NULL) {
+            witnessFree(witness);
+            free(witness_origin.tape);
+        }
+        if (profile!=NULL) profileReport(profileFile,profile,profileThreads,&t[0],0);
+#ifdef BENCH
+        benchReport(ndtm_steps);
+#endif
         return (int8_t) 0;
     }
+    if (resumeFilename!=NULL) checkpointRestore(checkpointLoad(resumeFilename),t,t_number);
+    if (statsFormat || shards) stats = calloc(t_number+1,sizeof(MachineStats_t));
+    if (checkpointFilename!=NULL) checkpoint = checkpointCreate(checkpointFilename,t,t_number,CHECKPOINT_MODE_DTM,checkpointSteps,checkpointSeconds);
+    if (traceFilename!=NULL) trace = traceOpen(traceFilename,&t[0],traceInterval);
+#ifndef MINGW
+    if (shards) {
+        shardRun(shards,t_number,firstAccept,!outputFormat,runShardMachine,t,stats);
+        arenaFree(arenas,profileThreads);
+        if (statsFormat) statsReport(statsFile,statsFormat,"DTM",stats,t_number,statsClock()-startTime);
+        return (int8_t)0;
+    }
+#endif
 #ifdef OPENMP
     omp_set_num_threads(jobs);
-    uint32_t stepStatus[t_number];
-    uint8_t tmlen[t_number];
-    uint8_t* tm_string_length[t_number];
-    State_t* initial_state[t_number];
-    State_t** initial_state_ptr[t_number];
-    if (firstAccept) {
-        uint8_t stop = 0;
-        #pragma omp parallel for shared(stop)
-        for (uint8_t tm_num = 0; tm_num<t_number; tm_num++) {
-            if (stop) continue;
-            stepStatus[tm_num] = 0;
-            tmlen[tm_num] = strlen(t[tm_num].tape);
-            tm_string_length[tm_num] = &tmlen[tm_num];
-            for (uint8_t i = 0; i < t[tm_num].states_size; i++) {
-                if (t[tm_num].states[i].type==STATE_INITIAL) {initial_state[tm_num]=&(t[tm_num].states[i]);break;}
-            }
-            initial_state_ptr[tm_num]=&initial_state[tm_num];
-            if (isVerbose) {
-                printTapeNum(t[tm_num].tape,t[tm_num].head,tm_num);
-                while (stepStatus[tm_num]==0) {
-                    stepStatus[tm_num] = runStepTM(&t[tm_num].tape,&t[tm_num].head,tm_string_length[tm_num],t[tm_num].states,initial_state_ptr[tm_num],t[tm_num].states_size,t[tm_num].moves,t[tm_num].moves_size);
-                    printTapeNum(t[tm_num].tape,t[tm_num].head,tm_num);
-                }
-            } else {
-                while (stepStatus[tm_num]==0) stepStatus[tm_num] = runStepTM(&t[tm_num].tape,&t[tm_num].head,tm_string_length[tm_num],t[tm_num].states,initial_state_ptr[tm_num],t[tm_num].states_size,t[tm_num].moves,t[tm_num].moves_size);
-            }
-            printTMStatusNum(stepStatus[tm_num],tm_num);
-            if (stepStatus[tm_num]==(uint8_t)1) {
-                #pragma omp atomic write
-                stop=1;
-            }
-        }
-    } else {
-        #pragma omp parallel for
-        for (uint8_t tm_num = 0; tm_num<t_number; tm_num++) {
-            stepStatus[tm_num] = 0;
-            tmlen[tm_num] = strlen(t[tm_num].tape);
-            tm_string_length[tm_num] = &tmlen[tm_num];
-            for (uint8_t i = 0; i < t[tm_num].states_size; i++) {
-                if (t[tm_num].states[i].type==STATE_INITIAL) {initial_state[tm_num]=&(t[tm_num].states[i]);break;}
-            }
-            initial_state_ptr[tm_num]=&initial_state[tm_num];
-            if (isVerbose) {
-                printTapeNum(t[tm_num].tape,t[tm_num].head,tm_num);
-                while (stepStatus[tm_num]==0) {
-                    stepStatus[tm_num] = runStepTM(&t[tm_num].tape,&t[tm_num].head,tm_string_length[tm_num],t[tm_num].states,initial_state_ptr[tm_num],t[tm_num].states_size,t[tm_num].moves,t[tm_num].moves_size);
-                    printTapeNum(t[tm_num].tape,t[tm_num].head,tm_num);
-                }
-            } else {
-                while (stepStatus[tm_num]==0) stepStatus[tm_num] = runStepTM(&t[tm_num].tape,&t[tm_num].head,tm_string_length[tm_num],t[tm_num].states,initial_state_ptr[tm_num],t[tm_num].states_size,t[tm_num].moves,t[tm_num].moves_size);
-            }
-            printTMStatusNum(stepStatus[tm_num],tm_num);
+    #pragma omp parallel for schedule(dynamic)
+    for (uint32_t tm_num = 0; tm_num<t_number; tm_num++) {
+        if (firstAccept && cancelRequested()) {cancelDTM(&t[tm_num],tm_num); continue;}
+        uint8_t stepStatus = (multi!=NULL) ? runMultiDTM(&multi[tm_num],tm_num) : runDTM(&t[tm_num],tm_num);
+        reportDTM(&t[tm_num],tm_num,stepStatus);
+        if (firstAccept && stepStatus==STATUS_ACCEPT) {
+            #pragma omp atomic write
+            cancelRun=1;
         }
     }
-    return (int8_t)0;
 #else
-    uint8_t stepStatus[t_number];
-    if (firstAccept) {
-        uint8_t stop = 0;
-        for (uint8_t tm_num = 0; tm_num<t_number; tm_num++) {
-            if (stop) continue;
-            stepStatus[tm_num] = 0;
-            uint8_t tmlen = strlen(t[tm_num].tape);
-            uint8_t* tm_string_length = &tmlen;
-            State_t* initial_state;
-            State_t** initial_state_ptr;
-            for (uint8_t i = 0; i < t[tm_num].states_size; i++) {
-                if (t[tm_num].states[i].type==STATE_INITIAL) {initial_state=&(t[tm_num].states[i]);break;}
-            }
-            initial_state_ptr=&initial_state;
-            if (isVerbose) {
-                printTapeNum(t[tm_num].tape,t[tm_num].head,tm_num);
-                while (stepStatus[tm_num]==0) {
-                    stepStatus[tm_num] = runStepTM(&t[tm_num].tape,&t[tm_num].head,tm_string_length,t[tm_num].states,initial_state_ptr,t[tm_num].states_size,t[tm_num].moves,t[tm_num].moves_size);
-                    printTapeNum(t[tm_num].tape,t[tm_num].head,tm_num);
-                }
-            } else {
-                while (stepStatus[tm_num]==0) stepStatus[tm_num] = runStepTM(&t[tm_num].tape,&t[tm_num].head,tm_string_length,t[tm_num].states,initial_state_ptr,t[tm_num].states_size,t[tm_num].moves,t[tm_num].moves_size);
-            }
-            printTMStatusNum(stepStatus[tm_num],tm_num);
-            if (stepStatus[tm_num]==(uint8_t)1) stop=1;
+    for (uint32_t tm_num = 0; tm_num<t_number; tm_num++) {
+        if (firstAccept && cancelRun) {cancelDTM(&t[tm_num],tm_num); continue;}
+        uint8_t stepStatus = (multi!=NULL) ? runMultiDTM(&multi[tm_num],tm_num) : runDTM(&t[tm_num],tm_num);
+        reportDTM(&t[tm_num],tm_num,stepStatus);
+        if (firstAccept && stepStatus==STATUS_ACCEPT) cancelRun=1;
+    }
+#endif
+    arenaFree(arenas,profileThreads);
+    lbaFree(lba);
+    breakpointsFree(breakpoints);
+    traceClose(trace);
+    if (checkpoint!=NULL) checkpointWrite(checkpoint,1);
+    if (statsFormat) statsReport(statsFile,statsFormat,"DTM",stats,t_number,statsClock()-startTime);
+    if (profile!=NULL) profileReport(profileFile,profile,profileThreads,&t[0],1);
+#ifdef BENCH
+    uint64_t total_steps = 0;
+    for (uint32_t tm_num = 0; tm_num<t_number; tm_num++) total_steps += (multi!=NULL) ? multi[tm_num].steps : t[tm_num].steps;
+    benchReport(total_steps);
+#endif
+    return (int8_t)0;
+}
+
+/// @brief Runs a single DTM from its current state until it stops or reaches an Accept State
+/// Runs the step loop of the enabled features: runDTMBreak, runDTMTraced or runDTMPlain
+/// @param t        TM_t object to be simulated (it may be resumed from a checkpoint)
+/// @param tm_num   TM Number in the running list
+/// @return         1, if DTM is in a Valid Accept State
+///                 2, if DTM stops
+///                 4, if cancelled after another machine accepted (first accept mode)
+///                 7, if its tape would be longer than 255 cells
+uint8_t runDTM(TM_t* t, uint32_t tm_num) {
+    if (lba!=NULL) return runLBA(t,tm_num);
+    uint8_t tmlen = strlen(t->tape), initial_tmlen = tmlen;
+    double start = (stats!=NULL) ? statsClock() : 0;
+    if (t->status!=STATUS_SGMOVE) {
+        // finished before a resumed checkpoint
+        if (stats!=NULL) runDTMStats(t,tm_num,tmlen,tmlen,start);
+        return t->status;
+    }
+    TapeArena_t* arena = (arenas!=NULL) ? arenaThread(arenas) : NULL;
+    if (arena!=NULL) arenaBegin(arena,t,tmlen);
+    // every feature has its own step loop, so the plain loop has no per step feature checks
+    if (breakpoints!=NULL) runDTMBreak(t,tm_num,&tmlen);
+    else if (isVerbose || trace!=NULL || profile!=NULL || checkpoint!=NULL || arena==NULL) runDTMTraced(t,tm_num,&tmlen);
+    else runDTMPlain(t,&tmlen);
+    if (arena!=NULL) arenaEnd(arena,t,tmlen);
+    if (stats!=NULL) runDTMStats(t,tm_num,initial_tmlen,tmlen,start);
+    return t->status;
+}
+
+/// @brief Step loop of runDTM without verbose mode, traces, profiles, checkpoints or breakpoints
+/// Steps run in chunks between first accept polls (a single chunk without first accept mode)
+/// @param t        TM_t object with its tape in the tape arena of the thread
+/// @param tmlen    Tape Length Pointer
+void runDTMPlain(TM_t* t, uint8_t* tmlen) {
+    Move_t* last_move;
+    Sweep_t* s = sweep;
+    uint64_t chunk = firstAccept ? CANCEL_POLL_STEPS : UINT64_MAX;
+    while (t->status==STATUS_SGMOVE) {
+        for (uint64_t k = 0; k<chunk && t->status==STATUS_SGMOVE; k++) {
+            if (s!=NULL && sweepRun(s,t,*tmlen,0)) continue;
+            t->status = arenaStepTM(t,tmlen,&last_move);
+            if (t->status==STATUS_SGMOVE) t->steps++;
         }
-    } else {
-        for (uint8_t tm_num = 0; tm_num<t_number; tm_num++) {
-            stepStatus[tm_num] = 0;
-            uint8_t tmlen = strlen(t[tm_num].tape);
-            uint8_t* tm_string_length = &tmlen;
-            State_t* initial_state;
-            State_t** initial_state_ptr;
-            for (uint8_t i = 0; i < t[tm_num].states_size; i++) {
-                if (t[tm_num].states[i].type==STATE_INITIAL) {initial_state=&(t[tm_num].states[i]);break;}
-            }
-            initial_state_ptr=&initial_state;
-            if (isVerbose) {
-                printTapeNum(t[tm_num].tape,t[tm_num].head,tm_num);
-                while (stepStatus[tm_num]==0) {
-                    stepStatus[tm_num] = runStepTM(&t[tm_num].tape,&t[tm_num].head,tm_string_length,t[tm_num].states,initial_state_ptr,t[tm_num].states_size,t[tm_num].moves,t[tm_num].moves_size);
-                    printTapeNum(t[tm_num].tape,t[tm_num].head,tm_num);
-                }
-            } else {
-                while (stepStatus[tm_num]==0) stepStatus[tm_num] = runStepTM(&t[tm_num].tape,&t[tm_num].head,tm_string_length,t[tm_num].states,initial_state_ptr,t[tm_num].states_size,t[tm_num].moves,t[tm_num].moves_size);
+        if (firstAccept && t->status==STATUS_SGMOVE && cancelRequested()) t->status = STATUS_CANCEL;
+    }
+}
+
+/// @brief Step loop of runDTM that prints every step in verbose mode, records it in the trace file,
+/// counts its transitions when profiling and saves its snapshot every checkpoint interval
+/// @param t        TM_t object to be simulated
+/// @param tm_num   TM Number in the running list
+/// @param tmlen    Tape Length Pointer
+void runDTMTraced(TM_t* t, uint32_t tm_num, uint8_t* tmlen) {
+    uint64_t checkpoint_countdown = checkpointSteps;
+    Move_t* last_move;
+    uint8_t in_arena = (arenas!=NULL);
+    TraceBuffer_t tb;
+    traceBegin(&tb,trace,tm_num,t,*tmlen);
+    Profile_t* pr = (profile!=NULL) ? profileThread(profile) : NULL;
+    ProfileRun_t run = {NULL, 0};
+    uint32_t cancel_countdown = CANCEL_POLL_STEPS;
+    if (isVerbose) printTapeNum(t->tape,t->head,tm_num);
+    while (t->status==STATUS_SGMOVE) {
+        if (firstAccept && --cancel_countdown==0) {
+            cancel_countdown = CANCEL_POLL_STEPS;
+            if (cancelRequested()) {t->status = STATUS_CANCEL; break;}
+        }
+        if (in_arena) t->status = arenaStepTM(t,tmlen,&last_move);
+        else t->status = runStepTM(&t->tape,&t->head,tmlen,t->states,&t->current_state,t->states_size,t->moves,t->moves_size,t->index,&last_move);
+        if (t->status==STATUS_SGMOVE) {
+            t->steps++;
+            if (tb.trace!=NULL) traceStep(&tb,last_move,t->steps,t,*tmlen);
+            if (pr!=NULL) profileStep(pr,&run,t,last_move);
+            if (checkpoint!=NULL && --checkpoint_countdown==0) {
+                checkpointUpdate(checkpoint,t,tm_num);
+                checkpointWrite(checkpoint,0);
+                checkpoint_countdown = checkpointSteps;
             }
-            printTMStatusNum(stepStatus[tm_num],tm_num);
         }
+        if (isVerbose) printTapeNum(t->tape,t->head,tm_num);
     }
-    return (int8_t)0;
+    traceEnd(&tb,t->steps,t->status);
+    if (pr!=NULL) profileRunEnd(pr,&run,t);
+    if (checkpoint!=NULL) {
+        checkpointUpdate(checkpoint,t,tm_num);
+        checkpointWrite(checkpoint,0);
+    }
+}
+
+/// @brief Step loop of runDTM with breakpoints and watchpoints, opening the inspector on every hit
+/// Prints every step in verbose mode, runs with breakpoints have no traces, profiles or checkpoints
+/// @param t        TM_t object to be simulated
+/// @param tm_num   TM Number in the running list
+/// @param tmlen    Tape Length Pointer
+void runDTMBreak(TM_t* t, uint32_t tm_num, uint8_t* tmlen) {
+    Move_t* last_move;
+    uint8_t in_arena = (arenas!=NULL);
+    // cells grown to the left, watched cells are counted from the first cell of the script tape
+    int32_t origin = 0;
+    uint32_t cancel_countdown = CANCEL_POLL_STEPS;
+    char reason[BREAKPOINT_REASON_SIZE];
+    if (isVerbose) printTapeNum(t->tape,t->head,tm_num);
+    while (t->status==STATUS_SGMOVE) {
+        if (firstAccept && --cancel_countdown==0) {
+            cancel_countdown = CANCEL_POLL_STEPS;
+            if (cancelRequested()) {t->status = STATUS_CANCEL; break;}
+        }
+        int32_t cell = (int32_t)t->head-origin;
+        uint8_t head = t->head;
+        if (in_arena) t->status = arenaStepTM(t,tmlen,&last_move);
+        else t->status = runStepTM(&t->tape,&t->head,tmlen,t->states,&t->current_state,t->states_size,t->moves,t->moves_size,t->index,&last_move);
+        if (isVerbose) printTapeNum(t->tape,t->head,tm_num);
+        if (t->status!=STATUS_SGMOVE) break;
+        t->steps++;
+        if (last_move->head_move==MOVE_LEFT && head==0) origin++;
+        if (breakpointHit(breakpoints,t,last_move,cell,reason)) {
+            // machines running in other threads wait for the console
+#ifdef OPENMP
+            #pragma omp critical (inspector)
 #endif
+            breakpointInspect(t,tm_num,reason);
+        }
+    }
+}
+
+/// @brief Runs a single linear-bounded DTM with its tape in the LBA slab, the whole run is a single
+/// lbaRun call unless it is split to print every step or to poll the first accept flag
+/// @param t        TM_t object to be simulated
+/// @param tm_num   TM Number in the running list
+/// @return         1, if DTM is in a Valid Accept State
+///                 2, if DTM stops
+///                 4, if cancelled after another machine accepted (first accept mode)
+///                 6, if DTM runs off an end of its tape
+uint8_t runLBA(TM_t* t, uint32_t tm_num) {
+    double start = (stats!=NULL) ? statsClock() : 0;
+    uint64_t chunk = isVerbose ? 1 : (firstAccept ? CANCEL_POLL_STEPS : UINT64_MAX);
+    if (isVerbose) printTapeNum(t->tape,t->head,tm_num);
+    while (t->status==STATUS_SGMOVE) {
+        if (firstAccept && cancelRequested()) {t->status = STATUS_CANCEL; break;}
+        t->status = lbaRun(t,lba->bound,chunk,NULL);
+        if (isVerbose) printTapeNum(t->tape,t->head,tm_num);
+    }
+    if (stats!=NULL) runDTMStats(t,tm_num,lba->bound,lba->bound,start);
+    return t->status;
+}
+
+/// @brief Runs a single Multi-Tape DTM until it stops or reaches an Accept State
+/// Prints every step in verbose mode
+/// @param m        MultiTM_t object to be simulated
+/// @param tm_num   TM Number in the running list
+/// @return         1, if DTM is in a Valid Accept State
+///                 2, if DTM stops
+///                 4, if cancelled after another machine accepted (first accept mode)
+uint8_t runMultiDTM(MultiTM_t* m, uint32_t tm_num) {
+    double start = (stats!=NULL) ? statsClock() : 0;
+    uint32_t cancel_countdown = CANCEL_POLL_STEPS;
+    if (isVerbose) printMultiTapeNum(m,tm_num);
+    while (m->status==STATUS_SGMOVE) {
+        if (firstAccept && --cancel_countdown==0) {
+            cancel_countdown = CANCEL_POLL_STEPS;
+            if (cancelRequested()) {m->status = STATUS_CANCEL; break;}
+        }
+        m->status = runStepMultiTM(m,NULL);
+        if (m->status==STATUS_SGMOVE) m->steps++;
+        if (isVerbose) printMultiTapeNum(m,tm_num);
+    }
+    if (stats!=NULL) {
+        stats[tm_num].status = m->status;
+        stats[tm_num].steps = m->steps;
+        stats[tm_num].tape_max = multiTMTapeMax(m);
+        stats[tm_num].tape_reallocations = m->reallocations;
+        stats[tm_num].branches = 1;
+        stats[tm_num].seconds = statsClock()-start;
+    }
+    return m->status;
+}
+
+#ifndef MINGW
+/// @brief Runs a machine in a shard worker process (see shardRun)
+/// @param context  TM_t array of every machine
+/// @param tm_num   TM Number in the running list
+/// @param result   Output Statistics of the machine
+void runShardMachine(void* context, uint32_t tm_num, MachineStats_t* result) {
+    TM_t* t = context;
+    uint8_t status = (multi!=NULL) ? runMultiDTM(&multi[tm_num],tm_num) : runDTM(&t[tm_num],tm_num);
+    // the coordinator prints status lines, workers write result records
+    if (outputFormat) reportDTM(&t[tm_num],tm_num,status);
+    *result = stats[tm_num];
+}
+#endif
+
+/// @brief Reads the first accept cancellation flag, written by the thread of the first accepted machine
+/// Running machines poll it every CANCEL_POLL_STEPS steps, so the step loop never synchronizes
+/// @return 1 once any machine is in an Accept State (first accept mode), 0 elsewhere
+uint8_t cancelRequested() {
+    uint8_t cancel;
+#ifdef OPENMP
+    #pragma omp atomic read
+#endif
+    cancel = cancelRun;
+    return cancel;
+}
+
+/// @brief Discards a machine that has not started before a first accept
+/// Its status is STATUS_CANCEL, so it is reported as cancelled and runs again when resumed from a checkpoint
+/// @param t        TM_t object of the machine
+/// @param tm_num   TM Number in the running list
+void cancelDTM(TM_t* t, uint32_t tm_num) {
+    if (multi!=NULL) multi[tm_num].status = STATUS_CANCEL; else t->status = STATUS_CANCEL;
+    if (stats!=NULL) stats[tm_num].status = STATUS_CANCEL;
+    if (outputFormat) reportDTM(t,tm_num,STATUS_CANCEL);
+}
+
+/// @brief Reports a finished machine: a result record with its final tape when --output is used,
+/// a status line elsewhere
+/// @param t        TM_t object of the machine
+/// @param tm_num   TM Number in the running list
+/// @param status   Final Status
+void reportDTM(TM_t* t, uint32_t tm_num, uint8_t status) {
+    if (!outputFormat) {
+        printTMStatusNum(status,tm_num);
+        return;
+    }
+    OutputRecord_t record;
+    record.machine = tm_num;
+    record.status = status;
+    if (multi!=NULL) {
+        MultiTM_t* m = &multi[tm_num];
+        record.steps = m->steps;
+        record.state = m->current_state->name;
+        record.tapes = m->tapes_number;
+        for (uint8_t k = 0; k < m->tapes_number; k++) {
+            Tape_t* tape = &m->tapes[k];
+            record.cells[k] = &tape->cells[tape->left];
+            record.length[k] = tape->right-tape->left;
+            record.head[k] = tape->head-tape->left;
+        }
+    } else {
+        record.steps = t->steps;
+        record.state = t->current_state->name;
+        record.tapes = 1;
+        record.cells[0] = t->tape;
+        record.length[0] = strlen(t->tape);
+        record.head[0] = t->head;
+    }
+#ifdef OPENMP
+    #pragma omp critical (output)
+#endif
+    {
+        outputRecord(outputFile,outputFormat,&record);
+        // shard workers share the output file, so each record is flushed in a single write
+        if (shards) fflush(outputFile);
+    }
+}
+
+/// @brief Fills the statistics of a finished DTM
+/// Tapes only grow one blank cell at a time, so tape counters come from the tape lengths
+/// @param t                Finished TM_t object
+/// @param tm_num           TM Number in the running list
+/// @param initial_tmlen    Tape Length when the simulation started
+/// @param tmlen            Final Tape Length
+/// @param start            statsClock() value when the simulation started
+void runDTMStats(TM_t* t, uint32_t tm_num, uint8_t initial_tmlen, uint8_t tmlen, double start) {
+    stats[tm_num].status = t->status;
+    stats[tm_num].steps = t->steps;
+    stats[tm_num].tape_max = tmlen;
+    stats[tm_num].tape_reallocations = tmlen-initial_tmlen;
+    stats[tm_num].branches = 1;
+    stats[tm_num].seconds = statsClock()-start;
 }
 
 /// @brief Parse Main Function Arguments (flags) and outputs an Array of DTMs
@@ -396,6 +920,7 @@ int8_t main(int argc, char *argv[]) {
 /// @param TM TM_t** pointer with DTMs
 /// @param TM_number length of TM pointer with TM quantity
 void parseArgs(int argc, char *argv[]) {
+    const char* value;
     for (uint16_t i=0; i<argc; i++) {
         if (strcmp(argv[i], "-V" ) == 0 || strcmp(argv[i], "--version") == 0) {
 #ifdef MINGW
@@ -441,13 +966,58 @@ void parseArgs(int argc, char *argv[]) {
             printf(" -h, -H    --help                                   Display Help and Commands\n");
             printf("   -r      --read_file             <filename>       Start Turing Machine from a Script File\n");
             printf("   -v      --verbose                                Print every Turing Machine step\n");
-            printf("   -f      --first_accept                           When running Multiple Turing Machines, stops new threads if any Turing Machine is in an Accept State\n");
+            printf("   -f      --first_accept                           When running Multiple Turing Machines, cancels running and queued Turing Machines once any Turing Machine is in an Accept State\n");
 #ifdef OPENMP
             printf("   -j      --jobs                 <jobs_number>     Triggers Multiple Threads mode for Parallel Simulations (only for OpenMP support)\n");
 #endif
+#ifdef OPENMP
+            printf("           --pin                                    Pin every thread to a CPU (Linux only)\n");
+#endif
+#ifndef MINGW
+            printf("           --shards                <processes>      Run DTM machines in worker processes, restarting crashed workers\n");
+#endif
+            printf("           --count                 <steps>          Count accepting, stopped and running NDTM computations within a step bound\n");
+            printf("           --sample                <walks>          Estimate the accepting fraction of NDTM computations with random walks\n");
+            printf("           --seed                  <seed>           Random walks seed (default 1)\n");
+            printf("           --sample_steps          <steps>          Step bound of every random walk (default 1000000)\n");
+            printf("           --output                <jsonl|csv|binary>  Write a record per DTM with its status, steps, state, head and trimmed final tape\n");
+            printf("           --output_file           <filename>       Write result records to a file instead of the console\n");
+            printf("           --trace                 <filename>       Record a compact binary trace of every DTM step (see tmsim replay)\n");
+            printf("           --trace_interval        <steps>          Steps between full tape keyframes in trace files (default 4096)\n");
+            printf("           --checkpoint            <filename>       Save the whole simulation periodically to a checkpoint file\n");
+            printf("           --checkpoint_steps      <steps>          Steps of each Turing Machine between checkpoints (default 1000000)\n");
+            printf("           --checkpoint_seconds    <seconds>        Minimum time between two checkpoint file writes\n");
+            printf("           --resume                <filename>       Resume a simulation from a checkpoint file (same script required)\n");
+            printf("           --stats                 <json|csv>       Report steps, tape extent, reallocations, branches and time of every Turing Machine\n");
+            printf("           --stats_file            <filename>       Write the statistics report to a file instead of the console\n");
+            printf("           --profile                                Report transition and state hits by script line, head moves and longest state runs\n");
+            printf("           --profile_file          <filename>       Write the profile report to a file instead of the console\n");
+            printf("           --optimize                               Remove unused moves, unreachable and dead states, fuse waiting moves and merge equivalent states before a DTM run\n");
+            printf("           --optimize_verify                        Optimize and check that every machine of the script has the same result with both automata\n");
+            printf("           --optimize_dead                          Optimize and also remove states that can not reach an accept state (rejecting machines may stop earlier)\n");
+            printf("           --no_sweep                               Step cell by cell in states that rewrite the same symbol and keep moving the head\n");
+            printf("           --lba                   <cells>          Linear-bounded DTMs: fixed tapes of the given cells (0 for the longest tape), running off an end stops the machine\n");
+            printf("           --enumerate             <symbols>:<length>  Run the first DTM on every input up to the length and count accepted, rejected, tape full and looping inputs\n");
+            printf("           --enumerate_steps       <steps>          Step bound of every enumerated input (default 100000)\n");
+            printf("           --debug                 <machine>        Step a DTM forward and backward, jump to any step or back to the last visit of a state\n");
+            printf("           --break                 <state>          Open the inspector when a DTM enters the state (repeatable)\n");
+            printf("           --watch                 <cell>           Open the inspector when a DTM writes a new symbol to the cell (repeatable)\n");
+            printf("           --break_step            <steps>          Open the inspector when a DTM reaches the step\n");
+            printf("           --no_witness                             Do not record NDTM moves to print the accepting path in non verbose mode\n");
+            printf("   -A      --auto                                   Run deterministic automata in DTM mode and the others in NDTM mode (default without a mode)\n");
             printf("  -DTM     --deterministic                          Deterministic Single Tape Turing Machine Mode\n");
             printf(" -NDTM     --non_deterministic                      Non Deterministic Single Tape Turing Machine Mode\n");
             // printf("  -i      --interactive                   Run Turing Machine in REPL mode (WIP)\n");
+            printf("\n");
+            printf(" Subcommand                                         Meaning\n");
+            printf(" replay <trace_file> [-m <machine>] [-s <step>] [-c <count>] [-l]\n");
+            printf("                                                    Render trace steps, seeking through keyframes\n");
+            printf(" beaver <states> [--symbols <n>] [--steps <n>] [--shard <i>/<n>] [--threads <n>] [--undecided <file>]\n");
+            printf("                                                    Enumerate every machine of the given states to find busy beaver records\n");
+#ifndef MINGW
+            printf(" serve [--socket <path>] [--threads <n>] [--max_steps <n>] [--load <name>=<script>]\n");
+            printf("                                                    Keep automata loaded and answer requests from stdin or a Unix socket\n");
+#endif
             exit(0);
         }
         if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) isVerbose=1;
@@ -470,23 +1040,229 @@ void parseArgs(int argc, char *argv[]) {
         if (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--read_file") == 0) {
             const char *filename = argv[i+1];
             p = parseFile(filename);
+            // tapes are printed with the symbol names of the script
+            alphabetDisplay(p.alphabet);
             TM_defined=1;
             // TO DO: make a free parser function to deallocate memory in Parser_t object
-            
-#ifdef MINGW
-            // Get handle to the console output
-            HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-            // Write the string to the console
-            WriteConsoleW(hConsole, PROGRAM_NAME, wcslen(PROGRAM_NAME), NULL, NULL);
-            WriteConsoleW(hConsole, AUTHOR_NAME, wcslen(AUTHOR_NAME), NULL, NULL);
-#else
-            printf(PROGRAM_NAME);
-            printf(AUTHOR_NAME);
-#endif
-            printf("\n");
         }
+        if ((value = optionValue(argc,argv,&i,"--trace"))) traceFilename=value;
+        if ((value = optionValue(argc,argv,&i,"--trace_interval"))) {
+            char *end_ptr;
+            long val = strtol(value,&end_ptr,10);
+            if (end_ptr == value || val <= 0) {
+                printf("Trace interval must be a positive number of steps.\n");
+                exit(1);
+            }
+            traceInterval=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--checkpoint"))) checkpointFilename=value;
+        if ((value = optionValue(argc,argv,&i,"--checkpoint_steps"))) {
+            char *end_ptr;
+            long long val = strtoll(value,&end_ptr,10);
+            if (end_ptr == value || val <= 0) {
+                printf("Checkpoint interval must be a positive number of steps.\n");
+                exit(1);
+            }
+            checkpointSteps=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--checkpoint_seconds"))) {
+            char *end_ptr;
+            long val = strtol(value,&end_ptr,10);
+            if (end_ptr == value || val < 0) {
+                printf("Checkpoint time interval must be a number of seconds.\n");
+                exit(1);
+            }
+            checkpointSeconds=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--resume"))) {
+            resumeFilename=value;
+            // keeps saving progress in the resumed checkpoint by default
+            if (checkpointFilename==NULL) checkpointFilename=value;
+        }
+        if ((value = optionValue(argc,argv,&i,"--stats"))) {
+            if (strcmp(value,"json") == 0) statsFormat=STATS_FORMAT_JSON;
+            else if (strcmp(value,"csv") == 0) statsFormat=STATS_FORMAT_CSV;
+            else {
+                printf("Statistics format must be json or csv.\n");
+                exit(1);
+            }
+        }
+        if ((value = optionValue(argc,argv,&i,"--stats_file"))) {
+            statsFile = fopen(value,"w");
+            if (statsFile == NULL) {
+                fprintf(stderr, "Error creating file %s\n", value);
+                exit(1);
+            }
+        }
+        if (strcmp(argv[i], "--profile") == 0) profileEnabled=1;
+        if ((value = optionValue(argc,argv,&i,"--profile_file"))) {
+            profileEnabled=1;
+            profileFile = fopen(value,"w");
+            if (profileFile == NULL) {
+                fprintf(stderr, "Error creating file %s\n", value);
+                exit(1);
+            }
+        }
+        if (strcmp(argv[i], "--optimize") == 0) optimizeEnabled=1;
+        if (strcmp(argv[i], "--optimize_verify") == 0) optimizeEnabled=optimizeCheck=1;
+        if (strcmp(argv[i], "--optimize_dead") == 0) optimizeEnabled=optimizeDead=1;
+        if (strcmp(argv[i], "--no_sweep") == 0) sweepEnabled=0;
+        if (strcmp(argv[i], "--no_witness") == 0) witnessEnabled=0;
+        if (strcmp(argv[i], "--pin") == 0) arenaPin=1;
+#ifndef MINGW
+        if ((value = optionValue(argc,argv,&i,"--shards"))) {
+            char *end_ptr;
+            long val = strtol(value,&end_ptr,10);
+            if (end_ptr == value || val <= 0 || val > 4096) {
+                printf("Shards must be a number of processes between 1 and 4096.\n");
+                exit(1);
+            }
+            shards=val;
+        }
+#endif
+        if (strcmp(argv[i], "-A") == 0 || strcmp(argv[i], "--auto") == 0) AUTO_mode=1;
         if (strcmp(argv[i], "-DTM") == 0 || strcmp(argv[i], "--deterministic") == 0) DTM_mode=1;
         if (strcmp(argv[i], "-NDTM") == 0 || strcmp(argv[i], "--non_deterministic") == 0) NDTM_mode=1;
-        if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--first_acceptc") == 0) firstAccept=1;
+        if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--first_accept") == 0) firstAccept=1;
+        if ((value = optionValue(argc,argv,&i,"--count"))) {
+            char *end_ptr;
+            long long val = strtoll(value,&end_ptr,10);
+            if (end_ptr == value || val < 0) {
+                printf("Path counting needs a step bound.\n");
+                exit(1);
+            }
+            countEnabled=1;
+            countSteps=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--enumerate"))) enumerateText=value;
+        if ((value = optionValue(argc,argv,&i,"--enumerate_steps"))) {
+            char *end_ptr;
+            long long val = strtoll(value,&end_ptr,10);
+            if (end_ptr == value || val <= 0) {
+                printf("Input enumeration needs a positive step bound.\n");
+                exit(1);
+            }
+            enumerateSteps=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--debug"))) {
+            char *end_ptr;
+            long long val = strtoll(value,&end_ptr,10);
+            if (end_ptr == value || val < 0 || val > UINT32_MAX) {
+                printf("The debugger needs a Turing Machine number.\n");
+                exit(1);
+            }
+            debugEnabled=1;
+            debugMachine=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--break"))) {
+            breakNames = realloc(breakNames,(breakNamesSize+1)*sizeof(char*));
+            breakNames[breakNamesSize++] = (char*) value;
+        }
+        if ((value = optionValue(argc,argv,&i,"--watch"))) {
+            char *end_ptr;
+            long val = strtol(value,&end_ptr,10);
+            if (end_ptr == value || val < INT32_MIN || val > INT32_MAX) {
+                printf("Watchpoints need a tape cell.\n");
+                exit(1);
+            }
+            watchCells = realloc(watchCells,(watchCellsSize+1)*sizeof(int32_t));
+            watchCells[watchCellsSize++] = val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--break_step"))) {
+            char *end_ptr;
+            long long val = strtoll(value,&end_ptr,10);
+            if (end_ptr == value || val <= 0) {
+                printf("Step breakpoints need a positive number of steps.\n");
+                exit(1);
+            }
+            breakStep=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--lba"))) {
+            char *end_ptr;
+            long val = strtol(value,&end_ptr,10);
+            if (end_ptr == value || val < 0 || val > UINT8_MAX) {
+                printf("Linear-bounded mode bound must be between 0 and 255 cells.\n");
+                exit(1);
+            }
+            lbaEnabled=1;
+            lbaBound=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--sample"))) {
+            char *end_ptr;
+            long long val = strtoll(value,&end_ptr,10);
+            if (end_ptr == value || val <= 0) {
+                printf("Random walks need a positive number of walks.\n");
+                exit(1);
+            }
+            sampleWalksNumber=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--seed"))) {
+            char *end_ptr;
+            unsigned long long val = strtoull(value,&end_ptr,10);
+            if (end_ptr == value) {
+                printf("Random walks seed must be a number.\n");
+                exit(1);
+            }
+            sampleSeed=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--sample_steps"))) {
+            char *end_ptr;
+            long long val = strtoll(value,&end_ptr,10);
+            if (end_ptr == value || val <= 0) {
+                printf("Random walks need a positive step bound.\n");
+                exit(1);
+            }
+            sampleSteps=val;
+        }
+        if ((value = optionValue(argc,argv,&i,"--output"))) {
+            if (strcmp(value,"jsonl") == 0) outputFormat=OUTPUT_FORMAT_JSONL;
+            else if (strcmp(value,"csv") == 0) outputFormat=OUTPUT_FORMAT_CSV;
+            else if (strcmp(value,"binary") == 0) outputFormat=OUTPUT_FORMAT_BINARY;
+            else {
+                printf("Output format must be jsonl, csv or binary.\n");
+                exit(1);
+            }
+        }
+        if ((value = optionValue(argc,argv,&i,"--output_file"))) {
+            outputFile = fopen(value,"wb");
+            if (outputFile == NULL) {
+                fprintf(stderr, "Error creating file %s\n", value);
+                exit(1);
+            }
+        }
+    }
+    // result records written to the console replace every other message
+    if (TM_defined && !(outputFormat && outputFile==NULL)) {
+#ifdef MINGW
+        // Get handle to the console output
+        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+        // Write the string to the console
+        WriteConsoleW(hConsole, PROGRAM_NAME, wcslen(PROGRAM_NAME), NULL, NULL);
+        WriteConsoleW(hConsole, AUTHOR_NAME, wcslen(AUTHOR_NAME), NULL, NULL);
+#else
+        printf(PROGRAM_NAME);
+        printf(AUTHOR_NAME);
+#endif
+        printf("\n");
+    }
+};
+
+/// @brief Returns the value of a long option given as "--option=value" or "--option value"
+/// Exits program if the option is given without a value
+/// @param argc     Main Function argc integer
+/// @param argv     Main Function argv char* pointer
+/// @param i        Index of the current argument, skips the value argument when it is separated
+/// @param option   Long option name (with leading dashes)
+/// @return         Option value, NULL if argv[*i] is not this option
+const char* optionValue(int argc, char *argv[], uint16_t* i, const char* option) {
+    size_t length = strlen(option);
+    if (strncmp(argv[*i], option, length) != 0) return NULL;
+    if (argv[*i][length] == '=') return &argv[*i][length+1];
+    if (argv[*i][length] != 0) return NULL;
+    if ((*i)+1 >= argc) {
+        printf("Option %s requires a value.\n", option);
+        exit(1);
     }
-};
\ No newline at end of file
+    (*i)++;
+    return argv[*i];
+}
\ No newline at end of file
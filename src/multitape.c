@@ -0,0 +1,172 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <multitape.h>
+#include <alphabet.h>
+
+/// @brief Allocates a tape with free space on both sides of its initial string
+/// @param tape     Tape_t to be initialized
+/// @param string   Initial Tape String (at least a blank cell is used)
+/// @param head     0-based Head Index in string
+static void tapeCreate(Tape_t* tape, uint8_t* string, uint32_t head) {
+    uint32_t length = strlen(string);
+    if (length == 0) {
+        string = (uint8_t*)" ";
+        length = 1;
+    }
+    tape->capacity = TAPE_CAPACITY_MIN;
+    while (tape->capacity < 2*length) tape->capacity *= 2;
+    tape->cells = malloc(tape->capacity*sizeof(uint8_t));
+    tape->left = (tape->capacity-length)/2;
+    tape->right = tape->left+length;
+    memcpy(&tape->cells[tape->left], string, length);
+    tape->head = tape->left+head;
+}
+
+/// @brief Doubles the capacity of a tape, keeping its used cells in the middle of the new buffer
+/// @param tape Tape_t to be grown
+static void tapeGrow(Tape_t* tape) {
+    uint32_t length = tape->right-tape->left;
+    uint32_t capacity = tape->capacity*2;
+    uint8_t* cells = malloc(capacity*sizeof(uint8_t));
+    uint32_t left = (capacity-length)/2;
+    memcpy(&cells[left], &tape->cells[tape->left], length);
+    free(tape->cells);
+    tape->head = tape->head-tape->left+left;
+    tape->cells = cells;
+    tape->capacity = capacity;
+    tape->left = left;
+    tape->right = left+length;
+}
+
+/// @brief Generates a Multi-Tape Turing Machine from a DTM, whose tape becomes the first tape
+/// The other tapes start with a single blank cell, every automaton pointer is taken from the DTM
+/// @param t            TM_t created by DTM() with a multi-tape automaton
+/// @param tapes_number Number of Tapes
+/// @return             MultiTM_t object
+MultiTM_t multiTM(TM_t* t, uint8_t tapes_number) {
+    MultiTM_t m;
+    m.tapes_number = tapes_number;
+    tapeCreate(&m.tapes[0], t->tape, t->head);
+    for (uint8_t k = 1; k < tapes_number; k++) tapeCreate(&m.tapes[k], (uint8_t*)" ", 0);
+    m.states = t->states;
+    m.states_size = t->states_size;
+    m.moves = t->moves;
+    m.moves_size = t->moves_size;
+    // groups moves by current state (counting sort keeps script order inside each state)
+    m.state_first = calloc(m.states_size+1, sizeof(uint32_t));
+    m.state_moves = malloc((m.moves_size+1)*sizeof(Move_t*));
+    for (uint32_t i = 0; i < m.moves_size; i++) m.state_first[m.moves[i].current_state-m.states+1]++;
+    for (uint32_t i = 0; i < m.states_size; i++) m.state_first[i+1] += m.state_first[i];
+    uint32_t* next = malloc((m.states_size+1)*sizeof(uint32_t));
+    memcpy(next, m.state_first, (m.states_size+1)*sizeof(uint32_t));
+    for (uint32_t i = 0; i < m.moves_size; i++) m.state_moves[next[m.moves[i].current_state-m.states]++] = &m.moves[i];
+    free(next);
+    m.current_state = t->current_state;
+    m.steps = t->steps;
+    m.reallocations = 0;
+    m.status = t->status;
+    return m;
+}
+
+/// @brief Checks state type from a Multi-Tape DTM. If running, writes every tape, moves every head
+/// and goes to the next state
+/// @param m            Multi-Tape DTM
+/// @param last_move    Output Pointer to the Move applied in this step, ignored if NULL
+/// @return             0, if valid state transition.
+///                     1, if DTM is in a Valid Accept State
+///                     2, if DTM stops
+uint8_t runStepMultiTM(MultiTM_t* m, Move_t** last_move) {
+    // Returns 1 if TM is in an Accept State
+    if (m->current_state->type==STATE_ACCEPT) return STATUS_ACCEPT;
+    // packs the symbols under every head
+    uint64_t key = 0;
+    for (uint8_t k = 0; k < m->tapes_number; k++) key |= ((uint64_t)m->tapes[k].cells[m->tapes[k].head])<<(8*k);
+    uint32_t state = m->current_state-m->states;
+    Move_t* step_move = NULL;
+    for (uint32_t i = m->state_first[state]; i < m->state_first[state+1]; i++) {
+        if (m->state_moves[i]->read_key==key) {step_move = m->state_moves[i]; break;}
+    }
+    // If no move valid, returns 2
+    if (step_move==NULL) return STATUS_NOMOVE;
+    for (uint8_t k = 0; k < m->tapes_number; k++) {
+        Tape_t* tape = &m->tapes[k];
+        tape->cells[tape->head] = (uint8_t)(step_move->write_key>>(8*k));
+        switch ((step_move->head_moves>>(2*k))&3) {
+        case MOVE_LEFT:
+            if (tape->head==tape->left) {
+                if (tape->left==0) {tapeGrow(tape); m->reallocations++;}
+                tape->cells[--tape->left] = ' ';
+            }
+            tape->head--;
+            break;
+        case MOVE_RIGHT:
+            if (tape->head==tape->right-1) {
+                if (tape->right==tape->capacity) {tapeGrow(tape); m->reallocations++;}
+                tape->cells[tape->right++] = ' ';
+            }
+            tape->head++;
+            break;
+        // MOVE_WAIT elsewhere (does nothing)
+        default:
+            break;
+        }
+    }
+    m->current_state = step_move->new_state;
+    if (last_move!=NULL) *last_move = step_move;
+    return STATUS_SGMOVE;
+}
+
+/// @brief Maximum extent of the tapes of a Multi-Tape DTM
+/// @param m    Multi-Tape DTM
+/// @return     Length of its longest tape in cells
+uint32_t multiTMTapeMax(MultiTM_t* m) {
+    uint32_t tape_max = 0;
+    for (uint8_t k = 0; k < m->tapes_number; k++) {
+        if (m->tapes[k].right-m->tapes[k].left > tape_max) tape_max = m->tapes[k].right-m->tapes[k].left;
+    }
+    return tape_max;
+}
+
+/// @brief Print every tape of a Multi-Tape DTM with its head, like printTapeNum
+/// @param m        Multi-Tape DTM
+/// @param TM_num   TM Number in the running list
+void printMultiTapeNum(MultiTM_t* m, uint32_t TM_num) {
+    printf("Turing Machine %u Running...\n",TM_num);
+    for (uint8_t k = 0; k < m->tapes_number; k++) {
+        Tape_t* tape = &m->tapes[k];
+        for (uint32_t a = tape->left; a<tape->right; a++) {
+#ifdef MINGW
+            alphabetPut(stdout,tape->cells[a]);
+#else
+            if (a==tape->head) printf("\e[1;31m");
+            alphabetPut(stdout,tape->cells[a]);
+            if (a==tape->head) printf("\e[0m");
+#endif
+        }
+        printf("\n");
+        for (uint32_t a = tape->left; a<tape->right; a++) {
+#ifdef MINGW
+            if (a==tape->head) printf("^"); else printf(" ");
+#else
+            if (a==tape->head) printf("\e[1;31m^\e[0m"); else printf(" ");
+#endif
+            for (uint8_t w = 1; w<alphabetWidth(tape->cells[a]); w++) printf(" ");
+        }
+        printf("\n");
+    }
+}
+
+/// @brief Deallocates the tapes and move index of a Multi-Tape DTM
+/// States and moves belong to the DTM it was created from (see freeTM)
+/// @param m    Multi-Tape DTM
+void freeMultiTM(MultiTM_t* m) {
+    for (uint8_t k = 0; k < m->tapes_number; k++) free(m->tapes[k].cells);
+    free(m->state_moves);
+    free(m->state_first);
+}
@@ -0,0 +1,369 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <optimize.h>
+
+#define OPTIMIZE_SYMBOLS    256
+#define OPTIMIZE_NO_MOVE    UINT32_MAX
+// fusion of every move
+#define OPTIMIZE_UNFUSED    0
+#define OPTIMIZE_FUSING     1
+#define OPTIMIZE_FUSED      2
+// machines still running after these steps are not verified
+#define OPTIMIZE_VERIFY_STEPS   (uint64_t) 1 << 24
+
+/// @brief Move of the automaton being optimized, with states as indexes
+typedef struct {
+    uint32_t state;
+    uint8_t read_symbol;
+    uint8_t write_symbol;
+    uint8_t head_move;
+    uint32_t new_state;
+    uint32_t line_number;
+    /// @brief 0 once the move is removed
+    uint8_t valid;
+} OptimizeMove_t;
+
+/// @brief Orders states by their names
+static int optimizeCompareStates(const void* a, const void* b) {
+    return strcmp((*(State_t* const*)a)->name, (*(State_t* const*)b)->name);
+}
+
+/// @brief Index of a state by its name
+/// @param a        AutomataParser_t object
+/// @param sorted   States of the automaton ordered by optimizeCompareStates
+/// @param name     State Name
+static uint32_t optimizeStateIndex(AutomataParser_t* a, State_t** sorted, uint8_t* name) {
+    State_t key = {.name = name}, *key_ptr = &key;
+    State_t** found = bsearch(&key_ptr, sorted, a->states_size, sizeof(State_t*), optimizeCompareStates);
+    return (found==NULL) ? 0 : (uint32_t)(*found-a->states);
+}
+
+/// @brief Rebuilds the table with the first valid move of every (state, read symbol)
+static void optimizeTable(uint32_t* table, OptimizeMove_t* moves, uint32_t moves_size, uint32_t states_size) {
+    for (uint32_t i = 0; i < states_size*OPTIMIZE_SYMBOLS; i++) table[i] = OPTIMIZE_NO_MOVE;
+    for (uint32_t i = 0; i < moves_size; i++) {
+        if (!moves[i].valid) continue;
+        uint32_t* entry = &table[moves[i].state*OPTIMIZE_SYMBOLS+moves[i].read_symbol];
+        if (*entry==OPTIMIZE_NO_MOVE) *entry = i;
+    }
+}
+
+/// @brief States with their applied moves, split in blocks by partition refinement
+typedef struct {
+    OptimizeMove_t* moves;
+    /// @brief Moves of state i are state_moves[state_first[i]] to state_moves[state_first[i+1]-1]
+    uint32_t* state_first;
+    uint32_t* state_moves;
+    uint32_t* block;
+} OptimizeGroups_t;
+
+/// @brief Hash of the block of a state and of the symbol, write, head move and new state block of its moves
+static uint32_t optimizeStateHash(OptimizeGroups_t* g, uint32_t state) {
+    uint64_t hash = 1469598103934665603ULL ^ g->block[state];
+    for (uint32_t k = g->state_first[state]; k < g->state_first[state+1]; k++) {
+        OptimizeMove_t* m = &g->moves[g->state_moves[k]];
+        hash = (hash ^ ((uint64_t)m->read_symbol<<40 | (uint64_t)m->write_symbol<<32 | (uint64_t)m->head_move<<30 | g->block[m->new_state]))*1099511628211ULL;
+    }
+    return (uint32_t)(hash ^ (hash>>32));
+}
+
+/// @brief 1 if two states are in the same block and their moves write, move and go to the same blocks for every symbol
+static uint8_t optimizeSameState(OptimizeGroups_t* g, uint32_t i, uint32_t j) {
+    if (g->block[i]!=g->block[j] || g->state_first[i+1]-g->state_first[i]!=g->state_first[j+1]-g->state_first[j]) return 0;
+    for (uint32_t k = 0; k < g->state_first[i+1]-g->state_first[i]; k++) {
+        OptimizeMove_t* mi = &g->moves[g->state_moves[g->state_first[i]+k]];
+        OptimizeMove_t* mj = &g->moves[g->state_moves[g->state_first[j]+k]];
+        if (mi->read_symbol!=mj->read_symbol || mi->write_symbol!=mj->write_symbol || mi->head_move!=mj->head_move ||
+            g->block[mi->new_state]!=g->block[mj->new_state]) return 0;
+    }
+    return 1;
+}
+
+/// @brief Marks states reachable from a state set following moves forward (or backwards)
+static void optimizeReach(uint8_t* reached, OptimizeMove_t* moves, uint32_t moves_size, uint8_t backwards) {
+    uint8_t changed = 1;
+    while (changed) {
+        changed = 0;
+        for (uint32_t i = 0; i < moves_size; i++) {
+            if (!moves[i].valid) continue;
+            uint32_t from = backwards ? moves[i].new_state : moves[i].state;
+            uint32_t to = backwards ? moves[i].state : moves[i].new_state;
+            if (reached[from] && !reached[to]) reached[to] = changed = 1;
+        }
+    }
+}
+
+/// @brief Optimizes a deterministic automaton, the result simulates the same machine with less work:
+/// - moves that can never be applied are removed (DTMs apply the first move of a state and symbol,
+///   and stop as soon as they are in an accept state)
+/// - MOVE_WAIT moves are fused with the move applied right after them, so a chain of moves that
+///   do not move the head becomes a single move (and a single step)
+/// - states unreachable from the initial state are removed
+/// - dead states (that can not reach any accept state) are removed with every move into them when
+///   prune_dead is set, so machines that can no longer accept stop earlier
+/// - equivalent states are merged by partition refinement (Moore's algorithm)
+/// Machines finish with the same status, tape, head and state (or the state it was merged into).
+/// With prune_dead, only accepted machines keep their results. Single tape automata only
+/// @param a            AutomataParser_t object (it is not modified)
+/// @param prune_dead   1 to remove dead states
+/// @param report       Output Report, its state map must be released with optimizeReportFree
+/// @return             Optimized AutomataParser_t object with Memory Allocated
+AutomataParser_t optimizeAutomata(AutomataParser_t a, uint8_t prune_dead, OptimizeReport_t* report) {
+    uint32_t n = a.states_size;
+    OptimizeMove_t* moves = malloc((a.moves_size+1)*sizeof(OptimizeMove_t));
+    uint32_t* table = malloc((n*OPTIMIZE_SYMBOLS+1)*sizeof(uint32_t));
+    State_t** sorted = malloc((n+1)*sizeof(State_t*));
+    uint8_t* alive = calloc(n+1, sizeof(uint8_t));
+    uint8_t* coreach = calloc(n+1, sizeof(uint8_t));
+    uint32_t initial = 0;
+    memset(report, 0, sizeof(OptimizeReport_t));
+    report->states_before = n;
+    report->moves_before = a.moves_size;
+    report->dead_pruned = prune_dead;
+    for (uint32_t i = 0; i < n; i++) {
+        if (a.states[i].type==STATE_INITIAL) initial = i;
+        sorted[i] = &a.states[i];
+    }
+    qsort(sorted, n, sizeof(State_t*), optimizeCompareStates);
+    for (uint32_t i = 0; i < a.moves_size; i++) {
+        moves[i].state = optimizeStateIndex(&a, sorted, a.moves[i].current_state->name);
+        moves[i].new_state = optimizeStateIndex(&a, sorted, a.moves[i].new_state->name);
+        moves[i].read_symbol = a.moves[i].read_symbol;
+        moves[i].write_symbol = a.moves[i].write_symbol;
+        moves[i].head_move = a.moves[i].head_move;
+        moves[i].line_number = a.moves[i].line_number;
+        moves[i].valid = 1;
+    }
+
+    // unused moves
+    optimizeTable(table, moves, a.moves_size, n);
+    for (uint32_t i = 0; i < a.moves_size; i++) {
+        if (a.states[moves[i].state].type==STATE_ACCEPT || table[moves[i].state*OPTIMIZE_SYMBOLS+moves[i].read_symbol]!=i) {
+            moves[i].valid = 0;
+            report->unused++;
+        }
+    }
+
+    // MOVE_WAIT fusion, the move applied after a waiting move is fused first, so every chain is
+    // followed once; a move already being fused closes an endless MOVE_WAIT loop, left as it is
+    uint8_t* fusion = calloc(a.moves_size+1, sizeof(uint8_t));
+    uint32_t* stack = malloc((a.moves_size+1)*sizeof(uint32_t));
+    for (uint32_t i = 0; i < a.moves_size; i++) {
+        uint32_t stack_size = 0;
+        if (fusion[i]==OPTIMIZE_FUSED) continue;
+        fusion[i] = OPTIMIZE_FUSING;
+        stack[stack_size++] = i;
+        while (stack_size) {
+            OptimizeMove_t* m = &moves[stack[stack_size-1]];
+            uint32_t next = OPTIMIZE_NO_MOVE;
+            if (m->valid && m->head_move==MOVE_WAIT && a.states[m->new_state].type!=STATE_ACCEPT) {
+                next = table[m->new_state*OPTIMIZE_SYMBOLS+m->write_symbol];
+            }
+            if (next!=OPTIMIZE_NO_MOVE && fusion[next]==OPTIMIZE_UNFUSED) {
+                fusion[next] = OPTIMIZE_FUSING;
+                stack[stack_size++] = next;
+                continue;
+            }
+            if (next!=OPTIMIZE_NO_MOVE && fusion[next]==OPTIMIZE_FUSED) {
+                m->write_symbol = moves[next].write_symbol;
+                m->head_move = moves[next].head_move;
+                m->new_state = moves[next].new_state;
+                report->fused++;
+            }
+            fusion[stack[--stack_size]] = OPTIMIZE_FUSED;
+        }
+    }
+    free(fusion);
+    free(stack);
+
+    // unreachable and dead states
+    alive[initial] = 1;
+    optimizeReach(alive, moves, a.moves_size, 0);
+    for (uint32_t i = 0; i < n; i++) if (a.states[i].type==STATE_ACCEPT) coreach[i] = 1;
+    optimizeReach(coreach, moves, a.moves_size, 1);
+    for (uint32_t i = 0; i < n; i++) {
+        if (!alive[i]) report->unreachable++;
+        else if (!coreach[i] && i!=initial) {
+            report->dead++;
+            if (prune_dead) alive[i] = 0;
+        }
+    }
+    for (uint32_t i = 0; i < a.moves_size; i++) {
+        if (moves[i].valid && (!alive[moves[i].state] || !alive[moves[i].new_state])) moves[i].valid = 0;
+    }
+    optimizeTable(table, moves, a.moves_size, n);
+
+    // partition refinement: accept states and the other states start in different blocks,
+    // states stay together while their moves write, move and go to the same blocks for every symbol
+    uint32_t* block = malloc((n+1)*sizeof(uint32_t));
+    uint32_t* next_block = malloc((n+1)*sizeof(uint32_t));
+    uint32_t blocks = 0, previous_blocks;
+    for (uint32_t i = 0; i < n; i++) block[i] = (a.states[i].type==STATE_ACCEPT);
+    // the applied moves of every state in read symbol order, states are grouped by hashing them
+    uint32_t* state_first = malloc((n+1)*sizeof(uint32_t));
+    uint32_t* state_moves = malloc((a.moves_size+1)*sizeof(uint32_t));
+    uint32_t slots = 8, state_moves_size = 0;
+    while (slots < 2*(uint64_t)n) slots *= 2;
+    uint32_t* groups = malloc(slots*sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) {
+        state_first[i] = state_moves_size;
+        for (uint32_t c = 0; c < OPTIMIZE_SYMBOLS; c++) {
+            if (table[i*OPTIMIZE_SYMBOLS+c]!=OPTIMIZE_NO_MOVE) state_moves[state_moves_size++] = table[i*OPTIMIZE_SYMBOLS+c];
+        }
+    }
+    state_first[n] = state_moves_size;
+    OptimizeGroups_t g = {moves, state_first, state_moves, block};
+    do {
+        previous_blocks = blocks;
+        blocks = 0;
+        // slots hold the first state of a group + 1
+        memset(groups, 0, slots*sizeof(uint32_t));
+        for (uint32_t i = 0; i < n; i++) {
+            if (!alive[i]) continue;
+            uint32_t slot = optimizeStateHash(&g, i) & (slots-1);
+            while (groups[slot]!=0 && !optimizeSameState(&g, groups[slot]-1, i)) slot = (slot+1) & (slots-1);
+            if (groups[slot]==0) {
+                groups[slot] = i+1;
+                next_block[i] = blocks++;
+            } else next_block[i] = next_block[groups[slot]-1];
+        }
+        memcpy(block, next_block, n*sizeof(uint32_t));
+    } while (blocks!=previous_blocks);
+    free(state_first);
+    free(state_moves);
+    free(groups);
+
+    // rebuilds the automaton with the first state of every block
+    AutomataParser_t o;
+    uint32_t* representative = malloc((blocks+1)*sizeof(uint32_t));
+    uint32_t* index = malloc((blocks+1)*sizeof(uint32_t));
+    o.states = malloc((blocks+1)*sizeof(State_t));
+    o.states_size = 0;
+    o.tapes_number = a.tapes_number;
+    for (uint32_t i = 0; i < n; i++) {
+        if (!alive[i]) continue;
+        if (o.states_size==block[i]) {
+            representative[block[i]] = i;
+            index[block[i]] = o.states_size;
+            o.states[o.states_size].name = malloc(strlen(a.states[i].name)+1);
+            strcpy(o.states[o.states_size].name, a.states[i].name);
+            o.states[o.states_size].type = a.states[i].type;
+            o.states_size++;
+        }
+        // merged states keep the initial type
+        if (i==initial) o.states[index[block[i]]].type = STATE_INITIAL;
+    }
+    report->state_map = malloc((n+1)*sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) report->state_map[i] = alive[i] ? index[block[i]] : OPTIMIZE_REMOVED;
+    report->merged = (n-report->unreachable-(prune_dead ? report->dead : 0))-o.states_size;
+    o.moves = malloc((a.moves_size+1)*sizeof(Move_t));
+    o.moves_size = 0;
+    for (uint32_t i = 0; i < a.moves_size; i++) {
+        if (!moves[i].valid || representative[block[moves[i].state]]!=moves[i].state) continue;
+        Move_t* m = &o.moves[o.moves_size++];
+        State_t* from = &o.states[index[block[moves[i].state]]];
+        State_t* to = &o.states[index[block[moves[i].new_state]]];
+        // same layout of parserToAutomata: moves keep their own state copies
+        m->current_state = malloc(sizeof(State_t));
+        m->current_state->name = malloc(strlen(from->name)+1);
+        strcpy(m->current_state->name, from->name);
+        m->current_state->type = from->type;
+        m->new_state = malloc(sizeof(State_t));
+        m->new_state->name = malloc(strlen(to->name)+1);
+        strcpy(m->new_state->name, to->name);
+        m->new_state->type = to->type;
+        m->read_symbol = moves[i].read_symbol;
+        m->write_symbol = moves[i].write_symbol;
+        m->head_move = moves[i].head_move;
+        m->line_number = moves[i].line_number;
+        m->read_key = m->read_symbol;
+        m->write_key = m->write_symbol;
+        m->head_moves = m->head_move;
+    }
+    report->states_after = o.states_size;
+    report->moves_after = o.moves_size;
+    free(moves);
+    free(table);
+    free(sorted);
+    free(alive);
+    free(coreach);
+    free(block);
+    free(next_block);
+    free(representative);
+    free(index);
+    return o;
+}
+
+/// @brief Prints the before and after counters of an optimization
+/// @param file     Output File
+/// @param report   Optimization Report
+void optimizeReportPrint(FILE* file, OptimizeReport_t* report) {
+    fprintf(file, "Optimized automaton: %u states -> %u, %u moves -> %u (%u unused moves, %u fused moves, "
+                  "%u unreachable states, %u dead states%s, %u merged states)\n",
+            report->states_before, report->states_after, report->moves_before, report->moves_after,
+            report->unused, report->fused, report->unreachable, report->dead, report->dead_pruned ? "" : " kept",
+            report->merged);
+}
+
+/// @brief Releases the state map of an optimization report
+/// @param report   Optimization Report
+void optimizeReportFree(OptimizeReport_t* report) {
+    free(report->state_map);
+    report->state_map = NULL;
+}
+
+/// @brief Runs a DTM until it stops, reaches an Accept State or the verification step limit
+static void optimizeRun(TM_t* t) {
+    uint8_t tmlen = strlen(t->tape);
+    while (t->status==STATUS_SGMOVE && t->steps < (OPTIMIZE_VERIFY_STEPS)) {
+        t->status = runStepTM(&t->tape,&t->head,&tmlen,t->states,&t->current_state,t->states_size,t->moves,t->moves_size,t->index,NULL);
+        if (t->status==STATUS_SGMOVE) t->steps++;
+    }
+}
+
+/// @brief Runs every machine of a script with the original and the optimized automaton and compares them:
+/// both must stop with the same status, tape, head and state (the optimized state of the original one).
+/// When dead states were pruned, machines that do not accept only have to keep not accepting
+/// Machines that do not stop within OPTIMIZE_VERIFY_STEPS steps are skipped
+/// @param file         Output File of the verification messages
+/// @param original     Original AutomataParser_t object
+/// @param optimized    Optimized AutomataParser_t object
+/// @param report       Report of the optimization
+/// @param hp           Tapes and Heads of the script
+/// @return             1 if every machine has the same result, 0 elsewhere
+uint8_t optimizeVerify(FILE* file, AutomataParser_t original, AutomataParser_t optimized, OptimizeReport_t* report, HeadParser_t hp) {
+    uint8_t verified = 1;
+    uint32_t skipped = 0;
+    for (uint32_t i = 0; i < hp.size; i++) {
+        TM_t t = DTM(hp.tapes[i], hp.heads[i], original);
+        TM_t o = DTM(hp.tapes[i], hp.heads[i], optimized);
+        optimizeRun(&t);
+        // optimized machines never take more steps than the original ones
+        if (t.status==STATUS_SGMOVE) skipped++;
+        else {
+            optimizeRun(&o);
+            uint8_t changed;
+            if (report->dead_pruned && t.status!=STATUS_ACCEPT) changed = (o.status==STATUS_ACCEPT);
+            else {
+                uint32_t state = report->state_map[t.current_state-t.states];
+                changed = t.status!=o.status || strcmp(t.tape, o.tape)!=0 || t.head!=o.head ||
+                          state==OPTIMIZE_REMOVED || strcmp(optimized.states[state].name, o.current_state->name)!=0;
+            }
+            if (changed) {
+                fprintf(file, "Optimization changed Turing Machine %u: \"%s\" %s in %s at %u, optimized \"%s\" %s in %s at %u.\n", i,
+                        t.tape, t.status==STATUS_ACCEPT ? "accepted" : "stopped", t.current_state->name, t.head,
+                        o.tape, o.status==STATUS_ACCEPT ? "accepted" : "stopped", o.current_state->name, o.head);
+                verified = 0;
+            }
+        }
+        freeTM(&t);
+        freeTM(&o);
+    }
+    if (verified) fprintf(file, "Optimization verified: %u Turing Machines have the same results (%u still running, skipped).\n", hp.size-skipped, skipped);
+    return verified;
+}
@@ -0,0 +1,134 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <string.h>
+#include <output.h>
+#include <stats.h>
+#include <alphabet.h>
+
+/// @brief Writes an unsigned integer as little endian bytes
+static void outputWriteUint(FILE* file, uint64_t value, uint8_t bytes) {
+    uint8_t buffer[8];
+    for (uint8_t i = 0; i < bytes; i++) buffer[i] = (uint8_t)(value >> (8*i));
+    fwrite(buffer, 1, bytes, file);
+}
+
+/// @brief Writes a JSON string, runs of characters that need no escape are written straight from the buffer
+/// and tape cells with a name are written with their names
+static void outputJSONString(FILE* file, const uint8_t* cells, uint32_t length, uint8_t tape) {
+    uint32_t run = 0;
+    fputc('"', file);
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t c = cells[i];
+        uint8_t named = tape && alphabetNamed(c);
+        if (c >= 0x20 && c != '"' && c != '\\' && !named) continue;
+        fwrite(cells+run, 1, i-run, file);
+        if (named) alphabetPut(file, c);
+        else if (c == '"' || c == '\\') fprintf(file, "\\%c", c);
+        else fprintf(file, "\\u%04x", c);
+        run = i+1;
+    }
+    fwrite(cells+run, 1, length-run, file);
+    fputc('"', file);
+}
+
+/// @brief Writes a quoted CSV field, quotes are doubled and tape cells with a name are written with their names
+static void outputCSVString(FILE* file, const uint8_t* cells, uint32_t length, uint8_t tape) {
+    uint32_t run = 0;
+    fputc('"', file);
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t named = tape && alphabetNamed(cells[i]);
+        if (cells[i] != '"' && !named) continue;
+        fwrite(cells+run, 1, i-run, file);
+        if (named) alphabetPut(file, cells[i]); else fputs("\"\"", file);
+        run = i+1;
+    }
+    fwrite(cells+run, 1, length-run, file);
+    fputc('"', file);
+}
+
+/// @brief Writes the header of a result stream (CSV column names or binary magic)
+/// @param file     Output File
+/// @param format   OUTPUT_FORMAT_JSONL, OUTPUT_FORMAT_CSV or OUTPUT_FORMAT_BINARY
+/// @param tapes    Number of tapes of every machine, CSV files have a head and tape column per tape
+void outputBegin(FILE* file, uint8_t format, uint8_t tapes) {
+    if (format == OUTPUT_FORMAT_CSV) {
+        fprintf(file, "machine,status,steps,state,head,tape");
+        for (uint8_t k = 2; k <= tapes; k++) fprintf(file, ",head%u,tape%u", k, k);
+        fputc('\n', file);
+    }
+    if (format == OUTPUT_FORMAT_BINARY) {
+        fwrite(OUTPUT_MAGIC, 1, strlen(OUTPUT_MAGIC), file);
+        outputWriteUint(file, OUTPUT_VERSION, 1);
+    }
+}
+
+/// @brief Writes the result of a machine with its trimmed final tapes
+/// Blank cells are removed from both ends of every tape and heads are given from the first kept cell,
+/// so a head is negative when it stopped on a removed blank cell on the left.
+/// Single tape JSON records have a head and a tape, multi-tape ones a heads and a tapes array.
+/// Tape cells are written from the tape buffers without copies, binary records keep the cell codes of named symbols.
+/// Callers running machines in parallel must serialize calls
+/// @param file     Output File
+/// @param format   OUTPUT_FORMAT_JSONL, OUTPUT_FORMAT_CSV or OUTPUT_FORMAT_BINARY
+/// @param record   Machine Result
+void outputRecord(FILE* file, uint8_t format, OutputRecord_t* record) {
+    const uint8_t* tape[TAPES_MAX];
+    uint32_t length[TAPES_MAX];
+    int32_t head[TAPES_MAX];
+    for (uint8_t k = 0; k < record->tapes; k++) {
+        uint32_t first = 0, last = record->length[k];
+        while (first < last && record->cells[k][first] == ' ') first++;
+        while (last > first && record->cells[k][last-1] == ' ') last--;
+        tape[k] = record->cells[k]+first;
+        length[k] = last-first;
+        head[k] = (int32_t)record->head[k]-(int32_t)first;
+    }
+    const uint8_t* state = record->state;
+    uint32_t state_length = strlen((const char*)state);
+    switch (format) {
+    case OUTPUT_FORMAT_JSONL:
+        fprintf(file, "{\"machine\": %u, \"status\": \"%s\", \"steps\": %llu, \"state\": ", record->machine,
+                statsStatusName(record->status), (unsigned long long)record->steps);
+        outputJSONString(file, state, state_length, 0);
+        if (record->tapes == 1) {
+            fprintf(file, ", \"head\": %d, \"tape\": ", head[0]);
+            outputJSONString(file, tape[0], length[0], 1);
+        } else {
+            fprintf(file, ", \"heads\": [");
+            for (uint8_t k = 0; k < record->tapes; k++) fprintf(file, k ? ", %d" : "%d", head[k]);
+            fprintf(file, "], \"tapes\": [");
+            for (uint8_t k = 0; k < record->tapes; k++) {
+                if (k) fprintf(file, ", ");
+                outputJSONString(file, tape[k], length[k], 1);
+            }
+            fputc(']', file);
+        }
+        fprintf(file, "}\n");
+        break;
+    case OUTPUT_FORMAT_CSV:
+        fprintf(file, "%u,%s,%llu,", record->machine, statsStatusName(record->status), (unsigned long long)record->steps);
+        outputCSVString(file, state, state_length, 0);
+        for (uint8_t k = 0; k < record->tapes; k++) {
+            fprintf(file, ",%d,", head[k]);
+            outputCSVString(file, tape[k], length[k], 1);
+        }
+        fputc('\n', file);
+        break;
+    default:
+        outputWriteUint(file, record->machine, 4);
+        outputWriteUint(file, record->status, 1);
+        outputWriteUint(file, record->steps, 8);
+        outputWriteUint(file, state_length, 2);
+        fwrite(state, 1, state_length, file);
+        outputWriteUint(file, record->tapes, 1);
+        for (uint8_t k = 0; k < record->tapes; k++) {
+            outputWriteUint(file, (uint32_t)head[k], 4);
+            outputWriteUint(file, length[k], 4);
+            fwrite(tape[k], 1, length[k], file);
+        }
+        break;
+    }
+}
@@ -0,0 +1,270 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <preprocessor.h>
+
+/// @brief Creates the preprocessor of a script
+/// @param file Script Stream, it is not closed by preprocessorFree
+/// @param path Script Path, included files are found from its directory (NULL for the working directory)
+/// @return     Preprocessor_t*
+Preprocessor_t* preprocessorCreate(FILE* file, const char* path) {
+    Preprocessor_t* pp = calloc(1, sizeof(Preprocessor_t));
+    pp->files[0] = file;
+    if (path!=NULL) {
+        pp->paths[0] = malloc(strlen(path)+1);
+        strcpy(pp->paths[0], path);
+    }
+    return pp;
+}
+
+/// @brief Closes the included files left open (after an error) and frees the preprocessor
+void preprocessorFree(Preprocessor_t* pp) {
+    if (pp==NULL) return;
+    for (uint8_t i = 0; i <= pp->depth; i++) {
+        if (i>0) fclose(pp->files[i]);
+        free(pp->paths[i]);
+    }
+    free(pp);
+}
+
+/// @brief Reads the next line of the script, going on with the including file at the end of an included file
+/// @param pp           Preprocessor
+/// @param line         Output Buffer
+/// @param size         Output Buffer Length
+/// @param line_number  Line number in the file read, restored at the end of an included file
+/// @return             line, NULL at the end of the script
+char* preprocessorRead(Preprocessor_t* pp, char* line, int size, uint32_t* line_number) {
+    while (fgets(line, size, pp->files[pp->depth])==NULL) {
+        if (pp->depth==0) return NULL;
+        fclose(pp->files[pp->depth]);
+        free(pp->paths[pp->depth]);
+        pp->paths[pp->depth] = NULL;
+        *line_number = pp->line_numbers[pp->depth];
+        pp->depth--;
+    }
+    return line;
+}
+
+/// @brief Finds the directive of a line: define, include or foreach followed by whitespaces
+/// @param line Line with whitespaces, without comments
+/// @param rest Output pointer to the text after the directive
+/// @return     PREPROCESSOR_DEFINE, PREPROCESSOR_INCLUDE, PREPROCESSOR_FOREACH or PREPROCESSOR_NONE
+uint8_t preprocessorDirective(char* line, char** rest) {
+    const char* keywords[3] = {"define", "include", "foreach"};
+    while (isspace((unsigned char)*line)) line++;
+    for (uint8_t i = 0; i < 3; i++) {
+        size_t length = strlen(keywords[i]);
+        if (strncmp(line, keywords[i], length)!=0 || !isspace((unsigned char)line[length])) continue;
+        *rest = line+length;
+        while (isspace((unsigned char)**rest)) (*rest)++;
+        return i+1;
+    }
+    return PREPROCESSOR_NONE;
+}
+
+/// @brief Length of the name at the start of a text: a letter or underscore, then letters, digits or underscores
+static size_t preprocessorNameLength(const char* text) {
+    size_t length = 0;
+    if (!isalpha((unsigned char)text[0]) && text[0]!='_') return 0;
+    while (isalnum((unsigned char)text[length]) || text[length]=='_') length++;
+    return length;
+}
+
+/// @brief Value of a foreach variable (innermost first) or a define, NULL if the name is not defined
+static const char* preprocessorValue(Preprocessor_t* pp, const char* name, size_t length) {
+    for (uint8_t i = pp->variables_size; i > 0; i--)
+        if (strlen(pp->variables[i-1])==length && strncmp(pp->variables[i-1], name, length)==0) return pp->variable_values[i-1];
+    for (uint32_t i = 0; i < pp->size; i++)
+        if (strlen(pp->names[i])==length && strncmp(pp->names[i], name, length)==0) return pp->values[i];
+    return NULL;
+}
+
+/// @brief Defines a name: "<name> <value>", the value is substituted (see preprocessorSubstitute) and loses its whitespaces
+/// A defined name is replaced by its new value
+/// @param pp   Preprocessor
+/// @param text Directive text
+/// @return     0 if defined, -1 for an invalid name or value, -2 if there are too many defines,
+///             -3 if the value has an undefined {name}
+int8_t preprocessorDefine(Preprocessor_t* pp, char* text) {
+    size_t length = preprocessorNameLength(text);
+    if (length==0 || length>=PREPROCESSOR_NAME_MAX || !isspace((unsigned char)text[length])) return -1;
+    char value[PREPROCESSOR_VALUE_MAX], clean[PREPROCESSOR_VALUE_MAX];
+    int8_t substituted = preprocessorSubstitute(pp, text+length, value, sizeof(value));
+    if (substituted==-3) return -3;
+    if (substituted<0) return -1;
+    uint16_t j = 0;
+    for (uint16_t i = 0; value[i]; i++) if (!isspace((unsigned char)value[i])) clean[j++] = value[i];
+    clean[j] = 0;
+    if (j==0) return -1;
+    uint32_t index = pp->size;
+    for (uint32_t i = 0; i < pp->size; i++)
+        if (strlen(pp->names[i])==length && strncmp(pp->names[i], text, length)==0) index = i;
+    if (index==pp->size) {
+        if (pp->size==PREPROCESSOR_DEFINES_MAX) return -2;
+        pp->size++;
+    }
+    memcpy(pp->names[index], text, length);
+    pp->names[index][length] = 0;
+    strcpy(pp->values[index], clean);
+    return 0;
+}
+
+/// @brief Goes on reading an included file, from the directory of the file read
+/// @param pp           Preprocessor
+/// @param text         Directive text with the file path
+/// @param line_number  Line number after the include line, set to the first line of the included file
+/// @return             0 if included, -1 if includes are nested too deep, -2 if the file can not be opened
+int8_t preprocessorInclude(Preprocessor_t* pp, char* text, uint32_t* line_number) {
+    size_t length = strlen(text);
+    while (length>0 && isspace((unsigned char)text[length-1])) length--;
+    text[length] = 0;
+    if (pp->depth==PREPROCESSOR_DEPTH_MAX) return -1;
+    // relative paths start at the directory of the including file
+    const char* base = pp->paths[pp->depth];
+    size_t directory = 0;
+    if (base!=NULL && text[0]!='/' && strrchr(base, '/')!=NULL) directory = strrchr(base, '/')-base+1;
+    char* path = malloc(directory+length+1);
+    if (directory) memcpy(path, base, directory);
+    strcpy(path+directory, text);
+    FILE* file = fopen(path, "r");
+    if (file==NULL) {
+        free(path);
+        return -2;
+    }
+    pp->depth++;
+    pp->files[pp->depth] = file;
+    pp->paths[pp->depth] = path;
+    pp->line_numbers[pp->depth] = *line_number;
+    *line_number = 1;
+    return 0;
+}
+
+/// @brief Replaces {name} with the value of a foreach variable or define, and {name+k} or {name-k}
+/// with an integer value plus or minus k. Braces with other text are kept
+/// @param pp       Preprocessor
+/// @param input    Input Text
+/// @param output   Output Buffer
+/// @param size     Output Buffer Length
+/// @return         0 if substituted, -1 if the output is too long, -2 for arithmetic on a value that is not an integer,
+///                 -3 for a name that is neither a foreach variable nor a define (kept in pp->undefined)
+int8_t preprocessorSubstitute(Preprocessor_t* pp, const char* input, char* output, size_t size) {
+    size_t j = 0;
+    for (size_t i = 0; input[i]; i++) {
+        char value[PREPROCESSOR_VALUE_MAX];
+        const char* found = NULL;
+        size_t end = 0;
+        if (input[i]=='{') {
+            size_t length = preprocessorNameLength(&input[i+1]);
+            const char* close = strchr(&input[i+1], '}');
+            const char* offset = &input[i+1+length];
+            char* number_end = (char*)offset;
+            long long k = 0;
+            if (*offset=='+' || *offset=='-') k = strtoll(offset+1, &number_end, 10);
+            // {name}, {name+k} or {name-k}
+            if (length>0 && close!=NULL && (offset==close || (number_end!=offset+1 && number_end==close))) {
+                found = preprocessorValue(pp, &input[i+1], length);
+                if (found==NULL) {
+                    snprintf(pp->undefined, sizeof(pp->undefined), "%.*s", (int)length, &input[i+1]);
+                    return -3;
+                }
+                if (offset!=close) {
+                    char* value_end;
+                    long long base = strtoll(found, &value_end, 10);
+                    if (value_end==found || *value_end!=0) return -2;
+                    snprintf(value, sizeof(value), "%lld", (*offset=='+') ? base+k : base-k);
+                    found = value;
+                }
+                end = close-input;
+            }
+        }
+        if (found==NULL) {
+            if (j+1>=size) return -1;
+            output[j++] = input[i];
+            continue;
+        }
+        size_t length = strlen(found);
+        if (j+length>=size) return -1;
+        memcpy(&output[j], found, length);
+        j += length;
+        i = end;
+    }
+    output[j] = 0;
+    return 0;
+}
+
+/// @brief Sets the variable of a foreach loop, hiding defines and variables of outer loops with the same name
+/// @return 0 if set, -1 if loops are nested too deep or the name is invalid
+int8_t preprocessorPush(Preprocessor_t* pp, const char* name, const char* value) {
+    if (pp->variables_size==PREPROCESSOR_DEPTH_MAX || strlen(name)>=PREPROCESSOR_NAME_MAX) return -1;
+    strcpy(pp->variables[pp->variables_size], name);
+    strcpy(pp->variable_values[pp->variables_size], value);
+    pp->variables_size++;
+    return 0;
+}
+
+/// @brief Drops the variable of the innermost foreach loop
+void preprocessorPop(Preprocessor_t* pp) {
+    if (pp->variables_size>0) pp->variables_size--;
+}
+
+/// @brief Starts iterating a foreach list
+/// @param list Output List
+/// @param text List Text, whitespaces are ignored
+void preprocessorListBegin(PreprocessorList_t* list, const char* text) {
+    uint16_t j = 0;
+    for (uint16_t i = 0; text[i] && j+1 < PREPROCESSOR_VALUE_MAX; i++) if (!isspace((unsigned char)text[i])) list->text[j++] = text[i];
+    list->text[j] = 0;
+    list->position = 0;
+    list->range = 0;
+}
+
+/// @brief Next item of a foreach list
+/// @param list     List
+/// @param value    Output Buffer of PREPROCESSOR_VALUE_MAX characters
+/// @return         1 if there is an item, 0 at the end of the list
+uint8_t preprocessorListNext(PreprocessorList_t* list, char* value) {
+    while (1) {
+        if (list->range) {
+            if (list->next<=list->last) {
+                if (list->characters) snprintf(value, PREPROCESSOR_VALUE_MAX, "%c", (char)list->next);
+                else snprintf(value, PREPROCESSOR_VALUE_MAX, "%lld", (long long)list->next);
+                list->next++;
+                return 1;
+            }
+            list->range = 0;
+        }
+        if (list->text[list->position]==0) return 0;
+        char* item = &list->text[list->position];
+        char* comma = strchr(item, ',');
+        size_t length = (comma!=NULL) ? (size_t)(comma-item) : strlen(item);
+        list->position += length + (comma!=NULL);
+        if (length==0) continue;
+        char* dots = strstr(item, "..");
+        if (dots!=NULL && dots>item && dots+2<item+length) {
+            char *first_end, *last_end;
+            long long first = strtoll(item, &first_end, 10), last = strtoll(dots+2, &last_end, 10);
+            if (first_end==dots && last_end==item+length) {
+                list->characters = 0;
+                list->range = 1;
+                list->next = first;
+                list->last = last;
+                continue;
+            }
+            if (dots==item+1 && length==4) {
+                list->characters = 1;
+                list->range = 1;
+                list->next = (unsigned char)item[0];
+                list->last = (unsigned char)item[3];
+                continue;
+            }
+        }
+        memcpy(value, item, length);
+        value[length] = 0;
+        return 1;
+    }
+}
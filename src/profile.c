@@ -0,0 +1,121 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <profile.h>
+#include <alphabet.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+/// @brief Allocates zeroed counters for every thread
+/// @param t        TM_t with the profiled automaton (every machine shares its layout)
+/// @param threads  Number of threads that may run machines
+/// @return         Profile_t array with one element per thread
+Profile_t* profileCreate(TM_t* t, uint32_t threads) {
+    Profile_t* profile = calloc(threads, sizeof(Profile_t));
+    for (uint32_t i = 0; i < threads; i++) {
+        profile[i].move_hits = calloc(t->moves_size+1, sizeof(uint64_t));
+        profile[i].state_hits = calloc(t->states_size+1, sizeof(uint64_t));
+        profile[i].state_longest_run = calloc(t->states_size+1, sizeof(uint64_t));
+    }
+    return profile;
+}
+
+/// @brief Counters of the calling thread
+/// @param profile  Profile_t array returned by profileCreate
+/// @return         Profile_t* owned by the calling thread
+Profile_t* profileThread(Profile_t* profile) {
+#ifdef OPENMP
+    return &profile[omp_get_thread_num()];
+#else
+    return profile;
+#endif
+}
+
+/// @brief Closes the current state run of a machine, updating the longest run of its state
+/// @param pr   Profile counters of the current thread
+/// @param run  State run to be closed
+/// @param t    Profiled TM
+void profileRunEnd(Profile_t* pr, ProfileRun_t* run, TM_t* t) {
+    if (run->state == NULL) return;
+    uint32_t state = run->state - t->states;
+    if (run->length > pr->state_longest_run[state]) pr->state_longest_run[state] = run->length;
+}
+
+/// @brief Writes a move as it is written in scripts (blank symbols are empty fields)
+static void profileTransition(char* buffer, size_t size, Move_t* m) {
+    const char head_symbols[3] = {'<', '>', '-'};
+    char read[2] = {m->read_symbol == ' ' ? 0 : m->read_symbol, 0};
+    char write[2] = {m->write_symbol == ' ' ? 0 : m->write_symbol, 0};
+    const uint8_t* read_name = alphabetName(m->read_symbol);
+    const uint8_t* write_name = alphabetName(m->write_symbol);
+    snprintf(buffer, size, "%s,%s,%s,%c,%s", m->current_state->name, read_name ? (char*)read_name : read,
+             write_name ? (char*)write_name : write, head_symbols[m->head_move], m->new_state->name);
+}
+
+/// @brief Share of a counter in a total, in percent
+static double profileShare(uint64_t hits, uint64_t total) {
+    return total > 0 ? 100.0*hits/total : 0.0;
+}
+
+/// @brief Merges the counters of every thread and writes the profile report
+/// Transitions are listed by hits, with the script line where they are defined,
+/// so hot transitions and unused ones can be spotted in the machine definition
+/// @param file     Output File
+/// @param profile  Profile_t array returned by profileCreate
+/// @param threads  Profile_t array length
+/// @param t        TM_t with the profiled automaton
+/// @param runs     0 if state runs were not tracked (NDTM branches), runs are shown as "-"
+void profileReport(FILE* file, Profile_t* profile, uint32_t threads, TM_t* t, uint8_t runs) {
+    Profile_t total = {0};
+    uint64_t steps = 0;
+    total.move_hits = calloc(t->moves_size+1, sizeof(uint64_t));
+    total.state_hits = calloc(t->states_size+1, sizeof(uint64_t));
+    total.state_longest_run = calloc(t->states_size+1, sizeof(uint64_t));
+    for (uint32_t i = 0; i < threads; i++) {
+        for (uint32_t j = 0; j < t->moves_size; j++) total.move_hits[j] += profile[i].move_hits[j];
+        for (uint32_t j = 0; j < t->states_size; j++) {
+            total.state_hits[j] += profile[i].state_hits[j];
+            if (profile[i].state_longest_run[j] > total.state_longest_run[j]) total.state_longest_run[j] = profile[i].state_longest_run[j];
+        }
+        for (uint8_t j = 0; j < 3; j++) total.head_moves[j] += profile[i].head_moves[j];
+    }
+    for (uint8_t j = 0; j < 3; j++) steps += total.head_moves[j];
+
+    // transitions sorted by hits (insertion sort keeps script order between equal hits)
+    uint32_t* order = malloc((t->moves_size+1)*sizeof(uint32_t));
+    for (uint32_t j = 0; j < t->moves_size; j++) {
+        uint32_t k = j;
+        while (k > 0 && total.move_hits[order[k-1]] < total.move_hits[j]) {
+            order[k] = order[k-1];
+            k--;
+        }
+        order[k] = j;
+    }
+    char transition[128];
+    fprintf(file, "\nTransition Profile (%llu steps)\n", (unsigned long long)steps);
+    fprintf(file, "  Line  Transition                          Hits    Share\n");
+    for (uint32_t j = 0; j < t->moves_size; j++) {
+        profileTransition(transition, sizeof(transition), &t->moves[order[j]]);
+        fprintf(file, "%6u  %-28s%12llu  %6.2f%%%s\n", t->moves[order[j]].line_number, transition,
+                (unsigned long long)total.move_hits[order[j]], profileShare(total.move_hits[order[j]], steps),
+                total.move_hits[order[j]] == 0 ? "  never used" : "");
+    }
+    fprintf(file, "\nState Profile\n");
+    fprintf(file, "  State                         Hits    Share   Longest Run\n");
+    for (uint32_t j = 0; j < t->states_size; j++) {
+        fprintf(file, "  %-20s%14llu  %6.2f%%  ", t->states[j].name, (unsigned long long)total.state_hits[j], profileShare(total.state_hits[j], steps));
+        if (runs) fprintf(file, "%12llu\n", (unsigned long long)total.state_longest_run[j]); else fprintf(file, "%12s\n", "-");
+    }
+    fprintf(file, "\nHead Moves\n");
+    fprintf(file, "  Left  %14llu  %6.2f%%\n", (unsigned long long)total.head_moves[MOVE_LEFT], profileShare(total.head_moves[MOVE_LEFT], steps));
+    fprintf(file, "  Right %14llu  %6.2f%%\n", (unsigned long long)total.head_moves[MOVE_RIGHT], profileShare(total.head_moves[MOVE_RIGHT], steps));
+    fprintf(file, "  Stay  %14llu  %6.2f%%\n", (unsigned long long)total.head_moves[MOVE_WAIT], profileShare(total.head_moves[MOVE_WAIT], steps));
+    free(order);
+    free(total.move_hits);
+    free(total.state_hits);
+    free(total.state_longest_run);
+}
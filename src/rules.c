@@ -24,6 +24,68 @@ void moveHead(uint8_t* head,uint8_t head_move) {
     }
 }
 
+/// @brief Slot of a key in a move index: the slot holding the key, or the free slot where it goes
+static uint32_t moveIndexSlot(MoveIndex_t* index, uint32_t key) {
+    uint32_t slot = (key*2654435761u) & index->mask;
+    while (index->keys[slot]!=0 && index->keys[slot]!=key) slot = (slot+1) & index->mask;
+    return slot;
+}
+
+/// @brief Builds the (state, read symbol) index of the moves of a TM
+/// @param states       TM States, every move points to one of them
+/// @param moves        TM Moves
+/// @param moves_size   TM Moves Length
+/// @return             MoveIndex_t object with Memory Allocated (see moveIndexFree)
+MoveIndex_t* moveIndexCreate(State_t* states, Move_t* moves, uint32_t moves_size) {
+    MoveIndex_t* index = malloc(sizeof(MoveIndex_t));
+    uint32_t slots = 8;
+    while (slots < 2*(uint64_t)moves_size) slots *= 2;
+    index->states = states;
+    index->moves = moves;
+    index->mask = slots-1;
+    index->keys = calloc(slots, sizeof(uint32_t));
+    index->first = malloc(slots*sizeof(uint32_t));
+    index->next = malloc((moves_size+1)*sizeof(uint32_t));
+    // moves are added backwards, so every chain keeps the script order
+    for (uint32_t i = moves_size; i > 0; i--) {
+        Move_t* m = &moves[i-1];
+        uint32_t key = (uint32_t)(m->current_state-states)*256+m->read_symbol+1;
+        uint32_t slot = moveIndexSlot(index, key);
+        index->next[i-1] = (index->keys[slot]==0) ? MOVE_INDEX_END : index->first[slot];
+        index->keys[slot] = key;
+        index->first[slot] = i-1;
+    }
+    return index;
+}
+
+/// @brief First move of a state and read symbol, in script order
+/// @param index    MoveIndex_t object
+/// @param state    State Pointer, an element of the indexed states
+/// @param symbol   Read Symbol
+/// @return         Move_t* of the first move, NULL if there is none
+Move_t* moveIndexFind(MoveIndex_t* index, State_t* state, uint8_t symbol) {
+    uint32_t slot = moveIndexSlot(index, (uint32_t)(state-index->states)*256+symbol+1);
+    return (index->keys[slot]==0) ? NULL : &index->moves[index->first[slot]];
+}
+
+/// @brief Next move with the same state and read symbol of a move, in script order
+/// @param index    MoveIndex_t object
+/// @param move     Move_t* returned by moveIndexFind or moveIndexNext
+/// @return         Move_t* of the next move, NULL after the last one
+Move_t* moveIndexNext(MoveIndex_t* index, Move_t* move) {
+    uint32_t next = index->next[move-index->moves];
+    return (next==MOVE_INDEX_END) ? NULL : &index->moves[next];
+}
+
+/// @brief Deallocates a MoveIndex_t object, NULL is ignored
+void moveIndexFree(MoveIndex_t* index) {
+    if (index==NULL) return;
+    free(index->keys);
+    free(index->first);
+    free(index->next);
+    free(index);
+}
+
 /// @brief Returns valid move index in moves array given a string, its head and TM states not valid for non-deterministic
 /// TM because it only returns a single move, not an array
 /// @param string           DTM Tape String
@@ -31,11 +93,13 @@ void moveHead(uint8_t* head,uint8_t head_move) {
 /// @param moves            DTM Moves Array
 /// @param moves_size       DTM Moves Length
 /// @param current_state    DTM Current State Pointer in Automata
+/// @param index            DTM Moves Index, NULL to scan the moves array
 /// @return                 Move_t* Pointing to Valid Move_t, NULL elsewhere
-Move_t* findValidMove(uint8_t* string, uint8_t TM_str_head, Move_t* moves,uint8_t moves_size, State_t* current_state) {
+Move_t* findValidMove(uint8_t* string, uint8_t TM_str_head, Move_t* moves, uint32_t moves_size, State_t* current_state, MoveIndex_t* index) {
+    if (index!=NULL) return moveIndexFind(index,current_state,string[TM_str_head]);
     // moves array must have at least one element
     if (moves_size==0) return NULL;
-    for (uint8_t i = 0;i<moves_size;i++) {
+    for (uint32_t i = 0;i<moves_size;i++) {
         if (moves[i].current_state==current_state) {
             if (moves[i].read_symbol==string[TM_str_head]) return &(moves[i]);
         }
@@ -51,7 +115,7 @@ Move_t* findValidMove(uint8_t* string, uint8_t TM_str_head, Move_t* moves,uint8_
 /// @param TM_str_size  Tape String Length
 void appendTMTapeLeft(uint8_t** TM_str, uint8_t** TM_str_head, uint8_t* TM_str_size) { 
     // TO DO: pass size as a pointer so the tape size can be updated
-    *TM_str = (uint8_t*)realloc(*TM_str, (*TM_str_size+1)*sizeof(uint8_t));
+    *TM_str = (uint8_t*)realloc(*TM_str, (*TM_str_size+2)*sizeof(uint8_t));
     // Shift existing values to the right
     for (int16_t i=*TM_str_size-1; i >= 0; i--) (*TM_str)[i+1]=(*TM_str)[i];
     // Add white space to first element
@@ -59,7 +123,7 @@ void appendTMTapeLeft(uint8_t** TM_str, uint8_t** TM_str_head, uint8_t* TM_str_s
     // Finish array with 0
     (*TM_str)[*TM_str_size+1]=(uint8_t)0;
     // shift string head to the right
-    (*TM_str_head)++;
+    (**TM_str_head)++;
     // Update TM string size
     (*TM_str_size)++;
 }
@@ -71,7 +135,7 @@ void appendTMTapeLeft(uint8_t** TM_str, uint8_t** TM_str_head, uint8_t* TM_str_s
 /// @param TM_str_size  Tape String Length
 void appendTMTapeRight(uint8_t** TM_str, uint8_t** TM_str_head, uint8_t* TM_str_size) {
     // TO DO: pass size as a pointer so the tape size can be updated
-    *TM_str = (uint8_t*)realloc(*TM_str, (*TM_str_size+1)*sizeof(uint8_t));
+    *TM_str = (uint8_t*)realloc(*TM_str, (*TM_str_size+2)*sizeof(uint8_t));
     // Add white space to last element
     (*TM_str)[*TM_str_size]=' ';
     // Finish array with 0
@@ -81,6 +145,21 @@ void appendTMTapeRight(uint8_t** TM_str, uint8_t** TM_str_head, uint8_t* TM_str_
     // Not necessary to move string head to the left
 }
 
+/// @brief Applies a Move to a TM: writes its symbol, grows the tape if needed and moves the head
+/// @param TM_str           TM Tape String Pointer
+/// @param TM_str_head      TM Tape Head Pointer
+/// @param TM_str_size      TM Tape Length Pointer
+/// @param step_move        Move to be applied
+void applyMoveTM(uint8_t** TM_str, uint8_t* TM_str_head, uint8_t* TM_str_size, Move_t* step_move) {
+    // replace old symbol from tape for new symbol
+    (*TM_str)[*TM_str_head]=step_move->write_symbol;
+    // moves head
+    if (step_move->head_move==MOVE_LEFT  && *TM_str_head==0) appendTMTapeLeft(TM_str,&TM_str_head,TM_str_size);
+    if (step_move->head_move==MOVE_RIGHT && *TM_str_head==*TM_str_size-1) appendTMTapeRight(TM_str,&TM_str_head,TM_str_size);
+    // Updates String Head
+    moveHead(TM_str_head,step_move->head_move);
+}
+
 /// @brief Checks state type from a DTM. If running, moves head, changes its tape and goes to the next state
 /// @param TM_str           DTM Tape String Pointer
 /// @param TM_str_head      DTM Tape Head Pointer
@@ -90,21 +169,23 @@ void appendTMTapeRight(uint8_t** TM_str, uint8_t** TM_str_head, uint8_t* TM_str_
 /// @param states_size      DTM States Length
 /// @param moves            DTM Moves Pointer
 /// @param moves_size       DTM Moves Length
+/// @param index            DTM Moves Index, NULL to scan the moves array
+/// @param last_move        Output Pointer to the Move applied in this step, ignored if NULL
 /// @return                 0, if valid state transition.
 ///                         1, if DTM is in a Valid Accept State
 ///                         2, if DTM stops
-uint8_t runStepTM(uint8_t** TM_str, uint8_t* TM_str_head, uint8_t* TM_str_size, State_t* TM_states, State_t** state_head, uint8_t states_size, Move_t* moves,uint8_t moves_size) {
+///                         7, if the tape would be longer than 255 cells (the move is not applied)
+uint8_t runStepTM(uint8_t** TM_str, uint8_t* TM_str_head, uint8_t* TM_str_size, State_t* TM_states, State_t** state_head, uint32_t states_size, Move_t* moves, uint32_t moves_size, MoveIndex_t* index, Move_t** last_move) {
     // Returns 1 if TM is in an Accept State
     if ((*state_head)->type==STATE_ACCEPT) return (uint8_t)1;
-    Move_t* step_move = findValidMove(*TM_str,*TM_str_head,moves,moves_size,*state_head);
+    Move_t* step_move = findValidMove(*TM_str,*TM_str_head,moves,moves_size,*state_head,index);
     // If no move valid, returns 2. Updates state head, elsewhere
-    if (step_move==NULL) return (uint8_t)2; else *state_head = step_move->new_state;
-    // replace old symbol from tape for new symbol
-    (*TM_str)[*TM_str_head]=step_move->write_symbol;
-    // moves head
-    if (step_move->head_move==MOVE_LEFT  && *TM_str_head==0) appendTMTapeLeft(TM_str,&TM_str_head,TM_str_size);
-    if (step_move->head_move==MOVE_RIGHT && *TM_str_head==*TM_str_size-1) appendTMTapeRight(TM_str,&TM_str_head,TM_str_size);
-    // Updates String Head
-    moveHead(TM_str_head,step_move->head_move);
+    if (step_move==NULL) return (uint8_t)2;
+    // tape lengths are uint8_t, a longer tape would wrap
+    if (*TM_str_size==UINT8_MAX && ((step_move->head_move==MOVE_LEFT && *TM_str_head==0) ||
+        (step_move->head_move==MOVE_RIGHT && *TM_str_head==*TM_str_size-1))) return STATUS_FULL;
+    *state_head = step_move->new_state;
+    applyMoveTM(TM_str,TM_str_head,TM_str_size,step_move);
+    if (last_move!=NULL) *last_move = step_move;
     return (uint8_t)0;
 }
\ No newline at end of file
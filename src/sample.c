@@ -0,0 +1,153 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <sample.h>
+#include <alphabet.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+/// @brief splitmix64 generator step
+static uint64_t sampleNext(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/// @brief Generator state of a walk, every walk has its own stream,
+/// so results do not depend on the number of threads
+static uint64_t sampleWalkSeed(uint64_t seed, uint64_t walk) {
+    uint64_t mixed = walk;
+    return seed ^ sampleNext(&mixed);
+}
+
+/// @brief Square root by Newton iterations (the simulator does not link the math library)
+static double sampleSqrt(double x) {
+    if (x <= 0) return 0;
+    double r = x > 1 ? x : 1;
+    for (uint8_t i = 0; i < 64; i++) r = 0.5*(r + x/r);
+    return r;
+}
+
+/// @brief Runs a single random walk: every step applies one of the valid moves, chosen uniformly
+/// Memory is constant: the tape is a window of cells and candidates holds the valid moves of a step
+/// @param t            TM_t object with the automaton, tape and head of the NDTM
+/// @param state        Generator state of the walk
+/// @param max_steps    Step bound
+/// @param cells        Buffer of SAMPLE_CELLS cells
+/// @param candidates   Buffer of moves_size moves
+/// @param steps        Output Number of steps
+/// @param file         Output File for the script line of every move and the final tape, NULL for none
+/// @return             STATUS_ACCEPT, STATUS_NOMOVE, STATUS_FULL or STATUS_SGMOVE (unfinished)
+static uint8_t sampleWalk(TM_t* t, uint64_t state, uint64_t max_steps, uint8_t* cells, Move_t** candidates, uint64_t* steps, FILE* file) {
+    uint32_t start = SAMPLE_MARGIN, length = strlen((char*)t->tape), head = t->head;
+    State_t* current = t->current_state;
+    uint8_t status = STATUS_SGMOVE;
+    memset(cells, ' ', SAMPLE_CELLS);
+    memcpy(cells+start, t->tape, length);
+    *steps = 0;
+    while (status == STATUS_SGMOVE && *steps < max_steps) {
+        if (current->type == STATE_ACCEPT) {status = STATUS_ACCEPT; break;}
+        uint32_t count = 0;
+        for (Move_t* m = moveIndexFind(t->index, current, cells[start+head]); m != NULL; m = moveIndexNext(t->index, m)) candidates[count++] = m;
+        if (count == 0) {status = STATUS_NOMOVE; break;}
+        // uniform choice without modulo bias for small counts
+        Move_t* m = candidates[(uint32_t)(((sampleNext(&state) >> 32) * count) >> 32)];
+        uint8_t grow_left = (m->head_move == MOVE_LEFT && head == 0);
+        uint8_t grow_right = (m->head_move == MOVE_RIGHT && head == length-1);
+        // longer tapes than DTM and NDTM engines support
+        if ((grow_left || grow_right) && length == UINT8_MAX) {status = STATUS_FULL; break;}
+        if (file != NULL && *steps < SAMPLE_EXAMPLE_MOVES) fprintf(file, " %u", m->line_number);
+        cells[start+head] = m->write_symbol;
+        current = m->new_state;
+        if (grow_left) {start--; head++; length++;}
+        if (grow_right) length++;
+        if (m->head_move == MOVE_LEFT) head--;
+        if (m->head_move == MOVE_RIGHT) head++;
+        (*steps)++;
+    }
+    if (status == STATUS_SGMOVE && current->type == STATE_ACCEPT) status = STATUS_ACCEPT;
+    if (file != NULL) {
+        if (*steps > SAMPLE_EXAMPLE_MOVES) fprintf(file, " ...");
+        fprintf(file, "\n  Final tape: \"");
+        for (uint32_t k = 0; k < length; k++) alphabetPut(file, cells[start+k]);
+        fprintf(file, "\", head %u, state %s\n", head, current->name);
+    }
+    return status;
+}
+
+/// @brief Runs independent random walks through the nondeterministic choices of a NDTM
+/// Walks run in parallel (OpenMP builds), each thread keeps a single tape window and move buffer
+/// @param t            TM_t object with the automaton, tape and head of the NDTM
+/// @param walks        Number of walks
+/// @param seed         Generator seed, the same seed always gives the same walks
+/// @param max_steps    Step bound of each walk
+/// @param threads      Number of threads
+/// @return             Sample Report
+SampleReport_t sampleWalks(TM_t* t, uint64_t walks, uint64_t seed, uint64_t max_steps, uint32_t threads) {
+    uint64_t accepted = 0, stopped = 0, full = 0, unfinished = 0, steps = 0, example = UINT64_MAX;
+    (void)threads;
+#ifdef OPENMP
+    #pragma omp parallel num_threads(threads) reduction(+:accepted,stopped,full,unfinished,steps) reduction(min:example)
+#endif
+    {
+        uint8_t* cells = malloc(SAMPLE_CELLS);
+        Move_t** candidates = malloc((t->moves_size+1)*sizeof(Move_t*));
+#ifdef OPENMP
+        #pragma omp for schedule(dynamic, 64)
+#endif
+        for (uint64_t w = 0; w < walks; w++) {
+            uint64_t walk_steps;
+            uint8_t status = sampleWalk(t, sampleWalkSeed(seed, w), max_steps, cells, candidates, &walk_steps, NULL);
+            steps += walk_steps;
+            if (status == STATUS_ACCEPT) {
+                accepted++;
+                if (w < example) example = w;
+            } else if (status == STATUS_NOMOVE) stopped++;
+            else if (status == STATUS_FULL) full++;
+            else unfinished++;
+        }
+        free(cells);
+        free(candidates);
+    }
+    SampleReport_t report = {walks, accepted, stopped, full, unfinished, steps, example};
+    return report;
+}
+
+/// @brief Writes the accepting fraction of a sampling with its 95% and 99% Wilson score intervals,
+/// and replays the lowest accepting walk to show its moves
+/// @param file         Output File
+/// @param report       Sample Report
+/// @param t            TM_t object given to sampleWalks
+/// @param seed         Generator seed given to sampleWalks
+/// @param max_steps    Step bound given to sampleWalks
+void sampleReportPrint(FILE* file, SampleReport_t* report, TM_t* t, uint64_t seed, uint64_t max_steps) {
+    double n = report->walks, p = n > 0 ? report->accepted/n : 0;
+    const double z[2] = {1.959963984540054, 2.5758293035489004};
+    fprintf(file, "Random walks: %llu (seed %llu, at most %llu steps each)\n", (unsigned long long)report->walks,
+            (unsigned long long)seed, (unsigned long long)max_steps);
+    fprintf(file, "  Accepted       %llu\n  Stopped        %llu\n  Tape full      %llu\n  Unfinished     %llu\n  Steps          %llu\n",
+            (unsigned long long)report->accepted, (unsigned long long)report->stopped, (unsigned long long)report->full,
+            (unsigned long long)report->unfinished, (unsigned long long)report->steps);
+    fprintf(file, "Accepting fraction: %.6f\n", p);
+    for (uint8_t i = 0; i < 2 && n > 0; i++) {
+        double denominator = 1 + z[i]*z[i]/n;
+        double center = (p + z[i]*z[i]/(2*n))/denominator;
+        double half = z[i]*sampleSqrt(p*(1-p)/n + z[i]*z[i]/(4*n*n))/denominator;
+        fprintf(file, "  %s%% confidence interval  [%.6f, %.6f]\n", i ? "99" : "95",
+                center-half < 0 ? 0 : center-half, center+half > 1 ? 1 : center+half);
+    }
+    if (!report->accepted) return;
+    uint8_t* cells = malloc(SAMPLE_CELLS);
+    Move_t** candidates = malloc((t->moves_size+1)*sizeof(Move_t*));
+    uint64_t steps;
+    fprintf(file, "Example accepting walk %llu, script lines of its moves:", (unsigned long long)report->example);
+    sampleWalk(t, sampleWalkSeed(seed, report->example), max_steps, cells, candidates, &steps, file);
+    free(cells);
+    free(candidates);
+}
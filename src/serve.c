@@ -0,0 +1,451 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+// Long-running server mode (tmsim serve): automata are loaded once and requests are
+// read line by line from stdin or from clients of a local Unix socket. Unix sockets
+// and worker threads are POSIX only, so this module is not built for Windows.
+
+#ifndef MINGW
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <setjmp.h>
+#include <serve.h>
+#include <stats.h>
+
+static ServeAutomaton_t** automata = NULL;
+static uint32_t automata_size = 0;
+static pthread_mutex_t automata_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static double latencies[SERVE_LATENCIES_SIZE];
+static uint64_t latencies_count = 0;
+static pthread_mutex_t latencies_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int* clients = NULL;
+static uint32_t clients_size = 0, clients_capacity = 0;
+static pthread_mutex_t clients_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t clients_ready = PTHREAD_COND_INITIALIZER;
+
+static const char* socket_path = NULL;
+// step bound of every run request and step request, 0 for no limit
+static uint64_t steps_bound = SERVE_STEPS_DEFAULT;
+
+/// @brief Human readable name of a machine status
+/// @param status   Machine Status
+/// @param running  Name of a machine that is still running
+static const char* serveStatusName(uint8_t status, const char* running) {
+    switch (status) {
+    case STATUS_ACCEPT: return "accept";
+    case STATUS_NOMOVE: return "stopped";
+    case STATUS_FULL:   return "tape_full";
+    default:            return running;
+    }
+}
+
+/// @brief Steps of a request limited by the server step bound
+/// @param requested    Steps given in the request, 0 if none
+/// @return             Steps to be run, 0 for no limit
+static uint64_t serveBound(uint64_t requested) {
+    if (requested==0 || (steps_bound!=0 && requested>steps_bound)) return steps_bound;
+    return requested;
+}
+
+/// @brief Finds a loaded automaton by name
+/// @param name Automaton Name
+/// @return     ServeAutomaton_t* object, NULL if it is not loaded
+static ServeAutomaton_t* serveFind(const char* name) {
+    ServeAutomaton_t* a = NULL;
+    pthread_mutex_lock(&automata_lock);
+    for (uint32_t i = 0; i < automata_size; i++) {
+        if (strcmp(automata[i]->name, name)==0) {a = automata[i]; break;}
+    }
+    pthread_mutex_unlock(&automata_lock);
+    return a;
+}
+
+/// @brief Loads a script as a named automaton
+/// The script is parsed once in the calling thread: syntax errors jump back here through
+/// interpreterRecover, so they are replied to the client instead of stopping the server
+/// @param name     Automaton Name
+/// @param filename Script File Path in Disk
+/// @param error    Output buffer with an error message
+/// @param size     Output buffer length
+/// @return         1 if the automaton was loaded, 0 elsewhere
+static uint8_t serveLoad(const char* name, const char* filename, char* error, size_t size) {
+    if (serveFind(name)!=NULL) {
+        snprintf(error, size, "automaton %s is already loaded", name);
+        return 0;
+    }
+    jmp_buf recover;
+    // kept across longjmp
+    Parser_t* volatile p = malloc(sizeof(Parser_t));
+    volatile uint8_t parsed = 0;
+    AutomataParser_t loaded;
+    if (setjmp(recover)) {
+        interpreterRecover(NULL, NULL, 0);
+        if (parsed) freeParser(p);
+        free(p);
+        // a single line reply
+        size_t length = strlen(error);
+        for (size_t i = 0; i < length; i++) if (error[i]=='\n') error[i] = ' ';
+        while (length > 0 && error[length-1]==' ') error[--length] = 0;
+        if (length==0) snprintf(error, size, "invalid script %s", filename);
+        return 0;
+    }
+    interpreterRecover(&recover, error, size);
+    *p = parseFile((const int8_t*)filename);
+    parsed = 1;
+    if (p->tapes_number>1) {
+        interpreterMessage("Multi-tape machines are not supported by serve.\n");
+        interpreterExit();
+    }
+    if (p->alphabet!=NULL) {
+        // request tapes are plain strings
+        interpreterMessage("UTF-8 and named symbols are not supported by serve.\n");
+        interpreterExit();
+    }
+    loaded = parserToAutomata(*p);
+    interpreterRecover(NULL, NULL, 0);
+    freeParser(p);
+    free(p);
+    ServeAutomaton_t* a = calloc(1, sizeof(ServeAutomaton_t));
+    a->name = malloc(strlen(name)+1);
+    strcpy(a->name, name);
+    a->automata = loaded;
+    pthread_mutex_lock(&automata_lock);
+    automata = realloc(automata, (automata_size+1)*sizeof(ServeAutomaton_t*));
+    automata[automata_size++] = a;
+    pthread_mutex_unlock(&automata_lock);
+    return 1;
+}
+
+/// @brief Takes an idle machine from the automaton pool, creating one if the pool is empty
+static TM_t serveAcquire(ServeAutomaton_t* a) {
+    TM_t t;
+    pthread_mutex_lock(&automata_lock);
+    if (a->pool_size > 0) {
+        t = a->pool[--a->pool_size];
+        pthread_mutex_unlock(&automata_lock);
+        return t;
+    }
+    pthread_mutex_unlock(&automata_lock);
+    return DTM((uint8_t*)" ", 0, a->automata);
+}
+
+/// @brief Returns a machine to the automaton pool, keeping its buffers
+static void serveRelease(ServeAutomaton_t* a, TM_t t) {
+    pthread_mutex_lock(&automata_lock);
+    if (a->pool_size == a->pool_capacity) {
+        a->pool_capacity = a->pool_capacity ? 2*a->pool_capacity : 8;
+        a->pool = realloc(a->pool, a->pool_capacity*sizeof(TM_t));
+    }
+    a->pool[a->pool_size++] = t;
+    pthread_mutex_unlock(&automata_lock);
+}
+
+/// @brief Restarts a pooled machine with an input tape
+/// @param t        Machine to be restarted
+/// @param tmlen    Output Tape Length
+/// @param input    Input Tape String
+/// @param head     Input Head Position
+static void serveReset(TM_t* t, uint8_t* tmlen, const char* input, uint8_t head) {
+    *tmlen = strlen(input);
+    t->tape = realloc(t->tape, *tmlen+1);
+    strcpy(t->tape, input);
+    t->head = head;
+    for (uint32_t i = 0; i < t->states_size; i++) {
+        if (t->states[i].type==STATE_INITIAL) {t->current_state = &t->states[i]; break;}
+    }
+    t->steps = 0;
+    t->status = STATUS_SGMOVE;
+}
+
+/// @brief Runs a machine until it stops, reaches an Accept State or runs a number of steps
+/// @param t        Machine to be simulated
+/// @param tmlen    Tape Length
+/// @param count    Maximum number of steps, 0 for no limit
+static void serveSteps(TM_t* t, uint8_t* tmlen, uint64_t count) {
+    uint64_t last = t->steps+count;
+    while (t->status==STATUS_SGMOVE && (count==0 || t->steps<last)) {
+        t->status = runStepTM(&t->tape,&t->head,tmlen,t->states,&t->current_state,t->states_size,t->moves,t->moves_size,t->index,NULL);
+        if (t->status==STATUS_SGMOVE) t->steps++;
+    }
+}
+
+/// @brief Writes the machine reply of a request
+/// @param out      Replies Stream
+/// @param t        Machine
+/// @param running  Status name of a machine that is still running ("limit" once a run request reaches its step bound)
+static void serveReplyMachine(FILE* out, TM_t* t, const char* running) {
+    fprintf(out, "ok %s steps=%llu state=%s head=%u tape=\"%s\"\n", serveStatusName(t->status, running),
+            (unsigned long long)t->steps, t->current_state->name, t->head, t->tape);
+}
+
+/// @brief Checks an input tape and head given in a request
+/// @return 1 if valid, 0 elsewhere (an error reply is written)
+static uint8_t serveCheckTape(FILE* out, const char* tape, const char* head, uint8_t* head_value) {
+    size_t length = strlen(tape);
+    long value = head ? strtol(head, NULL, 10) : 0;
+    if (length==0 || length>=UINT8_MAX || strchr(tape, ',')!=NULL) {
+        fprintf(out, "error tape must have between 1 and %u symbols and no commas\n", UINT8_MAX-1);
+        return 0;
+    }
+    if (value<0 || (size_t)value>=length) {
+        fprintf(out, "error head must be lesser than tape length\n");
+        return 0;
+    }
+    *head_value = value;
+    return 1;
+}
+
+/// @brief Records the latency of a request
+static void serveLatency(double seconds) {
+    pthread_mutex_lock(&latencies_lock);
+    latencies[latencies_count++ % SERVE_LATENCIES_SIZE] = seconds*1e6;
+    pthread_mutex_unlock(&latencies_lock);
+}
+
+/// @brief Ascending comparison of latencies for qsort
+static int serveCompare(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/// @brief Writes latency percentiles of the last SERVE_LATENCIES_SIZE requests (in microseconds)
+static void serveReplyStats(FILE* out) {
+    pthread_mutex_lock(&latencies_lock);
+    uint64_t requests = latencies_count;
+    uint32_t size = requests < SERVE_LATENCIES_SIZE ? requests : SERVE_LATENCIES_SIZE;
+    double* sorted = malloc((size+1)*sizeof(double));
+    memcpy(sorted, latencies, size*sizeof(double));
+    pthread_mutex_unlock(&latencies_lock);
+    qsort(sorted, size, sizeof(double), serveCompare);
+    if (size==0) fprintf(out, "ok requests=0\n");
+    else fprintf(out, "ok requests=%llu p50_us=%.1f p90_us=%.1f p99_us=%.1f max_us=%.1f\n", (unsigned long long)requests,
+                 sorted[size*50/100], sorted[size*90/100], sorted[size*99/100], sorted[size-1]);
+    free(sorted);
+}
+
+/// @brief Session given by its id in a request
+/// @return ServeSession_t* object, NULL if it is not open (an error reply is written)
+static ServeSession_t* serveSession(FILE* out, ServeSession_t* sessions, const char* id) {
+    long value = id ? strtol(id, NULL, 10) : -1;
+    if (value<0 || value>=SERVE_SESSIONS_MAX || sessions[value].automaton==NULL) {
+        fprintf(out, "error unknown session\n");
+        return NULL;
+    }
+    return &sessions[value];
+}
+
+/// @brief Answers every request of a client until it quits or closes its connection
+/// Requests are a command and its arguments separated by whitespaces, replies are a single line
+/// starting with "ok" or "error". Sessions belong to their client and are closed with it
+/// @param in   Requests Stream
+/// @param out  Replies Stream
+/// @return     1 if the client requested a server shutdown, 0 elsewhere
+static uint8_t serveConnection(FILE* in, FILE* out) {
+    ServeSession_t sessions[SERVE_SESSIONS_MAX] = {0};
+    char line[1024], error[512];
+    uint8_t shutdown_request = 0;
+    while (fgets(line, sizeof(line), in) != NULL) {
+        double start = statsClock();
+        char* save;
+        char* command = strtok_r(line, " \t\r\n", &save);
+        char* args[4];
+        for (uint8_t i = 0; i < 4; i++) args[i] = strtok_r(NULL, " \t\r\n", &save);
+        if (command==NULL) continue;
+        if (strcmp(command, "quit")==0) break;
+        if (strcmp(command, "shutdown")==0) {
+            fprintf(out, "ok\n");
+            shutdown_request = 1;
+            break;
+        }
+        if (strcmp(command, "load")==0) {
+            if (args[1]==NULL) fprintf(out, "error usage: load <name> <script>\n");
+            else if (serveLoad(args[0], args[1], error, sizeof(error))) fprintf(out, "ok %s\n", args[0]);
+            else fprintf(out, "error %s\n", error);
+        } else if (strcmp(command, "list")==0) {
+            fprintf(out, "ok");
+            pthread_mutex_lock(&automata_lock);
+            for (uint32_t i = 0; i < automata_size; i++) fprintf(out, " %s", automata[i]->name);
+            pthread_mutex_unlock(&automata_lock);
+            fprintf(out, "\n");
+        } else if (strcmp(command, "run")==0 || strcmp(command, "open")==0) {
+            ServeAutomaton_t* a = args[0] ? serveFind(args[0]) : NULL;
+            uint8_t head;
+            if (args[1]==NULL) fprintf(out, "error usage: %s <name> <tape> [head]%s\n", command, command[0]=='r' ? " [max_steps]" : "");
+            else if (a==NULL) fprintf(out, "error unknown automaton %s\n", args[0]);
+            else if (serveCheckTape(out, args[1], args[2], &head)) {
+                if (command[0]=='r') {
+                    uint8_t tmlen;
+                    TM_t t = serveAcquire(a);
+                    serveReset(&t, &tmlen, args[1], head);
+                    serveSteps(&t, &tmlen, serveBound(args[3] ? strtoull(args[3], NULL, 10) : 0));
+                    serveReplyMachine(out, &t, "limit");
+                    serveRelease(a, t);
+                } else {
+                    uint32_t id = 0;
+                    while (id < SERVE_SESSIONS_MAX && sessions[id].automaton!=NULL) id++;
+                    if (id==SERVE_SESSIONS_MAX) fprintf(out, "error too many sessions\n");
+                    else {
+                        ServeSession_t* s = &sessions[id];
+                        s->automaton = a;
+                        s->t = serveAcquire(a);
+                        s->input = malloc(strlen(args[1])+1);
+                        strcpy(s->input, args[1]);
+                        s->input_head = head;
+                        serveReset(&s->t, &s->tmlen, s->input, s->input_head);
+                        fprintf(out, "ok session=%u\n", id);
+                    }
+                }
+            }
+        } else if (strcmp(command, "step")==0 || strcmp(command, "tape")==0 || strcmp(command, "reset")==0 || strcmp(command, "close")==0) {
+            ServeSession_t* s = serveSession(out, sessions, args[0]);
+            if (s!=NULL) {
+                if (strcmp(command, "step")==0) {
+                    uint64_t count = args[1] ? strtoull(args[1], NULL, 10) : 1;
+                    serveSteps(&s->t, &s->tmlen, serveBound(count ? count : 1));
+                }
+                if (strcmp(command, "reset")==0) serveReset(&s->t, &s->tmlen, s->input, s->input_head);
+                if (strcmp(command, "close")==0) {
+                    serveRelease(s->automaton, s->t);
+                    free(s->input);
+                    s->automaton = NULL;
+                    fprintf(out, "ok\n");
+                } else serveReplyMachine(out, &s->t, "running");
+            }
+        } else if (strcmp(command, "stats")==0) {
+            serveReplyStats(out);
+        } else if (strcmp(command, "help")==0) {
+            fprintf(out, "ok commands: load <name> <script> | list | run <name> <tape> [head] [max_steps] | open <name> <tape> [head] | "
+                         "step <session> [count] | tape <session> | reset <session> | close <session> | stats | quit | shutdown\n");
+        } else fprintf(out, "error unknown command %s\n", command);
+        fflush(out);
+        serveLatency(statsClock()-start);
+    }
+    fflush(out);
+    for (uint32_t i = 0; i < SERVE_SESSIONS_MAX; i++) {
+        if (sessions[i].automaton!=NULL) {
+            serveRelease(sessions[i].automaton, sessions[i].t);
+            free(sessions[i].input);
+        }
+    }
+    return shutdown_request;
+}
+
+/// @brief Worker thread: answers the clients accepted by the main thread, one at a time
+static void* serveWorker(void* arg) {
+    (void)arg;
+    while (1) {
+        pthread_mutex_lock(&clients_lock);
+        while (clients_size==0) pthread_cond_wait(&clients_ready, &clients_lock);
+        int fd = clients[--clients_size];
+        pthread_mutex_unlock(&clients_lock);
+        FILE* in = fdopen(fd, "r");
+        FILE* out = fdopen(dup(fd), "w");
+        uint8_t shutdown_request = serveConnection(in, out);
+        fclose(out);
+        fclose(in);
+        if (shutdown_request) {
+            unlink(socket_path);
+            exit(0);
+        }
+    }
+    return NULL;
+}
+
+/// @brief Accepts clients of a Unix socket and hands them to the worker threads
+/// @param path     Socket Path
+/// @param threads  Number of worker threads
+/// @return         Exit code
+static int serveSocket(const char* path, uint32_t threads) {
+    struct sockaddr_un address = {0};
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        printf("Socket path %s is too long.\n", path);
+        return 1;
+    }
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+    if (server<0 || bind(server, (struct sockaddr*)&address, sizeof(address))!=0 || listen(server, 64)!=0) {
+        printf("Error creating socket %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    socket_path = path;
+    for (uint32_t i = 0; i < threads; i++) {
+        pthread_t thread;
+        pthread_create(&thread, NULL, serveWorker, NULL);
+        pthread_detach(thread);
+    }
+    fprintf(stderr, "Listening on %s with %u threads\n", path, threads);
+    while (1) {
+        int fd = accept(server, NULL, NULL);
+        if (fd<0) {
+            if (errno==EINTR) continue;
+            printf("Error accepting clients: %s\n", strerror(errno));
+            return 1;
+        }
+        pthread_mutex_lock(&clients_lock);
+        if (clients_size == clients_capacity) {
+            clients_capacity = clients_capacity ? 2*clients_capacity : 16;
+            clients = realloc(clients, clients_capacity*sizeof(int));
+        }
+        clients[clients_size++] = fd;
+        pthread_cond_signal(&clients_ready);
+        pthread_mutex_unlock(&clients_lock);
+    }
+}
+
+/// @brief tmsim serve subcommand
+/// Usage: tmsim serve [--socket <path>] [--threads <n>] [--max_steps <n>] [--load <name>=<script>]...
+/// Without a socket, requests are read from stdin and replies are written to stdout
+/// @param argc Subcommand arguments count
+/// @param argv Subcommand arguments
+/// @return     Exit code
+int serveMain(int argc, char *argv[]) {
+    const char* path = NULL;
+    uint32_t threads = SERVE_THREADS_DEFAULT;
+    char error[512];
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--socket")==0 && i+1 < argc) path = argv[++i];
+        else if (strcmp(argv[i], "--threads")==0 && i+1 < argc) {
+            threads = strtoul(argv[++i], NULL, 10);
+            if (threads==0) threads = 1;
+        } else if (strcmp(argv[i], "--max_steps")==0 && i+1 < argc) {
+            char* end_ptr;
+            steps_bound = strtoull(argv[++i], &end_ptr, 10);
+            if (end_ptr==argv[i] || argv[i][0]=='-') {
+                printf("Step bound must be a number of steps (0 for no limit).\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--load")==0 && i+1 < argc) {
+            char* name = argv[++i];
+            char* filename = strchr(name, '=');
+            if (filename==NULL) {
+                printf("Automata must be loaded as <name>=<script>.\n");
+                return 1;
+            }
+            *filename++ = 0;
+            if (!serveLoad(name, filename, error, sizeof(error))) {
+                printf("%s\n", error);
+                return 1;
+            }
+        } else {
+            printf("Usage: tmsim serve [--socket <path>] [--threads <n>] [--max_steps <n>] [--load <name>=<script>]...\n");
+            return 1;
+        }
+    }
+    if (path!=NULL) return serveSocket(path, threads);
+    serveConnection(stdin, stdout);
+    return 0;
+}
+
+#endif
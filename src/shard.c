@@ -0,0 +1,203 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#ifndef MINGW
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <rules.h>
+#include <shard.h>
+#include <io.h>
+
+// ranges given to workers per shard, more ranges balance better but need more messages
+#define SHARD_RANGES 8
+
+/// @brief Reads a whole record from a pipe
+/// @return 1 if the record was read, 0 at end of file or on errors
+static uint8_t shardRead(int fd, void* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t r = read(fd, (uint8_t*)buffer+done, size-done);
+        if (r <= 0) return 0;
+        done += r;
+    }
+    return 1;
+}
+
+/// @brief Worker process loop: runs every range of machines sent by the coordinator
+/// and writes the result of each machine as soon as it finishes, until an empty range
+static void shardWorker(int commands, int results, ShardRun_t run, void* context) {
+    uint32_t range[2];
+    while (shardRead(commands, range, sizeof(range)) && range[1]) {
+        for (uint32_t i = range[0]; i < range[0]+range[1]; i++) {
+            ShardResult_t result;
+            memset(&result, 0, sizeof(result));
+            result.machine = i;
+            run(context, i, &result.stats);
+            // records are smaller than PIPE_BUF, so every write is atomic
+            if (write(results, &result, sizeof(result)) != sizeof(result)) break;
+        }
+    }
+    fflush(stdout);
+    _exit(0);
+}
+
+/// @brief Forks a worker process, the child never returns
+static void shardSpawn(ShardWorker_t* workers, uint32_t shards, uint32_t w, ShardRun_t run, void* context) {
+    int commands[2], results[2];
+    if (pipe(commands)!=0 || pipe(results)!=0) {
+        perror("Error creating shard pipes");
+        exit(1);
+    }
+    // buffered output would be written again by the child
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid<0) {
+        perror("Error creating shard process");
+        exit(1);
+    }
+    if (pid==0) {
+        for (uint32_t i = 0; i < shards; i++) {
+            if (i==w || !workers[i].pid) continue;
+            close(workers[i].commands);
+            close(workers[i].results);
+        }
+        close(commands[1]);
+        close(results[0]);
+        shardWorker(commands[0], results[1], run, context);
+    }
+    close(commands[0]);
+    close(results[1]);
+    workers[w].pid = pid;
+    workers[w].commands = commands[1];
+    workers[w].results = results[0];
+    workers[w].next = workers[w].end = 0;
+}
+
+/// @brief Stops a worker process and waits for it
+static void shardStop(ShardWorker_t* worker, uint8_t kill_worker) {
+    int status;
+    if (kill_worker) kill(worker->pid, SIGKILL);
+    close(worker->commands);
+    close(worker->results);
+    waitpid(worker->pid, &status, 0);
+    worker->pid = 0;
+}
+
+/// @brief Runs a batch of machines in worker processes, with a coordinator in the calling process
+/// Workers are forked from the calling process, so they start with a copy of every machine
+/// and only write to the pages of the machines they run. The coordinator gives each worker
+/// ranges of machines over a pipe and reads a result for every finished machine.
+/// If a worker crashes, the machine it was running is reported as crashed, the rest of its
+/// range is given to other workers and a new worker replaces it.
+/// In first accept mode, workers are killed after the first accept and every machine without
+/// a result is cancelled.
+/// Results are written to results and their status can be printed as soon as they arrive
+/// @param shards       Number of worker processes
+/// @param machines     Number of machines
+/// @param first_accept 1 to cancel the batch after the first accept
+/// @param print_status 1 to print the status line of every result
+/// @param run          Function that runs a single machine in a worker
+/// @param context      Pointer given to run
+/// @param results      Output statistics array, one element per machine
+/// @return             Number of crashed workers
+uint32_t shardRun(uint32_t shards, uint32_t machines, uint8_t first_accept, uint8_t print_status, ShardRun_t run, void* context, MachineStats_t* results) {
+    ShardWorker_t* workers = calloc(shards, sizeof(ShardWorker_t));
+    struct pollfd* fds = malloc(shards*sizeof(struct pollfd));
+    uint32_t* polled = malloc(shards*sizeof(uint32_t));
+    uint8_t* done = calloc(machines+1, sizeof(uint8_t));
+    // ranges left by crashed workers, at most one per crash
+    uint32_t* retry = NULL;
+    uint32_t retry_size = 0, crashes = 0, queued = 0, remaining = machines, cancel = 0;
+    uint32_t chunk = machines/(shards*SHARD_RANGES);
+    if (chunk==0) chunk = 1;
+    signal(SIGPIPE, SIG_IGN);
+    for (uint32_t w = 0; w < shards && w < machines; w++) shardSpawn(workers, shards, w, run, context);
+    while (remaining && !cancel) {
+        uint32_t polled_size = 0;
+        for (uint32_t w = 0; w < shards; w++) {
+            ShardWorker_t* worker = &workers[w];
+            if (worker->pid && worker->next==worker->end) {
+                uint32_t range[2] = {0, 0};
+                if (retry_size) {
+                    retry_size--;
+                    range[0] = retry[2*retry_size];
+                    range[1] = retry[2*retry_size+1];
+                } else if (queued < machines) {
+                    range[0] = queued;
+                    range[1] = (machines-queued < chunk) ? machines-queued : chunk;
+                    queued += range[1];
+                }
+                // a dead worker is found when its results pipe is closed, so write errors are ignored
+                ssize_t sent = write(worker->commands, range, sizeof(range));
+                (void)sent;
+                if (!range[1]) {
+                    // no work left for this worker
+                    shardStop(worker, 0);
+                    continue;
+                }
+                worker->next = range[0];
+                worker->end = range[0]+range[1];
+            }
+            if (worker->pid) {
+                fds[polled_size].fd = worker->results;
+                fds[polled_size].events = POLLIN;
+                polled[polled_size++] = w;
+            }
+        }
+        if (!polled_size) break;
+        if (poll(fds, polled_size, -1) < 0) continue;
+        for (uint32_t p = 0; p < polled_size; p++) {
+            if (!(fds[p].revents & (POLLIN|POLLHUP|POLLERR))) continue;
+            ShardWorker_t* worker = &workers[polled[p]];
+            ShardResult_t result;
+            if (shardRead(worker->results, &result, sizeof(result))) {
+                results[result.machine] = result.stats;
+                done[result.machine] = 1;
+                remaining--;
+                worker->next++;
+                if (print_status) printTMStatusNum(result.stats.status, result.machine);
+                if (first_accept && result.stats.status==STATUS_ACCEPT) cancel = 1;
+                continue;
+            }
+            // crashed: the machine it was running is isolated, the rest of its range runs again
+            crashes++;
+            shardStop(worker, 0);
+            if (worker->next < worker->end) {
+                memset(&results[worker->next], 0, sizeof(MachineStats_t));
+                results[worker->next].status = STATUS_CRASH;
+                done[worker->next] = 1;
+                remaining--;
+                if (print_status) printTMStatusNum(STATUS_CRASH, worker->next);
+                if (worker->next+1 < worker->end) {
+                    retry = realloc(retry, 2*(retry_size+1)*sizeof(uint32_t));
+                    retry[2*retry_size] = worker->next+1;
+                    retry[2*retry_size+1] = worker->end-worker->next-1;
+                    retry_size++;
+                }
+            }
+            if (remaining) shardSpawn(workers, shards, polled[p], run, context);
+        }
+    }
+    for (uint32_t w = 0; w < shards; w++) if (workers[w].pid) shardStop(&workers[w], 1);
+    for (uint32_t i = 0; i < machines; i++) {
+        if (done[i]) continue;
+        memset(&results[i], 0, sizeof(MachineStats_t));
+        results[i].status = STATUS_CANCEL;
+    }
+    free(workers);
+    free(fds);
+    free(polled);
+    free(done);
+    free(retry);
+    return crashes;
+}
+
+#endif
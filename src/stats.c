@@ -0,0 +1,81 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <time.h>
+#include <stats.h>
+#include <rules.h>
+
+/// @brief Monotonic clock used to time machines
+/// @return Seconds from an arbitrary starting point
+double statsClock() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec*1e-9;
+}
+
+/// @brief Human readable name of a status code
+/// @param status   Status code (runStepTM codes, STATUS_CANCEL, STATUS_CRASH or STATUS_OFFEND)
+/// @return         Status name, "running" for unfinished machines
+const char* statsStatusName(uint8_t status) {
+    switch (status) {
+    case STATUS_ACCEPT: return "accept";
+    case STATUS_NOMOVE: return "stopped";
+    case STATUS_CANCEL: return "cancelled";
+    case STATUS_CRASH:  return "crashed";
+    case STATUS_OFFEND: return "off_end";
+    case STATUS_FULL:   return "tape_full";
+    default:            return "running";
+    }
+}
+
+/// @brief Writes per machine and aggregated statistics
+/// @param file         Output File
+/// @param format       STATS_FORMAT_JSON or STATS_FORMAT_CSV
+/// @param mode         Simulation mode name ("DTM" or "NDTM")
+/// @param stats        Per machine statistics array
+/// @param stats_size   Statistics array length
+/// @param wall_seconds Wall time of the whole simulation
+void statsReport(FILE* file, uint8_t format, const char* mode, MachineStats_t* stats, uint32_t stats_size, double wall_seconds) {
+    MachineStats_t total = {0};
+    uint64_t steps_max = 0;
+    uint32_t accepted = 0, stopped = 0, cancelled = 0;
+    for (uint32_t i = 0; i < stats_size; i++) {
+        total.steps += stats[i].steps;
+        total.tape_reallocations += stats[i].tape_reallocations;
+        total.branches += stats[i].branches;
+        total.seconds += stats[i].seconds;
+        if (stats[i].tape_max > total.tape_max) total.tape_max = stats[i].tape_max;
+        if (stats[i].steps > steps_max) steps_max = stats[i].steps;
+        if (stats[i].status == STATUS_ACCEPT) accepted++;
+        if (stats[i].status == STATUS_NOMOVE) stopped++;
+        if (stats[i].status == STATUS_CANCEL) cancelled++;
+    }
+    if (format == STATS_FORMAT_CSV) {
+        fprintf(file, "machine,status,steps,tape_max,tape_reallocations,branches,seconds\n");
+        for (uint32_t i = 0; i < stats_size; i++) {
+            fprintf(file, "%u,%s,%llu,%u,%llu,%llu,%.9f\n", i, statsStatusName(stats[i].status),
+                    (unsigned long long)stats[i].steps, stats[i].tape_max, (unsigned long long)stats[i].tape_reallocations,
+                    (unsigned long long)stats[i].branches, stats[i].seconds);
+        }
+        fprintf(file, "total,-,%llu,%u,%llu,%llu,%.9f\n",
+                (unsigned long long)total.steps, total.tape_max, (unsigned long long)total.tape_reallocations,
+                (unsigned long long)total.branches, wall_seconds);
+        return;
+    }
+    fprintf(file, "{\n  \"mode\": \"%s\",\n  \"machines\": [\n", mode);
+    for (uint32_t i = 0; i < stats_size; i++) {
+        fprintf(file, "    {\"machine\": %u, \"status\": \"%s\", \"steps\": %llu, \"tape_max\": %u, \"tape_reallocations\": %llu, \"branches\": %llu, \"seconds\": %.9f}%s\n",
+                i, statsStatusName(stats[i].status), (unsigned long long)stats[i].steps, stats[i].tape_max,
+                (unsigned long long)stats[i].tape_reallocations, (unsigned long long)stats[i].branches, stats[i].seconds,
+                i+1 < stats_size ? "," : "");
+    }
+    fprintf(file, "  ],\n");
+    fprintf(file, "  \"aggregate\": {\"machines\": %u, \"accepted\": %u, \"stopped\": %u, \"cancelled\": %u, \"steps\": %llu, \"steps_max\": %llu, "
+                  "\"tape_max\": %u, \"tape_reallocations\": %llu, \"branches\": %llu, \"machine_seconds\": %.9f, \"wall_seconds\": %.9f, "
+                  "\"steps_per_second\": %.1f}\n}\n",
+            stats_size, accepted, stopped, cancelled, (unsigned long long)total.steps, (unsigned long long)steps_max, total.tape_max,
+            (unsigned long long)total.tape_reallocations, (unsigned long long)total.branches, total.seconds, wall_seconds,
+            wall_seconds > 0 ? total.steps / wall_seconds : 0.0);
+}
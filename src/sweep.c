@@ -0,0 +1,89 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <sweep.h>
+
+/// @brief Finds the sweeps of an automaton
+/// Every machine created from the same automaton shares its states and moves layout,
+/// so a single Sweep_t serves all of them. Only the first move of each state and symbol
+/// is considered (the one findValidMove applies) and accept states never sweep.
+/// If a state sweeps in both directions, the direction with more symbols is kept
+/// @param t    TM_t object created from the automaton by DTM, with its move index
+/// @return     Sweep_t object with Memory Allocated, NULL if the automaton has no sweep
+Sweep_t* sweepCreate(TM_t* t) {
+    Sweep_t* sweep = malloc(sizeof(Sweep_t));
+    uint8_t found = 0;
+    sweep->states = calloc(t->states_size+1, sizeof(SweepState_t));
+    sweep->states_size = t->states_size;
+    for (uint32_t i = 0; i < t->states_size; i++) {
+        State_t* state = &t->states[i];
+        uint8_t seen[256] = {0}, direction[256];
+        uint16_t count[2] = {0, 0};
+        if (state->type==STATE_ACCEPT) continue;
+        for (uint16_t c = 0; c < 256; c++) {
+            Move_t* m = moveIndexFind(t->index, state, (uint8_t)c);
+            if (m==NULL) continue;
+            seen[m->read_symbol] = 1;
+            direction[m->read_symbol] = MOVE_WAIT;
+            if (m->new_state==state && m->write_symbol==m->read_symbol && m->head_move!=MOVE_WAIT) {
+                direction[m->read_symbol] = m->head_move;
+                count[m->head_move]++;
+            }
+        }
+        SweepState_t* s = &sweep->states[i];
+        s->direction = (count[MOVE_RIGHT]>=count[MOVE_LEFT]) ? MOVE_RIGHT : MOVE_LEFT;
+        // the tape string ends with zero, so it is never swept
+        for (uint16_t c = 1; c < 256; c++) {
+            if (seen[c] && direction[c]==s->direction) {
+                s->symbols[c] = 1;
+                s->span[s->size++] = (uint8_t)c;
+            }
+        }
+        s->span[s->size] = 0;
+        if (s->size) found = 1;
+    }
+    if (!found) {
+        sweepFree(sweep);
+        return NULL;
+    }
+    return sweep;
+}
+
+/// @brief Deallocates a Sweep_t object
+/// @param sweep Sweep_t object returned by sweepCreate, can be NULL
+void sweepFree(Sweep_t* sweep) {
+    if (sweep==NULL) return;
+    free(sweep->states);
+    free(sweep);
+}
+
+/// @brief Jumps the head of a DTM across the whole run of swept cells in one scan
+/// Every skipped cell counts as a step, the head stops on the first cell that is not swept
+/// or on a tape end, where the next step grows the tape as usual
+/// @param sweep    Sweeps of the machine automaton
+/// @param t        Running TM_t object
+/// @param tmlen    Tape Length
+/// @param limit    Maximum number of cells to skip, 0 for no limit
+/// @return         Number of skipped cells (steps), zero if the machine is not sweeping
+uint64_t sweepRun(Sweep_t* sweep, TM_t* t, uint8_t tmlen, uint64_t limit) {
+    SweepState_t* s = &sweep->states[t->current_state - t->states];
+    uint64_t cells;
+    if (!s->size || !s->symbols[t->tape[t->head]]) return 0;
+    if (s->direction==MOVE_RIGHT) {
+        // strspn scans the tape for the first byte outside the swept set (vectorized by the C library)
+        cells = strspn((char*)t->tape+t->head, (char*)s->span);
+        if (cells > (uint64_t)(tmlen-1-t->head)) cells = tmlen-1-t->head;
+    } else {
+        uint8_t h = t->head;
+        while (h>0 && s->symbols[t->tape[h]]) h--;
+        cells = t->head-h;
+    }
+    if (limit && cells>limit) cells = limit;
+    if (s->direction==MOVE_RIGHT) t->head += cells; else t->head -= cells;
+    t->steps += cells;
+    return cells;
+}
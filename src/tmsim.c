@@ -0,0 +1,413 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <tmsim.h>
+#include <rules.h>
+#include <interpreter.h>
+#include <alphabet.h>
+#include <multitape.h>
+#include <sweep.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+// steps of a running machine between two polls of the first accept flag
+#define TMSIM_CANCEL_POLL_STEPS 4096
+
+/// @brief Simulation Context, every run configuration and machine of a simulation
+struct TMSim {
+    /// @brief Loaded Script
+    Parser_t parser;
+    /// @brief Loaded Automaton
+    AutomataParser_t automata;
+    /// @brief 1 if an automaton is loaded
+    uint8_t loaded;
+    /// @brief Sweeps of a single tape automaton (NULL if it has none)
+    Sweep_t* sweep;
+    /// @brief Machines created from the automaton
+    TM_t* machines;
+    /// @brief Multi-Tape Machines (NULL for single tape automata), created from machines
+    MultiTM_t* multi;
+    /// @brief Tape Length of each single tape machine
+    uint8_t* tmlen;
+    /// @brief Number of machines
+    uint32_t machines_size;
+    /// @brief Machines arrays capacity
+    uint32_t machines_capacity;
+    /// @brief Maximum steps of each machine in a tmsimRun call, 0 for no limit
+    uint64_t step_limit;
+    /// @brief Number of threads used by tmsimRun (OpenMP builds only)
+    uint32_t threads;
+    /// @brief Stops running machines once any machine is in an Accept State
+    uint8_t first_accept;
+    /// @brief Set by the first accepted machine of a tmsimRun call, polled by the other ones
+    uint8_t cancel;
+    /// @brief Last Error Message
+    char error[512];
+};
+
+/// @brief Creates an empty simulation context
+/// @return TMSim_t* object, NULL if out of memory
+TMSim_t* tmsimCreate() {
+    TMSim_t* sim = calloc(1, sizeof(TMSim_t));
+    if (sim!=NULL) sim->threads = 1;
+    return sim;
+}
+
+/// @brief Grows the machines arrays of a context
+static int tmsimGrow(TMSim_t* sim, uint32_t capacity) {
+    if (capacity <= sim->machines_capacity) return TMSIM_OK;
+    TM_t* machines = realloc(sim->machines, capacity*sizeof(TM_t));
+    if (machines!=NULL) sim->machines = machines;
+    MultiTM_t* multi = realloc(sim->multi, capacity*sizeof(MultiTM_t));
+    if (multi!=NULL) sim->multi = multi;
+    uint8_t* tmlen = realloc(sim->tmlen, capacity*sizeof(uint8_t));
+    if (tmlen!=NULL) sim->tmlen = tmlen;
+    if (machines==NULL || multi==NULL || tmlen==NULL) {
+        snprintf(sim->error, sizeof(sim->error), "Out of memory.");
+        return TMSIM_ERROR_ARGUMENT;
+    }
+    sim->machines_capacity = capacity;
+    return TMSIM_OK;
+}
+
+/// @brief Preallocates room for a number of machines, so adding them does not reallocate
+/// @param sim      Simulation Context
+/// @param machines Number of machines
+/// @return         TMSIM_OK or a negative error code
+int tmsimReserve(TMSim_t* sim, uint32_t machines) {
+    return tmsimGrow(sim, machines);
+}
+
+/// @brief Deallocates every machine of a context, keeping its automaton
+/// @param sim Simulation Context
+void tmsimClearMachines(TMSim_t* sim) {
+    for (uint32_t i = 0; i < sim->machines_size; i++) {
+        if (sim->automata.tapes_number>1) freeMultiTM(&sim->multi[i]);
+        freeTM(&sim->machines[i]);
+    }
+    sim->machines_size = 0;
+}
+
+/// @brief Deallocates a context and everything it owns
+/// @param sim Simulation Context (may be NULL)
+void tmsimDestroy(TMSim_t* sim) {
+    if (sim==NULL) return;
+    tmsimClearMachines(sim);
+    if (sim->loaded) {
+        freeAutomata(&sim->automata);
+        freeParser(&sim->parser);
+    }
+    sweepFree(sim->sweep);
+    free(sim->machines);
+    free(sim->multi);
+    free(sim->tmlen);
+    free(sim);
+}
+
+/// @brief Parses a script and replaces the automaton of a context
+/// Interpreter errors jump back here instead of exiting the process
+/// (interpreterExit releases a partially parsed script, a parsed script with an invalid automaton is released here)
+static int tmsimLoad(TMSim_t* sim, FILE* file) {
+    jmp_buf recover;
+    // kept across longjmp
+    Parser_t* volatile p = malloc(sizeof(Parser_t));
+    volatile uint8_t parsed = 0;
+    AutomataParser_t a;
+    if (setjmp(recover)) {
+        interpreterRecover(NULL, NULL, 0);
+        if (parsed) freeParser(p);
+        free(p);
+        // single line message
+        for (char* c = sim->error; *c; c++) if (*c=='\n') *c = (c[1] ? ' ' : 0);
+        return TMSIM_ERROR_SCRIPT;
+    }
+    interpreterRecover(&recover, sim->error, sizeof(sim->error));
+    *p = parseStream(file);
+    parsed = 1;
+    a = parserToAutomata(*p);
+    interpreterRecover(NULL, NULL, 0);
+    tmsimClearMachines(sim);
+    if (sim->loaded) {
+        freeAutomata(&sim->automata);
+        freeParser(&sim->parser);
+    }
+    sim->parser = *p;
+    free(p);
+    sim->automata = a;
+    sim->loaded = 1;
+    sweepFree(sim->sweep);
+    sim->sweep = NULL;
+    if (a.tapes_number==1) {
+        // machines share the states and moves layout of the automaton
+        TM_t layout = DTM((uint8_t*)" ", 0, a);
+        sim->sweep = sweepCreate(&layout);
+        freeTM(&layout);
+    }
+    sim->error[0] = 0;
+    return TMSIM_OK;
+}
+
+/// @brief Loads an automaton from a script file, removing machines of a previous automaton
+/// @param sim      Simulation Context
+/// @param filename Script File Path in Disk
+/// @return         TMSIM_OK or TMSIM_ERROR_SCRIPT (see tmsimError)
+int tmsimLoadFile(TMSim_t* sim, const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (file==NULL) {
+        snprintf(sim->error, sizeof(sim->error), "Error opening file %s", filename);
+        return TMSIM_ERROR_SCRIPT;
+    }
+    int code = tmsimLoad(sim, file);
+    fclose(file);
+    return code;
+}
+
+/// @brief Loads an automaton from a script in memory, like tmsimLoadFile
+/// @param sim      Simulation Context
+/// @param script   Script Text
+/// @return         TMSIM_OK or TMSIM_ERROR_SCRIPT (see tmsimError)
+int tmsimLoadScript(TMSim_t* sim, const char* script) {
+    FILE* file = tmpfile();
+    if (file==NULL) {
+        snprintf(sim->error, sizeof(sim->error), "Error creating a temporary file.");
+        return TMSIM_ERROR_SCRIPT;
+    }
+    fputs(script, file);
+    rewind(file);
+    int code = tmsimLoad(sim, file);
+    fclose(file);
+    return code;
+}
+
+/// @brief Adds a machine of the loaded automaton from a tape of cell codes
+static int tmsimAddCells(TMSim_t* sim, const uint8_t* cells, uint32_t head) {
+    size_t length = strlen((const char*)cells);
+    if (length==0 || length>=UINT8_MAX || head>=length) {
+        snprintf(sim->error, sizeof(sim->error), "Tape must have between 1 and %u symbols and its head must be lesser than its length.", UINT8_MAX-1);
+        return TMSIM_ERROR_ARGUMENT;
+    }
+    if (sim->machines_size == sim->machines_capacity) {
+        int code = tmsimGrow(sim, sim->machines_capacity ? 2*sim->machines_capacity : 8);
+        if (code!=TMSIM_OK) return code;
+    }
+    uint32_t i = sim->machines_size++;
+    sim->machines[i] = DTM((uint8_t*)cells, head, sim->automata);
+    sim->tmlen[i] = length;
+    if (sim->automata.tapes_number>1) sim->multi[i] = multiTM(&sim->machines[i], sim->automata.tapes_number);
+    return i;
+}
+
+/// @brief Adds a machine of the loaded automaton
+/// Tapes are written like in the script: UTF-8 characters and [names] of scripts with symbols are
+/// converted to their cell codes, and the head counts symbols, not bytes
+/// @param sim  Simulation Context
+/// @param tape Input Tape (first tape of multi-tape machines, the others start blank)
+/// @param head 0-based Head Position
+/// @return     Machine index, or a negative error code
+int tmsimAddMachine(TMSim_t* sim, const char* tape, uint32_t head) {
+    if (!sim->loaded) {
+        snprintf(sim->error, sizeof(sim->error), "No automaton loaded.");
+        return TMSIM_ERROR_NO_AUTOMATON;
+    }
+    Alphabet_t* alphabet = sim->parser.alphabet;
+    if (alphabet==NULL) return tmsimAddCells(sim, (const uint8_t*)tape, head);
+    uint8_t* cells = malloc(strlen(tape)+1);
+    if (alphabetEncode(alphabet, (const uint8_t*)tape, cells)<0 || alphabetCollision(alphabet)) {
+        snprintf(sim->error, sizeof(sim->error), "Tape has an invalid UTF-8 character or too many symbols.");
+        free(cells);
+        return TMSIM_ERROR_ARGUMENT;
+    }
+    int code = tmsimAddCells(sim, cells, head);
+    free(cells);
+    return code;
+}
+
+/// @brief Adds a machine for every tape and head defined in the loaded script
+/// @param sim  Simulation Context
+/// @return     Number of machines added, or a negative error code
+int tmsimAddScriptMachines(TMSim_t* sim) {
+    jmp_buf recover;
+    HeadParser_t hp;
+    if (!sim->loaded) {
+        snprintf(sim->error, sizeof(sim->error), "No automaton loaded.");
+        return TMSIM_ERROR_NO_AUTOMATON;
+    }
+    // scripts without tape definitions
+    if (sim->parser.tapes==NULL) return 0;
+    if (setjmp(recover)) {
+        interpreterRecover(NULL, NULL, 0);
+        for (char* c = sim->error; *c; c++) if (*c=='\n') *c = (c[1] ? ' ' : 0);
+        return TMSIM_ERROR_SCRIPT;
+    }
+    interpreterRecover(&recover, sim->error, sizeof(sim->error));
+    hp = parserToHeadParser(sim->parser);
+    interpreterRecover(NULL, NULL, 0);
+    int code = tmsimGrow(sim, sim->machines_size+hp.size);
+    for (uint32_t i = 0; i < hp.size && code==TMSIM_OK; i++) {
+        // script tapes are already cell codes
+        int machine = tmsimAddCells(sim, hp.tapes[i], hp.heads[i]);
+        if (machine<0) code = machine;
+    }
+    uint32_t added = hp.size;
+    freeHeadParser(&hp);
+    return (code==TMSIM_OK) ? (int)added : code;
+}
+
+/// @brief Limits the steps of each machine in a tmsimRun call
+/// @param sim      Simulation Context
+/// @param steps    Maximum number of steps, 0 for no limit (default)
+void tmsimSetStepLimit(TMSim_t* sim, uint64_t steps) {
+    sim->step_limit = steps;
+}
+
+/// @brief Sets the number of threads used by tmsimRun, ignored if not built with OpenMP
+/// @param sim      Simulation Context
+/// @param threads  Number of threads (default 1)
+void tmsimSetThreads(TMSim_t* sim, uint32_t threads) {
+    sim->threads = threads ? threads : 1;
+}
+
+/// @brief Stops running machines once any machine is in an Accept State
+/// Running machines poll for an accept every TMSIM_CANCEL_POLL_STEPS steps; stopped and
+/// queued machines keep the TMSIM_RUNNING status and continue in the next tmsimRun call
+/// @param sim          Simulation Context
+/// @param first_accept 1 to enable, 0 to disable (default)
+void tmsimSetFirstAccept(TMSim_t* sim, uint8_t first_accept) {
+    sim->first_accept = first_accept;
+}
+
+/// @brief Reads the first accept flag of a tmsimRun call
+static uint8_t tmsimCancelled(TMSim_t* sim) {
+    uint8_t cancel;
+#ifdef OPENMP
+    #pragma omp atomic read
+#endif
+    cancel = sim->cancel;
+    return cancel;
+}
+
+/// @brief Runs a single machine of a context until it stops, accepts, reaches the step limit
+/// or another machine accepts in first accept mode
+static uint8_t tmsimRunMachine(TMSim_t* sim, uint32_t i) {
+    TM_t* t = &sim->machines[i];
+    uint64_t last = t->steps+sim->step_limit;
+    uint32_t cancel_countdown = TMSIM_CANCEL_POLL_STEPS;
+    if (sim->automata.tapes_number>1) {
+        MultiTM_t* m = &sim->multi[i];
+        last = m->steps+sim->step_limit;
+        while (m->status==STATUS_SGMOVE && (sim->step_limit==0 || m->steps<last)) {
+            if (sim->first_accept && --cancel_countdown==0) {
+                cancel_countdown = TMSIM_CANCEL_POLL_STEPS;
+                if (tmsimCancelled(sim)) break;
+            }
+            m->status = runStepMultiTM(m,NULL);
+            if (m->status==STATUS_SGMOVE) m->steps++;
+        }
+        return m->status;
+    }
+    while (t->status==STATUS_SGMOVE && (sim->step_limit==0 || t->steps<last)) {
+        if (sim->first_accept && --cancel_countdown==0) {
+            cancel_countdown = TMSIM_CANCEL_POLL_STEPS;
+            if (tmsimCancelled(sim)) break;
+        }
+        if (sim->sweep!=NULL && sweepRun(sim->sweep, t, sim->tmlen[i], sim->step_limit ? last-t->steps : 0)) continue;
+        t->status = runStepTM(&t->tape,&t->head,&sim->tmlen[i],t->states,&t->current_state,t->states_size,t->moves,t->moves_size,t->index,NULL);
+        if (t->status==STATUS_SGMOVE) t->steps++;
+    }
+    return t->status;
+}
+
+/// @brief Runs every machine of a context
+/// Machines that reached the step limit in a previous call continue from where they stopped
+/// @param sim  Simulation Context
+/// @return     Number of machines in an Accept State, or a negative error code
+int tmsimRun(TMSim_t* sim) {
+    if (!sim->loaded) {
+        snprintf(sim->error, sizeof(sim->error), "No automaton loaded.");
+        return TMSIM_ERROR_NO_AUTOMATON;
+    }
+    int accepted = 0;
+    sim->cancel = 0;
+#ifdef OPENMP
+    #pragma omp parallel for num_threads(sim->threads) schedule(dynamic) reduction(+:accepted)
+#endif
+    for (uint32_t i = 0; i < sim->machines_size; i++) {
+        if (sim->first_accept && tmsimCancelled(sim)) continue;
+        if (tmsimRunMachine(sim, i)==STATUS_ACCEPT) {
+            accepted++;
+#ifdef OPENMP
+            #pragma omp atomic write
+#endif
+            sim->cancel = 1;
+        }
+    }
+    return accepted;
+}
+
+/// @brief Number of machines of a context
+/// @param sim  Simulation Context
+/// @return     Number of machines
+uint32_t tmsimMachines(TMSim_t* sim) {
+    return sim->machines_size;
+}
+
+/// @brief Copies the result of a machine
+/// @param sim          Simulation Context
+/// @param machine      Machine index
+/// @param result       Output Result
+/// @param tape         Output Tape buffer (NUL-terminated, truncated to tape_size), may be NULL
+///                     UTF-8 characters and [names] are written like in the script
+/// @param tape_size    Output Tape buffer length
+/// @return             TMSIM_OK or TMSIM_ERROR_ARGUMENT
+int tmsimResult(TMSim_t* sim, uint32_t machine, TMSimResult_t* result, char* tape, size_t tape_size) {
+    if (machine >= sim->machines_size) {
+        snprintf(sim->error, sizeof(sim->error), "Machine %u does not exist.", machine);
+        return TMSIM_ERROR_ARGUMENT;
+    }
+    const uint8_t* cells;
+    if (sim->automata.tapes_number>1) {
+        MultiTM_t* m = &sim->multi[machine];
+        Tape_t* first = &m->tapes[0];
+        result->status = m->status;
+        result->steps = m->steps;
+        result->head = first->head-first->left;
+        result->tape_length = first->right-first->left;
+        cells = &first->cells[first->left];
+    } else {
+        TM_t* t = &sim->machines[machine];
+        result->status = t->status;
+        result->steps = t->steps;
+        result->head = t->head;
+        result->tape_length = sim->tmlen[machine];
+        cells = t->tape;
+    }
+    if (tape!=NULL && tape_size>0) {
+        Alphabet_t* alphabet = sim->parser.alphabet;
+        size_t length = 0;
+        // cells are written back with their UTF-8 characters and [names], never cut in the middle of one
+        for (uint32_t k = 0; k < result->tape_length; k++) {
+            const uint8_t* name = (alphabet!=NULL) ? alphabet->names[cells[k]] : NULL;
+            size_t name_length = (name!=NULL) ? strlen((const char*)name) : 1;
+            if (length+name_length > tape_size-1) break;
+            if (name!=NULL) memcpy(tape+length, name, name_length);
+            else tape[length] = cells[k];
+            length += name_length;
+        }
+        tape[length] = 0;
+    }
+    return TMSIM_OK;
+}
+
+/// @brief Message of the last error of a context
+/// @param sim  Simulation Context
+/// @return     Error Message, empty if there was no error
+const char* tmsimError(TMSim_t* sim) {
+    return sim->error;
+}
@@ -0,0 +1,321 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <trace.h>
+#include <io.h>
+
+/// @brief Writes an unsigned integer to a trace file as little endian bytes
+/// @param file     Output File
+/// @param value    Value to be written
+/// @param bytes    Number of bytes to be written (1, 2, 4 or 8)
+static void traceWriteUint(FILE* file, uint64_t value, uint8_t bytes) {
+    uint8_t buffer[8];
+    for (uint8_t i = 0; i < bytes; i++) buffer[i] = (uint8_t)(value >> (8*i));
+    fwrite(buffer, 1, bytes, file);
+}
+
+/// @brief Reads a little endian unsigned integer from a trace file
+/// @param file     Input File
+/// @param bytes    Number of bytes to be read (1, 2, 4 or 8)
+/// @param value    Output Value
+/// @return         1 if the value was read, 0 on end of file
+static uint8_t traceReadUint(FILE* file, uint8_t bytes, uint64_t* value) {
+    uint8_t buffer[8];
+    if (fread(buffer, 1, bytes, file)!=bytes) return 0;
+    *value = 0;
+    for (uint8_t i = 0; i < bytes; i++) *value |= ((uint64_t)buffer[i]) << (8*i);
+    return 1;
+}
+
+/// @brief Creates a trace file and writes its header with the automaton of a TM
+/// @param filename             Trace File Path in Disk
+/// @param t                    TM with the automaton to be traced (every traced TM shares it)
+/// @param keyframe_interval    Number of steps between full tape keyframes
+/// @return                     Trace_t* object, exits program if file cannot be created
+Trace_t* traceOpen(const char* filename, TM_t* t, uint32_t keyframe_interval) {
+    Trace_t* trace = malloc(sizeof(Trace_t));
+    trace->file = fopen(filename, "wb");
+    if (trace->file == NULL) {
+        fprintf(stderr, "Error creating trace file %s\n", filename);
+        exit(1);
+    }
+    // large stdio buffer, chunks are written in bursts
+    setvbuf(trace->file, NULL, _IOFBF, 1 << 16);
+    trace->keyframe_interval = keyframe_interval;
+    trace->id_bytes = (t->moves_size <= 256) ? 1 : (t->moves_size <= 65536) ? 2 : 4;
+
+    fwrite(TRACE_MAGIC, 1, 4, trace->file);
+    traceWriteUint(trace->file, TRACE_VERSION, 1);
+    traceWriteUint(trace->file, trace->id_bytes, 1);
+    traceWriteUint(trace->file, keyframe_interval, 4);
+    // automaton states
+    traceWriteUint(trace->file, t->states_size, 4);
+    for (uint32_t i = 0; i < t->states_size; i++) {
+        uint16_t name_length = strlen(t->states[i].name);
+        traceWriteUint(trace->file, t->states[i].type, 1);
+        traceWriteUint(trace->file, name_length, 2);
+        fwrite(t->states[i].name, 1, name_length, trace->file);
+    }
+    // automaton moves, states are referenced by their index
+    traceWriteUint(trace->file, t->moves_size, 4);
+    for (uint32_t i = 0; i < t->moves_size; i++) {
+        traceWriteUint(trace->file, t->moves[i].current_state - t->states, 4);
+        traceWriteUint(trace->file, t->moves[i].new_state - t->states, 4);
+        traceWriteUint(trace->file, t->moves[i].read_symbol, 1);
+        traceWriteUint(trace->file, t->moves[i].write_symbol, 1);
+        traceWriteUint(trace->file, t->moves[i].head_move, 1);
+    }
+    return trace;
+}
+
+/// @brief Flushes and closes a trace file
+/// @param trace Trace_t object to be closed, NULL is ignored
+void traceClose(Trace_t* trace) {
+    if (trace == NULL) return;
+    fclose(trace->file);
+    free(trace);
+}
+
+/// @brief Writes a full tape keyframe of a machine
+/// @param tb           Machine Trace Buffer
+/// @param step         Step Number of the keyframe
+/// @param state        Current State Pointer
+/// @param t            Traced TM
+/// @param tape_size    TM Tape Length
+static void traceKeyframe(TraceBuffer_t* tb, uint64_t step, State_t* state, TM_t* t, uint8_t tape_size) {
+    FILE* file = tb->trace->file;
+    traceWriteUint(file, TRACE_CHUNK_KEYFRAME, 1);
+    traceWriteUint(file, tb->machine, 4);
+    traceWriteUint(file, step, 8);
+    traceWriteUint(file, state - t->states, 4);
+    traceWriteUint(file, t->head, 4);
+    traceWriteUint(file, tape_size, 4);
+    fwrite(t->tape, 1, tape_size, file);
+}
+
+/// @brief Writes buffered transition ids of a machine as a steps chunk
+/// @param tb Machine Trace Buffer
+static void traceFlush(TraceBuffer_t* tb) {
+    if (tb->count == 0) return;
+    FILE* file = tb->trace->file;
+    traceWriteUint(file, TRACE_CHUNK_STEPS, 1);
+    traceWriteUint(file, tb->machine, 4);
+    traceWriteUint(file, tb->first_step, 8);
+    traceWriteUint(file, tb->count, 4);
+    fwrite(tb->ids, tb->trace->id_bytes, tb->count, file);
+    tb->first_step += tb->count;
+    tb->count = 0;
+}
+
+/// @brief Starts tracing a machine: allocates its buffer and writes a keyframe of its current step
+/// @param tb           Machine Trace Buffer to be initialized
+/// @param trace        Trace File, if NULL the buffer is left disabled
+/// @param machine      TM Number in the running list
+/// @param t            Traced TM (it may be resumed from a checkpoint)
+/// @param tape_size    TM Tape Length
+void traceBegin(TraceBuffer_t* tb, Trace_t* trace, uint32_t machine, TM_t* t, uint8_t tape_size) {
+    tb->trace = trace;
+    if (trace == NULL) return;
+    tb->machine = machine;
+    tb->first_step = t->steps;
+    tb->count = 0;
+    tb->ids = malloc(trace->keyframe_interval*trace->id_bytes);
+#ifdef OPENMP
+    #pragma omp critical (trace)
+#endif
+    traceKeyframe(tb, t->steps, t->current_state, t, tape_size);
+}
+
+/// @brief Writes the full transition ids buffer of a machine followed by a keyframe,
+/// called by traceStep every keyframe interval
+/// @param tb           Machine Trace Buffer
+/// @param step         Step Number after the last buffered move
+/// @param t            Traced TM
+/// @param tape_size    TM Tape Length
+void traceKeyframeStep(TraceBuffer_t* tb, uint64_t step, TM_t* t, uint8_t tape_size) {
+#ifdef OPENMP
+    #pragma omp critical (trace)
+#endif
+    {
+        traceFlush(tb);
+        traceKeyframe(tb, step, t->current_state, t, tape_size);
+    }
+}
+
+/// @brief Finishes tracing a machine: writes pending steps and its final status
+/// @param tb       Machine Trace Buffer
+/// @param steps    Total number of steps
+/// @param status   Final TM Status (1 accept, 2 stopped, 4 cancelled)
+void traceEnd(TraceBuffer_t* tb, uint64_t steps, uint8_t status) {
+    if (tb->trace == NULL) return;
+#ifdef OPENMP
+    #pragma omp critical (trace)
+#endif
+    {
+        traceFlush(tb);
+        traceWriteUint(tb->trace->file, TRACE_CHUNK_END, 1);
+        traceWriteUint(tb->trace->file, tb->machine, 4);
+        traceWriteUint(tb->trace->file, steps, 8);
+        traceWriteUint(tb->trace->file, status, 1);
+    }
+    free(tb->ids);
+}
+
+/// @brief Prints a replayed step: step number, state name and tape through io.c printers
+static void replayRender(uint64_t step, State_t* state, uint8_t* tape, uint8_t head, uint32_t machine) {
+    printf("Step %llu, State %s\n", (unsigned long long)step, state->name);
+    printTapeNum(tape, head, machine);
+}
+
+/// @brief Exits with a message about a malformed trace file
+static void replayCorrupted(const char* filename) {
+    fprintf(stderr, "Trace file %s is corrupted or truncated.\n", filename);
+    exit(1);
+}
+
+/// @brief `tmsim replay` subcommand: seeks a step in a trace file using its keyframes and renders the tape
+/// @param argc Arguments after "replay"
+/// @param argv Arguments after "replay", first one is the trace file
+/// @return     Program exit code
+int replayTrace(int argc, char *argv[]) {
+    uint32_t machine = 0;
+    uint64_t step = 0, count = 1;
+    uint8_t list = 0;
+    if (argc < 1) {
+        printf("Usage: tmsim replay <trace_file> [-m <machine>] [-s <step>] [-c <count>] [-l]\n");
+        return 1;
+    }
+    const char* filename = argv[0];
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--machine") == 0) && i+1 < argc) machine = strtoul(argv[++i], NULL, 10);
+        else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--step") == 0) && i+1 < argc) step = strtoull(argv[++i], NULL, 10);
+        else if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--count") == 0) && i+1 < argc) count = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--list") == 0) list = 1;
+        else {
+            printf("Unknown replay option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (count == 0) count = 1;
+
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file %s\n", filename);
+        return 1;
+    }
+    // header
+    char magic[4];
+    uint64_t version, id_bytes, interval;
+    if (fread(magic, 1, 4, file)!=4 || memcmp(magic, TRACE_MAGIC, 4)!=0) {
+        fprintf(stderr, "%s is not a trace file.\n", filename);
+        return 1;
+    }
+    if (!traceReadUint(file, 1, &version) || version!=TRACE_VERSION) replayCorrupted(filename);
+    if (!traceReadUint(file, 1, &id_bytes) || !traceReadUint(file, 4, &interval)) replayCorrupted(filename);
+    if (id_bytes != 1 && id_bytes != 2 && id_bytes != 4) replayCorrupted(filename);
+    // rebuilds automaton
+    uint64_t states_size, moves_size;
+    if (!traceReadUint(file, 4, &states_size)) replayCorrupted(filename);
+    State_t* states = malloc((states_size+1)*sizeof(State_t));
+    for (uint32_t i = 0; i < states_size; i++) {
+        uint64_t type, name_length;
+        if (!traceReadUint(file, 1, &type) || !traceReadUint(file, 2, &name_length)) replayCorrupted(filename);
+        states[i].type = type;
+        states[i].name = malloc(name_length+1);
+        if (fread(states[i].name, 1, name_length, file)!=name_length) replayCorrupted(filename);
+        states[i].name[name_length] = 0;
+    }
+    if (!traceReadUint(file, 4, &moves_size)) replayCorrupted(filename);
+    Move_t* moves = malloc((moves_size+1)*sizeof(Move_t));
+    for (uint32_t i = 0; i < moves_size; i++) {
+        uint64_t current_state, new_state, read_symbol, write_symbol, head_move;
+        if (!traceReadUint(file, 4, &current_state) || !traceReadUint(file, 4, &new_state) ||
+            !traceReadUint(file, 1, &read_symbol) || !traceReadUint(file, 1, &write_symbol) ||
+            !traceReadUint(file, 1, &head_move)) replayCorrupted(filename);
+        if (current_state >= states_size || new_state >= states_size) replayCorrupted(filename);
+        moves[i].current_state = &states[current_state];
+        moves[i].new_state = &states[new_state];
+        moves[i].read_symbol = read_symbol;
+        moves[i].write_symbol = write_symbol;
+        moves[i].head_move = head_move;
+    }
+
+    // first pass: only chunk headers are read, keyframe tapes and step ids are skipped
+    long keyframe_offset = -1;
+    uint64_t end_steps = 0, end_status = 0, kind, chunk_machine, chunk_step, chunk_size, chunk_status;
+    uint8_t ended = 0;
+    while (traceReadUint(file, 1, &kind)) {
+        long offset = ftell(file) - 1;
+        if (!traceReadUint(file, 4, &chunk_machine)) replayCorrupted(filename);
+        if (kind == TRACE_CHUNK_KEYFRAME) {
+            if (!traceReadUint(file, 8, &chunk_step)) replayCorrupted(filename);
+            fseek(file, 8, SEEK_CUR);
+            if (!traceReadUint(file, 4, &chunk_size)) replayCorrupted(filename);
+            fseek(file, chunk_size, SEEK_CUR);
+            if (chunk_machine == machine && chunk_step <= step) keyframe_offset = offset;
+        } else if (kind == TRACE_CHUNK_STEPS) {
+            fseek(file, 8, SEEK_CUR);
+            if (!traceReadUint(file, 4, &chunk_size)) replayCorrupted(filename);
+            fseek(file, chunk_size*id_bytes, SEEK_CUR);
+        } else if (kind == TRACE_CHUNK_END) {
+            if (!traceReadUint(file, 8, &chunk_step) || !traceReadUint(file, 1, &chunk_status)) replayCorrupted(filename);
+            if (list) printf("Turing Machine %llu: %llu steps, status %llu\n", (unsigned long long)chunk_machine, (unsigned long long)chunk_step, (unsigned long long)chunk_status);
+            if (chunk_machine == machine) {ended = 1; end_steps = chunk_step; end_status = chunk_status;}
+        } else replayCorrupted(filename);
+    }
+    if (list) {fclose(file); return 0;}
+    if (keyframe_offset < 0) {
+        printf("Turing Machine %u not found in trace file.\n", machine);
+        fclose(file);
+        return 1;
+    }
+    if (ended && step > end_steps) {
+        printf("Turing Machine %u has only %llu steps.\n", machine, (unsigned long long)end_steps);
+        fclose(file);
+        return 1;
+    }
+
+    // second pass: loads the closest keyframe and applies transition ids up to the requested steps
+    fseek(file, keyframe_offset + 5, SEEK_SET);
+    uint64_t current, state_index, head, tape_size;
+    if (!traceReadUint(file, 8, &current) || !traceReadUint(file, 4, &state_index) ||
+        !traceReadUint(file, 4, &head) || !traceReadUint(file, 4, &tape_size)) replayCorrupted(filename);
+    // DTM tapes have at most 255 cells
+    if (state_index >= states_size || tape_size == 0 || tape_size > UINT8_MAX || head >= tape_size) replayCorrupted(filename);
+    uint8_t tape_length = tape_size, tape_head = head;
+    uint8_t* tape = malloc(tape_size+1);
+    if (fread(tape, 1, tape_size, file)!=tape_size) replayCorrupted(filename);
+    tape[tape_size] = 0;
+    State_t* state = &states[state_index];
+    uint64_t last = step + count - 1;
+    if (current >= step) replayRender(current, state, tape, tape_head, machine);
+    while (current < last && traceReadUint(file, 1, &kind)) {
+        if (!traceReadUint(file, 4, &chunk_machine)) replayCorrupted(filename);
+        if (kind == TRACE_CHUNK_KEYFRAME) {
+            fseek(file, 16, SEEK_CUR);
+            if (!traceReadUint(file, 4, &chunk_size)) replayCorrupted(filename);
+            fseek(file, chunk_size, SEEK_CUR);
+        } else if (kind == TRACE_CHUNK_STEPS) {
+            fseek(file, 8, SEEK_CUR);
+            if (!traceReadUint(file, 4, &chunk_size)) replayCorrupted(filename);
+            if (chunk_machine != machine) {fseek(file, chunk_size*id_bytes, SEEK_CUR); continue;}
+            for (uint64_t i = 0; i < chunk_size && current < last; i++) {
+                uint64_t id;
+                if (!traceReadUint(file, id_bytes, &id) || id >= moves_size) replayCorrupted(filename);
+                applyMoveTM(&tape, &tape_head, &tape_length, &moves[id]);
+                state = moves[id].new_state;
+                current++;
+                if (current >= step) replayRender(current, state, tape, tape_head, machine);
+            }
+        } else if (kind == TRACE_CHUNK_END) {
+            fseek(file, 9, SEEK_CUR);
+        } else replayCorrupted(filename);
+    }
+    if (ended && current == end_steps) printTMStatusNum(end_status, machine);
+    fclose(file);
+    return 0;
+}
@@ -0,0 +1,108 @@
+// ======================================================================
+// Turing Machine Simulator
+// Chandler Klüser, 2024
+// ======================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <witness.h>
+#include <io.h>
+
+/// @brief Allocates a Witness Tree without branches, every branch starts at the initial configuration
+/// @return Witness_t*
+Witness_t* witnessCreate() {
+    Witness_t* w = malloc(sizeof(Witness_t));
+    w->nodes_capacity = 1024;
+    w->nodes = malloc(w->nodes_capacity*sizeof(WitnessNode_t));
+    w->nodes_size = 0;
+    w->free = WITNESS_NONE;
+    w->leaves = NULL;
+    w->leaves_size = 0;
+    return w;
+}
+
+/// @brief Frees a Witness Tree
+/// @param w Witness_t*, ignored if NULL
+void witnessFree(Witness_t* w) {
+    if (w==NULL) return;
+    free(w->nodes);
+    free(w->leaves);
+    free(w);
+}
+
+/// @brief Drops a reference to a node, reclaiming it and every ancestor left without references
+/// @param w    Witness_t*
+/// @param node Node Index, ignored if WITNESS_NONE
+static void witnessRelease(Witness_t* w, uint32_t node) {
+    while (node!=WITNESS_NONE && --w->nodes[node].refs==0) {
+        uint32_t parent = w->nodes[node].parent;
+        w->nodes[node].parent = w->free;
+        w->free = node;
+        node = parent;
+    }
+}
+
+/// @brief Records a move: branch goes to the configuration reached from the current configuration of branch from
+/// New branches are recorded before the branch they come from moves on
+/// @param w        Witness_t*
+/// @param branch   Branch Index that applies the move
+/// @param from     Branch Index of the configuration the move is applied to (branch itself or its parent)
+/// @param move     Move Index in the automaton moves array
+void witnessStep(Witness_t* w, uint32_t branch, uint32_t from, uint32_t move) {
+    uint32_t parent = (from<w->leaves_size) ? w->leaves[from] : WITNESS_NONE;
+    uint32_t node = w->free;
+    if (node!=WITNESS_NONE) w->free = w->nodes[node].parent;
+    else {
+        if (w->nodes_size==w->nodes_capacity) {
+            w->nodes_capacity *= 2;
+            w->nodes = realloc(w->nodes,w->nodes_capacity*sizeof(WitnessNode_t));
+        }
+        node = w->nodes_size++;
+    }
+    w->nodes[node].parent = parent;
+    w->nodes[node].refs = 1;
+    w->nodes[node].move = move;
+    if (parent!=WITNESS_NONE) w->nodes[parent].refs++;
+    if (branch>=w->leaves_size) {
+        w->leaves = realloc(w->leaves,(branch+1)*sizeof(uint32_t));
+        while (w->leaves_size<=branch) w->leaves[w->leaves_size++] = WITNESS_NONE;
+    }
+    witnessRelease(w,w->leaves[branch]);
+    w->leaves[branch] = node;
+}
+
+/// @brief Reclaims the moves of a stopped branch that no other branch shares
+/// @param w        Witness_t*
+/// @param branch   Branch Index
+void witnessStop(Witness_t* w, uint32_t branch) {
+    if (branch>=w->leaves_size) return;
+    witnessRelease(w,w->leaves[branch]);
+    w->leaves[branch] = WITNESS_NONE;
+}
+
+/// @brief Prints the path of a branch: replays its moves from the initial configuration printing every tape
+/// @param w                Witness_t*
+/// @param branch           Branch Index
+/// @param t                TM_t object with the initial tape, head and the automaton
+/// @param initial_state    Initial State Pointer
+void witnessPrint(Witness_t* w, uint32_t branch, TM_t* t, State_t* initial_state) {
+    uint32_t length = 0;
+    uint32_t node = (branch<w->leaves_size) ? w->leaves[branch] : WITNESS_NONE;
+    for (uint32_t k = node; k!=WITNESS_NONE; k = w->nodes[k].parent) length++;
+    uint32_t* path = malloc((length+1)*sizeof(uint32_t));
+    for (uint32_t k = node, p = length; k!=WITNESS_NONE; k = w->nodes[k].parent) path[--p] = w->nodes[k].move;
+    uint8_t tmlen = strlen((char*)t->tape), head = t->head;
+    uint8_t* tape = malloc(tmlen+1);
+    memcpy(tape,t->tape,tmlen+1);
+    printf("Accepting path of NDTM %u (%u moves):\n",branch,length);
+    printf("State %s\n",initial_state->name);
+    printTape(tape,head);
+    for (uint32_t k = 0; k<length; k++) {
+        Move_t* m = &t->moves[path[k]];
+        applyMoveTM(&tape,&head,&tmlen,m);
+        printf("Line %u, state %s\n",m->line_number,m->new_state->name);
+        printTape(tape,head);
+    }
+    free(tape);
+    free(path);
+}